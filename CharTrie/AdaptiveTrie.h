@@ -0,0 +1,1459 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <algorithm>
+#include <cstdint>
+
+#include "TrieData.h"
+#include "TrieSimd.h"
+
+namespace Trie
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Отображение символов ключа в ключи дочерних элементов адаптивных узлов
+    /*
+     * Для однобайтовых символов каждому символу сопоставляется его ранг
+     * в порядке KeyCharLess (равные символы получают один ранг), поэтому
+     * ключи сравниваются как целые числа и могут служить индексами массивов.
+     * Для остальных символов ключом служит сам символ, сравнение выполняется
+     * через KeyCharLess.
+     */
+    template<typename TCharType, typename KeyCharLess, bool bByteChar = (sizeof(TCharType) == 1)>
+    struct adaptive_key_traits;
+
+    template<typename TCharType, typename KeyCharLess>
+    struct adaptive_key_traits<TCharType, KeyCharLess, true>
+    {
+        using key_type = uint8_t;
+
+        // Ключи можно использовать как индексы массива из 256 элементов
+        static constexpr bool direct_index = true;
+
+        static key_type toKey(TCharType keyChar)
+        {
+            return getRanks()[static_cast<unsigned char>(keyChar)];
+        }
+
+        static bool less(key_type key1, key_type key2) { return key1 < key2; }
+        static bool eq  (key_type key1, key_type key2) { return key1 == key2; }
+
+        // Получить таблицу рангов символов
+        static const std::array<uint8_t, 256>& getRanks()
+        {
+            static const std::array<uint8_t, 256> ranks = intBuildRanks();
+            return ranks;
+        }
+
+    private:
+
+        static std::array<uint8_t, 256> intBuildRanks()
+        {
+            std::array<TCharType, 256> chars;
+            for (size_t charIndex = 0; charIndex < 256; ++charIndex)
+                chars[charIndex] = static_cast<TCharType>(charIndex);
+
+            std::stable_sort(chars.begin(), chars.end(),
+                [](TCharType ch1, TCharType ch2) { return is_key_less<KeyCharLess>(ch1, ch2); });
+
+            std::array<uint8_t, 256> ranks = {};
+
+            uint8_t rank = 0;
+            for (size_t charIndex = 0; charIndex < 256; ++charIndex)
+            {
+                if (charIndex > 0 && !is_key_eq<KeyCharLess>(chars[charIndex - 1], chars[charIndex]))
+                    ++rank;
+
+                ranks[static_cast<unsigned char>(chars[charIndex])] = rank;
+            }
+
+            return ranks;
+        }
+    };
+
+    template<typename TCharType, typename KeyCharLess>
+    struct adaptive_key_traits<TCharType, KeyCharLess, false>
+    {
+        using key_type = TCharType;
+
+        static constexpr bool direct_index = false;
+
+        static key_type toKey(TCharType keyChar) { return keyChar; }
+
+        static bool less(key_type key1, key_type key2) { return is_key_less<KeyCharLess>(key1, key2); }
+        static bool eq  (key_type key1, key_type key2) { return is_key_eq<KeyCharLess>(key1, key2); }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Адаптивный узел цифрового дерева (в стиле Adaptive Radix Tree)
+    /*
+     * Вид узла выбирается по количеству дочерних элементов:
+     *  Node4, Node16 - упорядоченные массивы ключей и указателей;
+     *  Node48        - индекс из 256 элементов и 48 указателей (однобайтовые символы);
+     *  Node256       - 256 указателей, ключ является индексом (однобайтовые символы);
+     *  NodeN         - упорядоченные массивы произвольного размера с двоичным
+     *                  поиском (многобайтовые символы).
+     * Узел растет и сжимается при добавлении и удалении дочерних элементов.
+     */
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    class AdaptiveNode
+    {
+    public:
+
+        using node_type  = AdaptiveNode<TCharType, TValueType, KeyCharLess>;
+        using key_traits = adaptive_key_traits<TCharType, KeyCharLess>;
+        using key_type   = typename key_traits::key_type;
+
+        // Вид узла
+        enum class Kind : uint8_t
+        {
+            Node4,
+            Node16,
+            Node48,
+            Node256,
+            NodeN,
+        };
+
+        // Создание узла (Node4) в указанном ресурсе памяти
+        static node_type*   create(std::pmr::memory_resource* resource, TCharType keyChar);
+
+        // Разрушение узла вместе со всеми дочерними элементами
+        static void         destroy(std::pmr::memory_resource* resource, node_type* node);
+
+        ///////////////////////////////////////////
+        // Работа с заголовком узла
+
+        Kind                getKind() const;
+        size_t              getChildrenCount() const;
+        TCharType           getKeyChar() const;
+
+        bool                haveValue() const;
+        void                setValue(TValueType value);
+        void                resetValue();
+        const TValueType&   getValue() const;
+
+        ///////////////////////////////////////////
+        // Работа с дочерними элементами
+
+        // Получить дочерний элемент по ключу
+        node_type*          findChild(key_type key) const;
+
+        // Получить место хранения указателя на дочерний элемент по ключу
+        node_type**         findChildSlot(key_type key);
+
+        // Получить первый дочерний элемент, позиция которого не меньше указанной
+        /**
+         * Позиции упорядочены так же, как ключи дочерних элементов.
+         * childPosition - позиция найденного элемента
+         */
+        node_type*          getChildFrom(size_t position, size_t& childPosition) const;
+
+        // Получить первый дочерний элемент с ключом, большим или равным указанному
+        node_type*          getChildEqOrGreat(key_type key, size_t& childPosition) const;
+
+        // Добавить дочерний элемент (при необходимости узел заменяется узлом большего вида)
+        static void         addChild(std::pmr::memory_resource* resource, node_type*& slot, key_type key, node_type* child);
+
+        // Удалить дочерний элемент (при необходимости узел заменяется узлом меньшего вида)
+        static void         removeChild(std::pmr::memory_resource* resource, node_type*& slot, key_type key);
+
+    protected:
+
+        AdaptiveNode(Kind kind, TCharType keyChar);
+
+        // Найти позицию первого ключа, не меньшего указанного, в упорядоченном массиве
+        static size_t       intLowerBound(const key_type* keys, size_t count, key_type key);
+
+        // Найти позицию первого ключа, не меньшего указанного, в массиве узла Node16
+        /*
+         * Однобайтовые ключи сравниваются векторными командами
+         */
+        static size_t       intLowerBound16(const key_type (&keys)[16], size_t count, key_type key);
+
+    private:
+
+        // Создать узел указанного вида
+        static node_type*   intCreate(std::pmr::memory_resource* resource, Kind kind, TCharType keyChar);
+
+        // Освободить узел (без дочерних элементов)
+        static void         intFree(std::pmr::memory_resource* resource, node_type* node);
+
+        // Заменить узел узлом другого вида с теми же дочерними элементами
+        static node_type*   intChangeKind(std::pmr::memory_resource* resource, node_type* node, Kind newKind);
+
+        // Вставить дочерний элемент в узел, в котором есть место
+        void                intInsertChild(key_type key, node_type* child);
+
+        // Получить ключ дочернего элемента по его позиции
+        key_type            intGetKeyAt(size_t position) const;
+
+    protected:
+
+        Kind                m_kind;
+        bool                m_bHaveValue     = false;
+        uint32_t            m_childrenCount  = 0;    // NodeN может содержать дочерний элемент для каждого символа
+        TCharType           m_keyChar;
+        TValueType          m_value          = TValueType();
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Узлы с упорядоченными массивами фиксированного размера
+    template<typename TCharType, typename TValueType, typename KeyCharLess, size_t Capacity>
+    struct AdaptiveNodeSorted : public AdaptiveNode<TCharType, TValueType, KeyCharLess>
+    {
+        using base_type = AdaptiveNode<TCharType, TValueType, KeyCharLess>;
+
+        AdaptiveNodeSorted(typename base_type::Kind kind, TCharType keyChar)
+            : base_type(kind, keyChar)
+        { }
+
+        typename base_type::key_type    m_keys[Capacity] = {};
+        base_type*                      m_children[Capacity] = {};
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Узел с индексом по ключу и 48 дочерними элементами
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    struct AdaptiveNode48 : public AdaptiveNode<TCharType, TValueType, KeyCharLess>
+    {
+        using base_type = AdaptiveNode<TCharType, TValueType, KeyCharLess>;
+
+        explicit AdaptiveNode48(TCharType keyChar)
+            : base_type(base_type::Kind::Node48, keyChar)
+        { }
+
+        uint8_t         m_index[256] = {};      // Номер дочернего элемента + 1 (0 - нет элемента)
+        base_type*      m_children[48] = {};
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Узел с 256 дочерними элементами
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    struct AdaptiveNode256 : public AdaptiveNode<TCharType, TValueType, KeyCharLess>
+    {
+        using base_type = AdaptiveNode<TCharType, TValueType, KeyCharLess>;
+
+        explicit AdaptiveNode256(TCharType keyChar)
+            : base_type(base_type::Kind::Node256, keyChar)
+        { }
+
+        base_type*      m_children[256] = {};
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Узел с упорядоченными массивами произвольного размера
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    struct AdaptiveNodeN : public AdaptiveNode<TCharType, TValueType, KeyCharLess>
+    {
+        using base_type = AdaptiveNode<TCharType, TValueType, KeyCharLess>;
+
+        AdaptiveNodeN(std::pmr::memory_resource* resource, TCharType keyChar)
+            : base_type(base_type::Kind::NodeN, keyChar),
+              m_keys     (resource),
+              m_children (resource)
+        { }
+
+        std::pmr::vector<typename base_type::key_type>  m_keys;
+        std::pmr::vector<base_type*>                    m_children;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Цифровое дерево с адаптивными узлами
+    /*
+     * Интерфейс и порядок обхода совпадают с Trie, но дочерние элементы узла
+     * хранятся не в цепочке братьев, а в адаптивном узле. Переход к дочернему
+     * элементу - индексация массива или просмотр короткого массива ключей
+     * вместо линейного прохода по цепочке братьев.
+     */
+    template<typename TCharType, typename TValueType, typename KeyCharLess = compare_no_case>
+    class AdaptiveTrie
+    {
+    public:
+
+        using this_type     = AdaptiveTrie<TCharType, TValueType, KeyCharLess>;
+        using string_type   = TrieStrings::StringOfChars<TCharType>;
+        using node_type     = AdaptiveNode<TCharType, TValueType, KeyCharLess>;
+        using key_traits    = typename node_type::key_traits;
+
+        class const_iterator;
+
+        using const_iterator_type = const_iterator;
+
+        AdaptiveTrie(NodesAllocation allocation = NodesAllocation::Heap);
+        explicit AdaptiveTrie(std::pmr::memory_resource* resource);
+
+        AdaptiveTrie(const AdaptiveTrie&) = delete;
+        AdaptiveTrie& operator=(const AdaptiveTrie&) = delete;
+        ~AdaptiveTrie();
+
+        // Добавление пары ключ/значение
+        /**
+         * Если ключ найден, то заменяем значение на новое.
+         * Если ключ не найден, то добавляется новая пара ключ/значение
+         *
+         * @param   key - ключ для добавляемого узла (не пустой)
+         * @param   value - значение для добавляемого узла
+         * @return  указатель на узел, соответствующий ключу
+         */
+        node_type*          addKeyValue(const string_type& key, TValueType value);
+
+        // Удаление заданного ключа (слова) из дерева
+        /**
+         * Удаляется ключ, значение (если есть) и все другие пары
+         * ключ/значение, у которых ключ начинается с указанного.
+         * Как и в Trie, узлы пути к удаленному ключу сохраняются.
+         *
+         * @param   key - ключ для удаляемого элемента
+         * @return  true - если элемент по ключу был найден и удален, false - иначе
+         */
+        bool                removeKey(const string_type& key);
+
+        // Поиск заданного ключа (слова) в дереве
+        /**
+         * @param   key - искомый ключ
+         * @return  итератор для найденого ключа, с которым связано значение.
+         *          Если не найдено, то будет возвращено cend()
+         */
+        const_iterator_type find(const string_type& key) const;
+
+        // Проверка наличия значения для заданного ключа (слова)
+        bool                contains(const string_type& key) const;
+
+        // Получение значения для заданного ключа (слова)
+        /**
+         * @return  указатель на значение, связанное с ключом.
+         *          Если значения нет, то будет возвращен nullptr
+         */
+        const TValueType*   get(const string_type& key) const;
+
+        // Поиск элемента, ключ которого больше или равен указанному
+        /**
+         * @param key - ключ
+         * @return итератор для элемента, ключ которого больше
+         *         или равен указанному ключу.
+         *         Если подходящих элементов не найдено, будет
+         *         возвращен итератор cend()
+         */
+        const_iterator_type lower_bound(const string_type& key) const;
+
+        const_iterator_type begin()  const;
+        const_iterator_type end()    const;
+        const_iterator_type cbegin() const;
+        const_iterator_type cend()   const;
+
+    private:
+
+        // Получить узел для ключа
+        const node_type*    intFindNode(const TCharType* key, size_t keyLength) const;
+
+        // Разрушение всех узлов дерева
+        void                intDestroyNodes();
+
+    private:
+
+        // Собственная арена дерева (при размещении узлов в арене)
+        std::unique_ptr<TrieArena>  m_ownArena;
+
+        // Ресурс памяти, в котором размещаются узлы дерева
+        std::pmr::memory_resource*  m_resource = nullptr;
+
+        // Корень цифрового дерева
+        node_type*                  m_rootNode = nullptr;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Итератор цифрового дерева с адаптивными узлами
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    class AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator
+    {
+        friend class AdaptiveTrie<TCharType, TValueType, KeyCharLess>;
+
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = const node_type*;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const node_type*;
+        using reference         = const node_type*;
+
+        using string_type       = TrieStrings::StringOfCharsZeroEnd<TCharType>;
+
+        const_iterator() noexcept;
+
+        bool                operator==  (const const_iterator& other) const;
+        bool                operator!=  (const const_iterator& other) const;
+        const node_type*    operator->  ()                            const;
+        const node_type*    operator*   ()                            const;
+
+        const_iterator&     operator++  ();
+
+        // Получение полного ключа, которому соответствует узел
+        const string_type&  getString() const;
+
+    private:
+
+        explicit const_iterator(const node_type* rootNode);
+
+        // Перейти к следующему узлу в порядке обхода
+        /*
+         * bToChild - признак захода в дочерние элементы текущего узла
+         */
+        void                intStep(bool bToChild);
+
+        // Перейти к ближайшему узлу со значением, начиная с текущего
+        void                intSeekValue();
+
+    private:
+
+        // Элемент пути: узел и его позиция среди дочерних элементов родителя
+        struct PathItem
+        {
+            const node_type*    pNode;
+            size_t              position;
+        };
+
+        const node_type*                m_rootNode = nullptr;
+        std::vector<PathItem>           m_path;     // Путь от корня к текущему узлу (без корня)
+        mutable string_type             m_string;   // Ключ, которому соответствует узел
+        mutable bool                    m_bStringActual = false;
+    };
+
+}   // namespace Trie
+
+// Имплементация методов адаптивного узла
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::AdaptiveNode(Kind kind, TCharType keyChar)
+        : m_kind    (kind),
+          m_keyChar (keyChar)
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename AdaptiveNode<TCharType, TValueType, KeyCharLess>::node_type*
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::create(std::pmr::memory_resource* resource, TCharType keyChar)
+    {
+        return intCreate(resource, Kind::Node4, keyChar);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::destroy(std::pmr::memory_resource* resource, node_type* node)
+    {
+        if (!node)
+            return;
+
+        std::vector<node_type*> stack(1, node);
+        while (!stack.empty())
+        {
+            node_type* currentNode = stack.back();
+            stack.pop_back();
+
+            size_t position = 0;
+            while (node_type* child = currentNode->getChildFrom(position, position))
+            {
+                stack.push_back(child);
+                ++position;
+            }
+
+            intFree(resource, currentNode);
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    typename AdaptiveNode<TCharType, TValueType, KeyCharLess>::Kind
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::getKind() const
+    {
+        return m_kind;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    size_t
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::getChildrenCount() const
+    {
+        return m_childrenCount;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    TCharType
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::getKeyChar() const
+    {
+        return m_keyChar;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    bool
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::haveValue() const
+    {
+        return m_bHaveValue;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::setValue(TValueType value)
+    {
+        m_value = std::move(value);
+        m_bHaveValue = true;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::resetValue()
+    {
+        m_value = TValueType();
+        m_bHaveValue = false;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    const TValueType&
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::getValue() const
+    {
+        return m_value;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    typename AdaptiveNode<TCharType, TValueType, KeyCharLess>::node_type*
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::findChild(key_type key) const
+    {
+        node_type** slot = const_cast<node_type*>(this)->findChildSlot(key);
+        return slot ? *slot : nullptr;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename AdaptiveNode<TCharType, TValueType, KeyCharLess>::node_type**
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::findChildSlot(key_type key)
+    {
+        using node4_type   = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 4>;
+        using node16_type  = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 16>;
+        using node48_type  = AdaptiveNode48<TCharType, TValueType, KeyCharLess>;
+        using node256_type = AdaptiveNode256<TCharType, TValueType, KeyCharLess>;
+        using nodeN_type   = AdaptiveNodeN<TCharType, TValueType, KeyCharLess>;
+
+        switch (m_kind)
+        {
+        case Kind::Node4:
+            {
+                node4_type* node = static_cast<node4_type*>(this);
+                for (size_t index = 0; index < m_childrenCount; ++index)
+                {
+                    if (key_traits::eq(node->m_keys[index], key))
+                        return &node->m_children[index];
+                }
+                return nullptr;
+            }
+
+        case Kind::Node16:
+            {
+                node16_type* node = static_cast<node16_type*>(this);
+                if constexpr (key_traits::direct_index)
+                {
+                    const size_t index = simd_find_key16(node->m_keys, m_childrenCount, key);
+                    return index < m_childrenCount ? &node->m_children[index] : nullptr;
+                }
+                else
+                {
+                    const size_t index = intLowerBound(node->m_keys, m_childrenCount, key);
+                    if (index < m_childrenCount && key_traits::eq(node->m_keys[index], key))
+                        return &node->m_children[index];
+                    return nullptr;
+                }
+            }
+
+        case Kind::Node48:
+            if constexpr (key_traits::direct_index)
+            {
+                node48_type* node = static_cast<node48_type*>(this);
+                const uint8_t slotIndex = node->m_index[key];
+                return slotIndex ? &node->m_children[slotIndex - 1] : nullptr;
+            }
+            break;
+
+        case Kind::Node256:
+            if constexpr (key_traits::direct_index)
+            {
+                node256_type* node = static_cast<node256_type*>(this);
+                return node->m_children[key] ? &node->m_children[key] : nullptr;
+            }
+            break;
+
+        case Kind::NodeN:
+            {
+                nodeN_type* node = static_cast<nodeN_type*>(this);
+                const size_t index = intLowerBound(node->m_keys.data(), m_childrenCount, key);
+                if (index < m_childrenCount && key_traits::eq(node->m_keys[index], key))
+                    return &node->m_children[index];
+                return nullptr;
+            }
+        }
+
+        return nullptr;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename AdaptiveNode<TCharType, TValueType, KeyCharLess>::node_type*
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::getChildFrom(size_t position, size_t& childPosition) const
+    {
+        using node4_type   = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 4>;
+        using node16_type  = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 16>;
+        using node48_type  = AdaptiveNode48<TCharType, TValueType, KeyCharLess>;
+        using node256_type = AdaptiveNode256<TCharType, TValueType, KeyCharLess>;
+        using nodeN_type   = AdaptiveNodeN<TCharType, TValueType, KeyCharLess>;
+
+        childPosition = position;
+
+        switch (m_kind)
+        {
+        case Kind::Node4:
+            return position < m_childrenCount ? static_cast<const node4_type*>(this)->m_children[position] : nullptr;
+
+        case Kind::Node16:
+            return position < m_childrenCount ? static_cast<const node16_type*>(this)->m_children[position] : nullptr;
+
+        case Kind::Node48:
+            {
+                const node48_type* node = static_cast<const node48_type*>(this);
+                for (; childPosition < 256; ++childPosition)
+                {
+                    if (const uint8_t slotIndex = node->m_index[childPosition])
+                        return node->m_children[slotIndex - 1];
+                }
+                return nullptr;
+            }
+
+        case Kind::Node256:
+            {
+                const node256_type* node = static_cast<const node256_type*>(this);
+                for (; childPosition < 256; ++childPosition)
+                {
+                    if (node->m_children[childPosition])
+                        return node->m_children[childPosition];
+                }
+                return nullptr;
+            }
+
+        case Kind::NodeN:
+            return position < m_childrenCount ? static_cast<const nodeN_type*>(this)->m_children[position] : nullptr;
+        }
+
+        return nullptr;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename AdaptiveNode<TCharType, TValueType, KeyCharLess>::node_type*
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::getChildEqOrGreat(key_type key, size_t& childPosition) const
+    {
+        using node4_type   = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 4>;
+        using node16_type  = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 16>;
+        using nodeN_type   = AdaptiveNodeN<TCharType, TValueType, KeyCharLess>;
+
+        switch (m_kind)
+        {
+        case Kind::Node4:
+            return getChildFrom(intLowerBound(static_cast<const node4_type*>(this)->m_keys, m_childrenCount, key), childPosition);
+
+        case Kind::Node16:
+            return getChildFrom(intLowerBound16(static_cast<const node16_type*>(this)->m_keys, m_childrenCount, key), childPosition);
+
+        case Kind::Node48:
+        case Kind::Node256:
+            // Позиция дочернего элемента совпадает с его ключом
+            return getChildFrom(static_cast<size_t>(key), childPosition);
+
+        case Kind::NodeN:
+            return getChildFrom(intLowerBound(static_cast<const nodeN_type*>(this)->m_keys.data(), m_childrenCount, key), childPosition);
+        }
+
+        return nullptr;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::addChild(
+        std::pmr::memory_resource* resource, node_type*& slot, key_type key, node_type* child)
+    {
+        node_type* node = slot;
+
+        // Если места нет - заменим узел узлом большего вида
+        switch (node->m_kind)
+        {
+        case Kind::Node4:
+            if (node->m_childrenCount == 4)
+                node = intChangeKind(resource, node, Kind::Node16);
+            break;
+
+        case Kind::Node16:
+            if (node->m_childrenCount == 16)
+                node = intChangeKind(resource, node, key_traits::direct_index ? Kind::Node48 : Kind::NodeN);
+            break;
+
+        case Kind::Node48:
+            if (node->m_childrenCount == 48)
+                node = intChangeKind(resource, node, Kind::Node256);
+            break;
+
+        case Kind::Node256:
+        case Kind::NodeN:
+            break;
+        }
+
+        node->intInsertChild(key, child);
+        slot = node;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::removeChild(
+        std::pmr::memory_resource* resource, node_type*& slot, key_type key)
+    {
+        using node4_type   = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 4>;
+        using node16_type  = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 16>;
+        using node48_type  = AdaptiveNode48<TCharType, TValueType, KeyCharLess>;
+        using node256_type = AdaptiveNode256<TCharType, TValueType, KeyCharLess>;
+        using nodeN_type   = AdaptiveNodeN<TCharType, TValueType, KeyCharLess>;
+
+        node_type* node = slot;
+
+        // Удаление из упорядоченных массивов со сдвигом хвоста
+        auto eraseSorted = [node, key](key_type* keys, node_type** children) -> bool
+        {
+            const size_t count = node->m_childrenCount;
+            const size_t index = intLowerBound(keys, count, key);
+            if (index == count || !key_traits::eq(keys[index], key))
+                return false;
+
+            std::move(keys + index + 1, keys + count, keys + index);
+            std::move(children + index + 1, children + count, children + index);
+
+            return true;
+        };
+
+        bool bRemoved = false;
+        Kind shrinkKind = node->m_kind;
+
+        switch (node->m_kind)
+        {
+        case Kind::Node4:
+            {
+                node4_type* node4 = static_cast<node4_type*>(node);
+                bRemoved = eraseSorted(node4->m_keys, node4->m_children);
+            }
+            break;
+
+        case Kind::Node16:
+            {
+                node16_type* node16 = static_cast<node16_type*>(node);
+                bRemoved = eraseSorted(node16->m_keys, node16->m_children);
+                if (node->m_childrenCount - 1 <= 3)
+                    shrinkKind = Kind::Node4;
+            }
+            break;
+
+        case Kind::Node48:
+            if constexpr (key_traits::direct_index)
+            {
+                node48_type* node48 = static_cast<node48_type*>(node);
+                if (const uint8_t slotIndex = node48->m_index[key])
+                {
+                    node48->m_children[slotIndex - 1] = nullptr;
+                    node48->m_index[key] = 0;
+                    bRemoved = true;
+                }
+                if (node->m_childrenCount - 1 <= 12)
+                    shrinkKind = Kind::Node16;
+            }
+            break;
+
+        case Kind::Node256:
+            if constexpr (key_traits::direct_index)
+            {
+                node256_type* node256 = static_cast<node256_type*>(node);
+                if (node256->m_children[key])
+                {
+                    node256->m_children[key] = nullptr;
+                    bRemoved = true;
+                }
+                if (node->m_childrenCount - 1 <= 36)
+                    shrinkKind = Kind::Node48;
+            }
+            break;
+
+        case Kind::NodeN:
+            {
+                nodeN_type* nodeN = static_cast<nodeN_type*>(node);
+                bRemoved = eraseSorted(nodeN->m_keys.data(), nodeN->m_children.data());
+                if (bRemoved)
+                {
+                    nodeN->m_keys.pop_back();
+                    nodeN->m_children.pop_back();
+                }
+                if (node->m_childrenCount - 1 <= 12)
+                    shrinkKind = Kind::Node16;
+            }
+            break;
+        }
+
+        if (!bRemoved)
+            return;
+
+        --node->m_childrenCount;
+
+        if (shrinkKind != node->m_kind)
+            slot = intChangeKind(resource, node, shrinkKind);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    size_t
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::intLowerBound(const key_type* keys, size_t count, key_type key)
+    {
+        // Короткие массивы просматриваются последовательно
+        if (count <= 16)
+        {
+            size_t index = 0;
+            while (index < count && key_traits::less(keys[index], key))
+                ++index;
+            return index;
+        }
+
+        return static_cast<size_t>(std::lower_bound(keys, keys + count, key,
+            [](key_type key1, key_type key2) { return key_traits::less(key1, key2); }) - keys);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    size_t
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::intLowerBound16(const key_type (&keys)[16], size_t count, key_type key)
+    {
+        if constexpr (key_traits::direct_index)
+            return simd_lower_bound_key16(keys, count, key);
+        else
+            return intLowerBound(keys, count, key);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename AdaptiveNode<TCharType, TValueType, KeyCharLess>::node_type*
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::intCreate(
+        std::pmr::memory_resource* resource, Kind kind, TCharType keyChar)
+    {
+        using node4_type   = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 4>;
+        using node16_type  = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 16>;
+        using node48_type  = AdaptiveNode48<TCharType, TValueType, KeyCharLess>;
+        using node256_type = AdaptiveNode256<TCharType, TValueType, KeyCharLess>;
+        using nodeN_type   = AdaptiveNodeN<TCharType, TValueType, KeyCharLess>;
+
+        switch (kind)
+        {
+        case Kind::Node4:
+            return new (resource->allocate(sizeof(node4_type), alignof(node4_type))) node4_type(kind, keyChar);
+
+        case Kind::Node16:
+            return new (resource->allocate(sizeof(node16_type), alignof(node16_type))) node16_type(kind, keyChar);
+
+        case Kind::Node48:
+            return new (resource->allocate(sizeof(node48_type), alignof(node48_type))) node48_type(keyChar);
+
+        case Kind::Node256:
+            return new (resource->allocate(sizeof(node256_type), alignof(node256_type))) node256_type(keyChar);
+
+        case Kind::NodeN:
+            return new (resource->allocate(sizeof(nodeN_type), alignof(nodeN_type))) nodeN_type(resource, keyChar);
+        }
+
+        return nullptr;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::intFree(std::pmr::memory_resource* resource, node_type* node)
+    {
+        using node4_type   = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 4>;
+        using node16_type  = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 16>;
+        using node48_type  = AdaptiveNode48<TCharType, TValueType, KeyCharLess>;
+        using node256_type = AdaptiveNode256<TCharType, TValueType, KeyCharLess>;
+        using nodeN_type   = AdaptiveNodeN<TCharType, TValueType, KeyCharLess>;
+
+        // Освобождает память узла конкретного вида
+        auto freeNode = [resource](auto* typedNode)
+        {
+            using typed_node_type = std::remove_pointer_t<decltype(typedNode)>;
+
+            typedNode->~typed_node_type();
+            resource->deallocate(typedNode, sizeof(typed_node_type), alignof(typed_node_type));
+        };
+
+        switch (node->m_kind)
+        {
+        case Kind::Node4:   freeNode(static_cast<node4_type*>(node));   break;
+        case Kind::Node16:  freeNode(static_cast<node16_type*>(node));  break;
+        case Kind::Node48:  freeNode(static_cast<node48_type*>(node));  break;
+        case Kind::Node256: freeNode(static_cast<node256_type*>(node)); break;
+        case Kind::NodeN:   freeNode(static_cast<nodeN_type*>(node));   break;
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename AdaptiveNode<TCharType, TValueType, KeyCharLess>::node_type*
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::intChangeKind(
+        std::pmr::memory_resource* resource, node_type* node, Kind newKind)
+    {
+        node_type* newNode = intCreate(resource, newKind, node->m_keyChar);
+        newNode->m_bHaveValue = node->m_bHaveValue;
+        newNode->m_value      = std::move(node->m_value);
+
+        // Дочерние элементы переносятся в порядке возрастания ключей
+        size_t position = 0;
+        while (node_type* child = node->getChildFrom(position, position))
+        {
+            newNode->intInsertChild(node->intGetKeyAt(position), child);
+            ++position;
+        }
+
+        intFree(resource, node);
+
+        return newNode;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::intInsertChild(key_type key, node_type* child)
+    {
+        using node4_type   = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 4>;
+        using node16_type  = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 16>;
+        using node48_type  = AdaptiveNode48<TCharType, TValueType, KeyCharLess>;
+        using node256_type = AdaptiveNode256<TCharType, TValueType, KeyCharLess>;
+        using nodeN_type   = AdaptiveNodeN<TCharType, TValueType, KeyCharLess>;
+
+        // Вставка в упорядоченные массивы со сдвигом хвоста
+        auto insertSorted = [this, key, child](key_type* keys, node_type** children)
+        {
+            const size_t count = m_childrenCount;
+            const size_t index = intLowerBound(keys, count, key);
+
+            std::move_backward(keys + index, keys + count, keys + count + 1);
+            std::move_backward(children + index, children + count, children + count + 1);
+
+            keys[index]     = key;
+            children[index] = child;
+        };
+
+        switch (m_kind)
+        {
+        case Kind::Node4:
+            {
+                node4_type* node = static_cast<node4_type*>(this);
+                insertSorted(node->m_keys, node->m_children);
+            }
+            break;
+
+        case Kind::Node16:
+            {
+                node16_type* node = static_cast<node16_type*>(this);
+                insertSorted(node->m_keys, node->m_children);
+            }
+            break;
+
+        case Kind::Node48:
+            if constexpr (key_traits::direct_index)
+            {
+                node48_type* node = static_cast<node48_type*>(this);
+
+                uint8_t slotIndex = 0;
+                while (node->m_children[slotIndex])
+                    ++slotIndex;
+
+                node->m_children[slotIndex] = child;
+                node->m_index[key] = static_cast<uint8_t>(slotIndex + 1);
+            }
+            break;
+
+        case Kind::Node256:
+            if constexpr (key_traits::direct_index)
+            {
+                static_cast<node256_type*>(this)->m_children[key] = child;
+            }
+            break;
+
+        case Kind::NodeN:
+            {
+                nodeN_type* node = static_cast<nodeN_type*>(this);
+                node->m_keys.push_back(key);
+                node->m_children.push_back(child);
+                insertSorted(node->m_keys.data(), node->m_children.data());
+            }
+            break;
+        }
+
+        ++m_childrenCount;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename AdaptiveNode<TCharType, TValueType, KeyCharLess>::key_type
+    AdaptiveNode<TCharType, TValueType, KeyCharLess>::intGetKeyAt(size_t position) const
+    {
+        using node4_type   = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 4>;
+        using node16_type  = AdaptiveNodeSorted<TCharType, TValueType, KeyCharLess, 16>;
+        using nodeN_type   = AdaptiveNodeN<TCharType, TValueType, KeyCharLess>;
+
+        switch (m_kind)
+        {
+        case Kind::Node4:   return static_cast<const node4_type*>(this)->m_keys[position];
+        case Kind::Node16:  return static_cast<const node16_type*>(this)->m_keys[position];
+        case Kind::NodeN:   return static_cast<const nodeN_type*>(this)->m_keys[position];
+
+        case Kind::Node48:
+        case Kind::Node256:
+            break;
+        }
+
+        // Позиция дочернего элемента совпадает с его ключом
+        return static_cast<key_type>(position);
+    }
+
+}   // namespace Trie (Имплементация методов адаптивного узла)
+
+// Имплементация методов дерева с адаптивными узлами
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::AdaptiveTrie(NodesAllocation allocation)
+    {
+        if (NodesAllocation::Arena == allocation)
+        {
+            m_ownArena.reset(new TrieArena());
+            m_resource = m_ownArena.get();
+        }
+        else
+        {
+            m_resource = std::pmr::new_delete_resource();
+        }
+
+        m_rootNode = node_type::create(m_resource, 0);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::AdaptiveTrie(std::pmr::memory_resource* resource)
+        : m_resource (resource ? resource : std::pmr::new_delete_resource())
+    {
+        m_rootNode = node_type::create(m_resource, 0);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::~AdaptiveTrie()
+    {
+        intDestroyNodes();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename AdaptiveTrie<TCharType, TValueType, KeyCharLess>::node_type*
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::addKeyValue(const string_type& key, TValueType value)
+    {
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        assert(keyLength > 0);
+        if (0 == keyLength)
+            return nullptr;
+
+        // Место хранения указателя на текущий узел
+        node_type** slot = &m_rootNode;
+
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            const typename key_traits::key_type childKey = key_traits::toKey(keyBuf[keyCharIndex]);
+
+            node_type** childSlot = (*slot)->findChildSlot(childKey);
+            if (!childSlot)
+            {
+                node_type* child = node_type::create(m_resource, keyBuf[keyCharIndex]);
+                node_type::addChild(m_resource, *slot, childKey, child);
+
+                childSlot = (*slot)->findChildSlot(childKey);
+            }
+
+            slot = childSlot;
+        }
+
+        (*slot)->setValue(std::move(value));
+
+        return *slot;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::removeKey(const string_type& key)
+    {
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        if (0 == keyLength)
+        {
+            // Разрушим старое дерево и создадим новое дерево
+            intDestroyNodes();
+            m_rootNode = node_type::create(m_resource, 0);
+            return true;
+        }
+
+        // Места хранения указателей на узлы пути (начиная с корня)
+        std::vector<node_type**> slots;
+        slots.reserve(keyLength + 1);
+        slots.push_back(&m_rootNode);
+
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            node_type** childSlot = (*slots.back())->findChildSlot(key_traits::toKey(keyBuf[keyCharIndex]));
+            if (!childSlot)
+                return false;
+
+            slots.push_back(childSlot);
+        }
+
+        // Удалим узел вместе с поддеревом (как и в Trie, узлы пути сохраняются)
+        node_type* node = *slots[keyLength];
+        node_type::removeChild(m_resource, *slots[keyLength - 1], key_traits::toKey(keyBuf[keyLength - 1]));
+        node_type::destroy(m_resource, node);
+
+        return true;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::find(const string_type& key) const
+    {
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        const_iterator_type it(m_rootNode);
+        if (0 == keyLength)
+            return cend();
+
+        const node_type* node = m_rootNode;
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            size_t position = 0;
+            const node_type* child = node->getChildEqOrGreat(key_traits::toKey(keyBuf[keyCharIndex]), position);
+            if (!child || !is_key_eq<KeyCharLess>(child->getKeyChar(), keyBuf[keyCharIndex]))
+                return cend();
+
+            it.m_path.push_back({ child, position });
+            node = child;
+        }
+
+        if (!node->haveValue())
+            return cend();
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::contains(const string_type& key) const
+    {
+        return nullptr != get(key);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const TValueType*
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::get(const string_type& key) const
+    {
+        const node_type* node = intFindNode(key.getStr(), key.length());
+
+        return node && node->haveValue() ? &node->getValue() : nullptr;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::lower_bound(const string_type& key) const
+    {
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        const_iterator_type it(m_rootNode);
+
+        const node_type* node = m_rootNode;
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            size_t position = 0;
+            const node_type* child = node->getChildEqOrGreat(key_traits::toKey(keyBuf[keyCharIndex]), position);
+            if (!child)
+            {
+                // Все ключи поддерева меньше искомого - переходим за поддерево
+                if (it.m_path.empty())
+                    return cend();
+
+                it.intStep(false);
+                it.intSeekValue();
+                return it;
+            }
+
+            it.m_path.push_back({ child, position });
+
+            // Символ не совпадает - первый ключ поддерева больше искомого
+            if (!is_key_eq<KeyCharLess>(child->getKeyChar(), keyBuf[keyCharIndex]))
+                break;
+
+            node = child;
+        }
+
+        if (it.m_path.empty())
+            return cbegin();
+
+        it.intSeekValue();
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::begin() const
+    {
+        return cbegin();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::end() const
+    {
+        return cend();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::cbegin() const
+    {
+        const_iterator_type it(m_rootNode);
+
+        size_t position = 0;
+        if (const node_type* firstChild = m_rootNode->getChildFrom(0, position))
+        {
+            it.m_path.push_back({ firstChild, position });
+            it.intSeekValue();
+        }
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::cend() const
+    {
+        return const_iterator_type();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename AdaptiveTrie<TCharType, TValueType, KeyCharLess>::node_type*
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::intFindNode(const TCharType* key, size_t keyLength) const
+    {
+        if (0 == keyLength)
+            return nullptr;
+
+        const node_type* node = m_rootNode;
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength && node; ++keyCharIndex)
+        {
+            node = node->findChild(key_traits::toKey(key[keyCharIndex]));
+        }
+
+        return node;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::intDestroyNodes()
+    {
+        if (m_ownArena && std::is_trivially_destructible<TValueType>::value)
+        {
+            m_ownArena->release();
+        }
+        else
+        {
+            node_type::destroy(m_resource, m_rootNode);
+
+            if (m_ownArena)
+                m_ownArena->release();
+        }
+
+        m_rootNode = nullptr;
+    }
+
+}   // namespace Trie (Имплементация методов дерева с адаптивными узлами)
+
+// Имплементация итератора дерева с адаптивными узлами
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator::const_iterator() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator::const_iterator(const node_type* rootNode)
+        : m_rootNode (rootNode)
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator==(
+        const const_iterator& other) const
+    {
+        if (m_path.empty() || other.m_path.empty())
+            return m_path.empty() && other.m_path.empty();
+
+        return m_path.back().pNode == other.m_path.back().pNode;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator!=(
+        const const_iterator& other) const
+    {
+        return !operator==(other);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename AdaptiveTrie<TCharType, TValueType, KeyCharLess>::node_type*
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator->() const
+    {
+        return m_path.back().pNode;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename AdaptiveTrie<TCharType, TValueType, KeyCharLess>::node_type*
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator*() const
+    {
+        return m_path.back().pNode;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator&
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator++()
+    {
+        if (!m_path.empty())
+        {
+            intStep(true);
+            intSeekValue();
+        }
+
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator::string_type&
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator::getString() const
+    {
+        if (!m_bStringActual)
+        {
+            m_string.clear();
+            m_string.reserve(m_path.size() + 1);
+
+            for (const PathItem& item : m_path)
+            {
+                m_string.appendChar(item.pNode->getKeyChar());
+            }
+
+            m_bStringActual = true;
+        }
+
+        return m_string;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator::intStep(bool bToChild)
+    {
+        m_bStringActual = false;
+
+        if (bToChild)
+        {
+            size_t position = 0;
+            if (const node_type* child = m_path.back().pNode->getChildFrom(0, position))
+            {
+                m_path.push_back({ child, position });
+                return;
+            }
+        }
+
+        // Переходим к следующему брату текущего узла или ближайшего из предков
+        while (!m_path.empty())
+        {
+            const size_t     nextPosition = m_path.back().position + 1;
+            const node_type* parentNode   = m_path.size() > 1 ? m_path[m_path.size() - 2].pNode : m_rootNode;
+
+            m_path.pop_back();
+
+            size_t position = 0;
+            if (const node_type* next = parentNode->getChildFrom(nextPosition, position))
+            {
+                m_path.push_back({ next, position });
+                break;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    AdaptiveTrie<TCharType, TValueType, KeyCharLess>::const_iterator::intSeekValue()
+    {
+        while (!m_path.empty() && !m_path.back().pNode->haveValue())
+        {
+            intStep(true);
+        }
+    }
+
+}   // namespace Trie (Имплементация итератора дерева с адаптивными узлами)
@@ -0,0 +1,795 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+#include "TrieData.h"
+
+namespace Trie
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Узел компактного цифрового дерева
+    /*
+     * Узлы хранятся в одном непрерывном массиве и ссылаются друг на друга
+     * 32-битными индексами. Значение хранится вне узла, узел содержит
+     * только индекс значения. Выравнивание отключено: для однобайтовых
+     * символов узел занимает 13 байт, для двухбайтовых - 14.
+     */
+#pragma pack(push, 1)
+    template<typename TCharType>
+    struct CompactNode
+    {
+        uint32_t    child;          // Индекс первого дочернего элемента
+        uint32_t    next;           // Индекс следующего брата (или следующего свободного узла)
+        uint32_t    valueIndex;     // Индекс значения
+        TCharType   keyChar;        // Символ ключа (приведенный key_char_traits::fold)
+    };
+#pragma pack(pop)
+
+    static_assert(sizeof(CompactNode<char>) < 16, "CompactNode<char> must be smaller than 16 bytes");
+    static_assert(sizeof(CompactNode<wchar_t>) <= 16, "CompactNode<wchar_t> must not exceed 16 bytes");
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Компактное цифровое дерево с узлами в непрерывном массиве
+    /*
+     * Структура, порядок обхода и семантика поиска совпадают с Trie, но
+     * узлы не имеют таблицы виртуальных функций и указателей: дочерние
+     * элементы и братья задаются индексами в массиве узлов, значения
+     * хранятся в отдельном массиве только для узлов, завершающих ключ.
+     * Освобожденные узлы и места значений используются повторно.
+     *
+     * Массивы перераспределяются при росте, поэтому ссылки на значения
+     * и итераторы действительны только до изменения дерева.
+     */
+    template<typename TCharType, typename TValueType, typename KeyCharLess = compare_no_case>
+    class CompactTrie
+    {
+    public:
+
+        using this_type     = CompactTrie<TCharType, TValueType, KeyCharLess>;
+        using string_type   = TrieStrings::StringOfChars<TCharType>;
+        using node_type     = CompactNode<TCharType>;
+
+        class node_view;
+        class const_iterator;
+
+        using const_iterator_type = const_iterator;
+
+        CompactTrie();
+
+        // Добавление пары ключ/значение
+        /**
+         * Если ключ найден, то заменяем значение на новое.
+         * Если ключ не найден, то добавляется новая пара ключ/значение
+         *
+         * @param   key - ключ (не пустой)
+         * @param   value - значение
+         * @return  true - если добавлен новый ключ, false - если значение ключа заменено
+         */
+        bool                addKeyValue(const string_type& key, TValueType value);
+
+        // Удаление заданного ключа (слова) из дерева
+        /**
+         * Удаляется ключ, значение (если есть) и все другие пары
+         * ключ/значение, у которых ключ начинается с указанного
+         *
+         * @param   key - ключ для удаляемого элемента
+         * @return  true - если элемент по ключу был найден и удален, false - иначе
+         */
+        bool                removeKey(const string_type& key);
+
+        // Поиск заданного ключа (слова) в дереве
+        /**
+         * @param   key - искомый ключ
+         * @return  итератор для найденого узла по ключу.
+         *          Если не найдено, то будет возвращено cend()
+         */
+        const_iterator_type find(const string_type& key) const;
+
+        // Проверка наличия значения для заданного ключа (слова)
+        bool                contains(const string_type& key) const;
+
+        // Получение значения для заданного ключа (слова)
+        /**
+         * @return  указатель на значение, связанное с ключом.
+         *          Если значения нет, то будет возвращен nullptr
+         */
+        const TValueType*   get(const string_type& key) const;
+
+        // Поиск элемента, ключ которого больше или равен указанному
+        /**
+         * @param key - ключ
+         * @return итератор для элемента, ключ которого больше
+         *         или равен указанному ключу.
+         *         Если подходящих элементов не найдено, будет
+         *         возвращен итератор cend()
+         */
+        const_iterator_type lower_bound(const string_type& key) const;
+
+        const_iterator_type begin()  const;
+        const_iterator_type end()    const;
+        const_iterator_type cbegin() const;
+        const_iterator_type cend()   const;
+
+        // Удалить все ключи
+        void                clear();
+
+        // Зарезервировать место для указанного количества узлов и значений
+        void                reserve(size_t nodesCount, size_t valuesCount);
+
+        // Получить количество узлов дерева (без корня)
+        size_t              getNodesCount() const;
+
+        // Получить объем памяти, занимаемый узлами и значениями (в байтах)
+        size_t              getMemorySize() const;
+
+    private:
+
+        using key_traits = key_char_traits<TCharType, KeyCharLess>;
+
+        // Признак отсутствия узла (корень не может быть дочерним элементом или братом)
+        static constexpr uint32_t no_node = 0;
+
+        // Признак отсутствия значения
+        static constexpr uint32_t no_value = UINT32_MAX;
+
+        // Индекс корня
+        static constexpr uint32_t root_node = 0;
+
+        // Найти дочерний элемент узла с указанным (приведенным) символом
+        /*
+         * prevNode - предыдущий брат найденного узла или узла, перед которым
+         * нужно вставить новый (no_node - если это первый дочерний элемент)
+         */
+        uint32_t            intFindChild(uint32_t parentNode, TCharType foldedChar, uint32_t& prevNode) const;
+
+        // Получить узел по ключу (no_node - если узла нет)
+        uint32_t            intFindNode(const TCharType* key, size_t keyLength) const;
+
+        // Создать узел (свободный узел используется повторно)
+        uint32_t            intCreateNode(TCharType foldedChar);
+
+        // Освободить узел вместе с его поддеревом (братья не затрагиваются)
+        void                intFreeSubtree(uint32_t node);
+
+        // Признак наличия значения в узле
+        bool                intHaveValue(uint32_t node) const;
+
+    private:
+
+        std::vector<node_type>  m_nodes;                // Узлы (m_nodes[root_node] - корень)
+        std::vector<TValueType> m_values;               // Значения узлов, завершающих ключи
+        std::vector<uint32_t>   m_freeValues;           // Освобожденные места значений
+        uint32_t                m_freeNode = no_node;   // Первый освобожденный узел (цепочка по next)
+        size_t                  m_freeNodesCount = 0;   // Количество освобожденных узлов
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Представление узла компактного дерева
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    class CompactTrie<TCharType, TValueType, KeyCharLess>::node_view
+    {
+    public:
+
+        node_view(const this_type* trie = nullptr, uint32_t node = no_node) noexcept
+            : m_trie(trie), m_node(node)
+        { }
+
+        TCharType           getKeyChar() const  { return m_trie->m_nodes[m_node].keyChar; }
+        bool                haveValue()  const  { return m_trie->intHaveValue(m_node); }
+        const TValueType&   getValue()   const  { return m_trie->m_values[m_trie->m_nodes[m_node].valueIndex]; }
+
+    private:
+
+        const this_type*    m_trie;
+        uint32_t            m_node;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Итератор компактного дерева
+    /*
+     * Обход выполняется в том же порядке, что и для Trie: в порядке возрастания ключей
+     */
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    class CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator
+    {
+        friend class CompactTrie<TCharType, TValueType, KeyCharLess>;
+
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = node_view;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const node_view*;
+        using reference         = const node_view&;
+
+        using string_type       = TrieStrings::StringOfCharsZeroEnd<TCharType>;
+
+        const_iterator() noexcept;
+
+        bool                operator==  (const const_iterator& other) const;
+        bool                operator!=  (const const_iterator& other) const;
+        const node_view*    operator->  ()                            const;
+        const node_view&    operator*   ()                            const;
+
+        const_iterator&     operator++  ();
+
+        // Получение полного ключа, которому соответствует узел
+        const string_type&  getString() const;
+
+    private:
+
+        explicit const_iterator(const this_type* trie);
+
+        // Перейти к следующему узлу в порядке обхода
+        /*
+         * bToChild - признак захода в дочерние элементы текущего узла
+         */
+        void                intStep(bool bToChild);
+
+        // Перейти к ближайшему узлу со значением, начиная с текущего
+        void                intSeekValue();
+
+        // Обновить представление текущего узла
+        void                intUpdateView();
+
+    private:
+
+        const this_type*        m_trie = nullptr;
+        std::vector<uint32_t>   m_path;             // Путь от корня к текущему узлу (без корня)
+        node_view               m_view;             // Представление текущего узла
+        mutable string_type     m_string;           // Ключ, которому соответствует узел
+        mutable bool            m_bStringActual = false;
+    };
+
+}   // namespace Trie
+
+// Имплементация методов компактного дерева
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    CompactTrie<TCharType, TValueType, KeyCharLess>::CompactTrie()
+    {
+        m_nodes.push_back(node_type{ no_node, no_node, no_value, TCharType() });
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    CompactTrie<TCharType, TValueType, KeyCharLess>::addKeyValue(const string_type& key, TValueType value)
+    {
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        assert(keyLength > 0);
+        if (0 == keyLength)
+            return false;
+
+        // Узлы создаются по индексам - ссылки на элементы массива недействительны после роста
+        uint32_t parentNode = root_node;
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            const TCharType foldedChar = key_traits::fold(keyBuf[keyCharIndex]);
+
+            uint32_t prevNode = no_node;
+            uint32_t node = intFindChild(parentNode, foldedChar, prevNode);
+            if (no_node == node)
+            {
+                node = intCreateNode(foldedChar);
+                if (no_node != prevNode)
+                {
+                    m_nodes[node].next = m_nodes[prevNode].next;
+                    m_nodes[prevNode].next = node;
+                }
+                else
+                {
+                    m_nodes[node].next = m_nodes[parentNode].child;
+                    m_nodes[parentNode].child = node;
+                }
+            }
+
+            parentNode = node;
+        }
+
+        if (intHaveValue(parentNode))
+        {
+            m_values[m_nodes[parentNode].valueIndex] = std::move(value);
+            return false;
+        }
+
+        uint32_t valueIndex = 0;
+        if (!m_freeValues.empty())
+        {
+            valueIndex = m_freeValues.back();
+            m_freeValues.pop_back();
+            m_values[valueIndex] = std::move(value);
+        }
+        else
+        {
+            if (m_values.size() >= no_value)
+                throw std::length_error("CompactTrie: too many values");
+
+            valueIndex = static_cast<uint32_t>(m_values.size());
+            m_values.push_back(std::move(value));
+        }
+
+        m_nodes[parentNode].valueIndex = valueIndex;
+        return true;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    CompactTrie<TCharType, TValueType, KeyCharLess>::removeKey(const string_type& key)
+    {
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        if (0 == keyLength)
+        {
+            clear();
+            return true;
+        }
+
+        // Определим родитель узла для удаления
+        uint32_t parentNode = root_node;
+        for (size_t keyCharIndex = 0; keyCharIndex + 1 < keyLength; ++keyCharIndex)
+        {
+            uint32_t prevNode = no_node;
+            parentNode = intFindChild(parentNode, key_traits::fold(keyBuf[keyCharIndex]), prevNode);
+            if (no_node == parentNode)
+                return false;
+        }
+
+        // Исключим узел из цепочки дочерних элементов родителя и освободим его поддерево
+        uint32_t prevNode = no_node;
+        const uint32_t nodeToRemove = intFindChild(parentNode, key_traits::fold(keyBuf[keyLength - 1]), prevNode);
+        if (no_node == nodeToRemove)
+            return false;
+
+        if (no_node != prevNode)
+            m_nodes[prevNode].next = m_nodes[nodeToRemove].next;
+        else
+            m_nodes[parentNode].child = m_nodes[nodeToRemove].next;
+
+        intFreeSubtree(nodeToRemove);
+        return true;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    CompactTrie<TCharType, TValueType, KeyCharLess>::find(const string_type& key) const
+    {
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        const_iterator_type it(this);
+        if (0 == keyLength)
+            return cend();
+
+        uint32_t parentNode = root_node;
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            uint32_t prevNode = no_node;
+            parentNode = intFindChild(parentNode, key_traits::fold(keyBuf[keyCharIndex]), prevNode);
+            if (no_node == parentNode)
+                return cend();
+
+            it.m_path.push_back(parentNode);
+        }
+
+        it.intUpdateView();
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    CompactTrie<TCharType, TValueType, KeyCharLess>::contains(const string_type& key) const
+    {
+        return nullptr != get(key);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const TValueType*
+    CompactTrie<TCharType, TValueType, KeyCharLess>::get(const string_type& key) const
+    {
+        const uint32_t node = intFindNode(key.getStr(), key.length());
+
+        return no_node != node && intHaveValue(node) ? &m_values[m_nodes[node].valueIndex] : nullptr;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    CompactTrie<TCharType, TValueType, KeyCharLess>::lower_bound(const string_type& key) const
+    {
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        const_iterator_type it(this);
+
+        uint32_t parentNode = root_node;
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            const TCharType foldedChar = key_traits::fold(keyBuf[keyCharIndex]);
+
+            // Найдем первый дочерний элемент с символом, большим или равным символу ключа
+            uint32_t node = m_nodes[parentNode].child;
+            while (no_node != node && key_traits::less(m_nodes[node].keyChar, foldedChar))
+                node = m_nodes[node].next;
+
+            if (no_node == node)
+            {
+                // Все ключи поддерева меньше искомого - переходим за поддерево
+                if (it.m_path.empty())
+                    return cend();
+
+                it.intUpdateView();
+                it.intStep(false);
+                it.intSeekValue();
+                return it;
+            }
+
+            it.m_path.push_back(node);
+
+            // Символ не совпадает - первый ключ поддерева больше искомого
+            if (!key_traits::eq(m_nodes[node].keyChar, foldedChar))
+                break;
+
+            parentNode = node;
+        }
+
+        if (it.m_path.empty())
+        {
+            // Пустой ключ - первый элемент
+            return cbegin();
+        }
+
+        it.intUpdateView();
+        it.intSeekValue();
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    CompactTrie<TCharType, TValueType, KeyCharLess>::begin() const
+    {
+        return cbegin();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    CompactTrie<TCharType, TValueType, KeyCharLess>::end() const
+    {
+        return cend();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    CompactTrie<TCharType, TValueType, KeyCharLess>::cbegin() const
+    {
+        const_iterator_type it(this);
+
+        const uint32_t firstChild = m_nodes[root_node].child;
+        if (no_node != firstChild)
+        {
+            it.m_path.push_back(firstChild);
+            it.intUpdateView();
+            it.intSeekValue();
+        }
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    CompactTrie<TCharType, TValueType, KeyCharLess>::cend() const
+    {
+        return const_iterator_type(this);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    CompactTrie<TCharType, TValueType, KeyCharLess>::clear()
+    {
+        m_nodes.resize(1);
+        m_nodes[root_node].child = no_node;
+
+        m_values.clear();
+        m_freeValues.clear();
+        m_freeNode       = no_node;
+        m_freeNodesCount = 0;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    CompactTrie<TCharType, TValueType, KeyCharLess>::reserve(size_t nodesCount, size_t valuesCount)
+    {
+        m_nodes.reserve(nodesCount + 1);
+        m_values.reserve(valuesCount);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    size_t
+    CompactTrie<TCharType, TValueType, KeyCharLess>::getNodesCount() const
+    {
+        return m_nodes.size() - 1 - m_freeNodesCount;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    size_t
+    CompactTrie<TCharType, TValueType, KeyCharLess>::getMemorySize() const
+    {
+        return m_nodes.capacity() * sizeof(node_type)
+            + m_values.capacity() * sizeof(TValueType)
+            + m_freeValues.capacity() * sizeof(uint32_t);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    uint32_t
+    CompactTrie<TCharType, TValueType, KeyCharLess>::intFindChild(
+        uint32_t parentNode, TCharType foldedChar, uint32_t& prevNode) const
+    {
+        prevNode = no_node;
+
+        uint32_t node = m_nodes[parentNode].child;
+        while (no_node != node && key_traits::less(m_nodes[node].keyChar, foldedChar))
+        {
+            prevNode = node;
+            node = m_nodes[node].next;
+        }
+
+        if (no_node != node && key_traits::eq(m_nodes[node].keyChar, foldedChar))
+            return node;
+
+        return no_node;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    uint32_t
+    CompactTrie<TCharType, TValueType, KeyCharLess>::intFindNode(const TCharType* key, size_t keyLength) const
+    {
+        if (0 == keyLength)
+            return no_node;
+
+        // Индекс корня совпадает с признаком отсутствия узла - проверяется каждый найденный узел
+        uint32_t node = root_node;
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            uint32_t prevNode = no_node;
+            node = intFindChild(node, key_traits::fold(key[keyCharIndex]), prevNode);
+            if (no_node == node)
+                break;
+        }
+
+        return node;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    uint32_t
+    CompactTrie<TCharType, TValueType, KeyCharLess>::intCreateNode(TCharType foldedChar)
+    {
+        uint32_t node = m_freeNode;
+        if (no_node != node)
+        {
+            m_freeNode = m_nodes[node].next;
+            --m_freeNodesCount;
+        }
+        else
+        {
+            if (m_nodes.size() > UINT32_MAX - 1)
+                throw std::length_error("CompactTrie: too many nodes");
+
+            node = static_cast<uint32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+
+        m_nodes[node] = node_type{ no_node, no_node, no_value, foldedChar };
+        return node;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    CompactTrie<TCharType, TValueType, KeyCharLess>::intFreeSubtree(uint32_t node)
+    {
+        // Узел и все его потомки переносятся в цепочку свободных узлов, значения освобождаются
+        std::vector<uint32_t> stack;
+        stack.push_back(node);
+
+        while (!stack.empty())
+        {
+            const uint32_t freeNode = stack.back();
+            stack.pop_back();
+
+            // Братья дочерних элементов добавляются в стек по цепочке next до ее изменения
+            for (uint32_t child = m_nodes[freeNode].child; no_node != child; child = m_nodes[child].next)
+                stack.push_back(child);
+
+            if (intHaveValue(freeNode))
+            {
+                // Ресурсы значения освобождаются сразу, место используется повторно
+                const uint32_t valueIndex = m_nodes[freeNode].valueIndex;
+                m_values[valueIndex] = TValueType();
+                m_freeValues.push_back(valueIndex);
+            }
+
+            m_nodes[freeNode] = node_type{ no_node, m_freeNode, no_value, TCharType() };
+            m_freeNode = freeNode;
+            ++m_freeNodesCount;
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    bool
+    CompactTrie<TCharType, TValueType, KeyCharLess>::intHaveValue(uint32_t node) const
+    {
+        return m_nodes[node].valueIndex != no_value;
+    }
+
+}   // namespace Trie (Имплементация методов компактного дерева)
+
+// Имплементация итератора компактного дерева
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator::const_iterator() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator::const_iterator(const this_type* trie)
+        : m_trie (trie)
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator==(
+        const const_iterator& other) const
+    {
+        if (m_path.empty() || other.m_path.empty())
+            return m_path.empty() && other.m_path.empty();
+
+        // Индекс узла однозначно определяет путь к нему
+        return m_trie == other.m_trie && m_path.back() == other.m_path.back();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator!=(
+        const const_iterator& other) const
+    {
+        return !operator==(other);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename CompactTrie<TCharType, TValueType, KeyCharLess>::node_view*
+    CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator->() const
+    {
+        return &m_view;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename CompactTrie<TCharType, TValueType, KeyCharLess>::node_view&
+    CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator*() const
+    {
+        return m_view;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator&
+    CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator++()
+    {
+        if (!m_path.empty())
+        {
+            intStep(true);
+            intSeekValue();
+        }
+
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator::string_type&
+    CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator::getString() const
+    {
+        if (!m_bStringActual)
+        {
+            m_string.clear();
+            m_string.reserve(m_path.size() + 1);
+
+            for (uint32_t node : m_path)
+            {
+                m_string.appendChar(m_trie->m_nodes[node].keyChar);
+            }
+
+            m_bStringActual = true;
+        }
+
+        return m_string;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator::intStep(bool bToChild)
+    {
+        if (bToChild)
+        {
+            const uint32_t child = m_trie->m_nodes[m_path.back()].child;
+            if (no_node != child)
+            {
+                m_path.push_back(child);
+                intUpdateView();
+                return;
+            }
+        }
+
+        // Переходим к следующему брату текущего узла или ближайшего из предков
+        while (!m_path.empty())
+        {
+            const uint32_t next = m_trie->m_nodes[m_path.back()].next;
+            m_path.pop_back();
+
+            if (no_node != next)
+            {
+                m_path.push_back(next);
+                break;
+            }
+        }
+
+        intUpdateView();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator::intSeekValue()
+    {
+        while (!m_path.empty() && !m_trie->intHaveValue(m_path.back()))
+        {
+            intStep(true);
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    CompactTrie<TCharType, TValueType, KeyCharLess>::const_iterator::intUpdateView()
+    {
+        m_view = m_path.empty() ? node_view() : node_view(m_trie, m_path.back());
+        m_bStringActual = false;
+    }
+
+}   // namespace Trie (Имплементация итератора компактного дерева)
@@ -0,0 +1,867 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include "TrieData.h"
+
+namespace Trie
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Цифровое дерево в виде двойного массива (base/check)
+    /*
+     * Неизменяемое представление дерева Trie для словарей, которые строятся
+     * один раз и затем только читаются.
+     * Символы ключей отображаются в коды алфавита с учетом KeyCharLess
+     * (символы, равные с точки зрения KeyCharLess, получают один код),
+     * переход к дочернему элементу выполняется одной индексацией массива:
+     *      child = base[state] + code, если check[child] == state
+     * Порядок обхода и семантика поиска совпадают с Trie.
+     */
+    template<typename TCharType, typename TValueType, typename KeyCharLess = compare_no_case>
+    class DoubleArrayTrie
+    {
+    public:
+
+        using this_type     = DoubleArrayTrie<TCharType, TValueType, KeyCharLess>;
+        using string_type   = TrieStrings::StringOfChars<TCharType>;
+        using trie_type     = Trie<TCharType, TValueType, KeyCharLess>;
+        using node_type     = typename trie_type::node_type;
+
+        class node_view;
+        class const_iterator;
+
+        using const_iterator_type = const_iterator;
+
+        DoubleArrayTrie() noexcept;
+        explicit DoubleArrayTrie(const trie_type& trie);
+
+        // Построение двойного массива по заполненному дереву
+        /**
+         * Предыдущее содержимое удаляется.
+         *
+         * @param trie - исходное дерево
+         */
+        void                build(const trie_type& trie);
+
+        // Поиск заданного ключа (слова)
+        /**
+         * @param   key - искомый ключ
+         * @return  итератор для найденого узла по ключу.
+         *          Если не найдено, то будет возвращено cend()
+         */
+        const_iterator_type find(const string_type& key) const;
+
+        // Проверка наличия значения для заданного ключа (слова)
+        bool                contains(const string_type& key) const;
+
+        // Получение значения для заданного ключа (слова)
+        /**
+         * @return  указатель на значение, связанное с ключом.
+         *          Если значения нет, то будет возвращен nullptr
+         */
+        const TValueType*   get(const string_type& key) const;
+
+        // Поиск элемента, ключ которого больше или равен указанному
+        /**
+         * @param key - ключ
+         * @return итератор для элемента, ключ которого больше
+         *         или равен указанному ключу.
+         *         Если подходящих элементов не найдено, будет
+         *         возвращен итератор cend()
+         */
+        const_iterator_type lower_bound(const string_type& key) const;
+
+        const_iterator_type begin()  const;
+        const_iterator_type end()    const;
+        const_iterator_type cbegin() const;
+        const_iterator_type cend()   const;
+
+        // Получить количество состояний (размер массивов base/check)
+        size_t              getStatesCount() const;
+
+        // Получить количество символов алфавита
+        size_t              getAlphabetSize() const;
+
+    private:
+
+        // Признак отсутствия состояния
+        static constexpr int32_t no_state = -1;
+
+        // Индекс корневого состояния
+        static constexpr int32_t root_state = 0;
+
+        // Построить алфавит по символам исходного дерева
+        void                intBuildAlphabet(const node_type* root);
+
+        // Получить код символа (0 - символ отсутствует в алфавите)
+        uint32_t            intGetCode(TCharType keyChar) const;
+
+        // Получить наименьший код символа алфавита, большего или равного указанному
+        /*
+         * Если такого символа нет, возвращается размер алфавита + 1
+         */
+        uint32_t            intGetLowerCode(TCharType keyChar) const;
+
+        // Найти base, при котором все переходы по указанным кодам попадают в свободные ячейки
+        int32_t             intAllocateBase(const std::vector<uint32_t>& codes);
+
+        // Увеличить массивы до указанного размера
+        /*
+         * Новые ячейки добавляются в конец списка свободных ячеек.
+         * Если индекс состояния не помещается в int32_t, выбрасывается std::length_error
+         */
+        void                intResize(size_t size);
+
+        // Занять ячейку состоянием (исключить ее из списка свободных ячеек)
+        void                intOccupyState(int32_t state, int32_t parentState);
+
+        // Получить состояние по ключу
+        int32_t             intFindState(const TCharType* key, size_t keyLength) const;
+
+        // Признак наличия значения в состоянии
+        bool                intHaveValue(int32_t state) const;
+
+    private:
+
+        std::vector<TCharType>  m_alphabet;         // Символы алфавита, упорядоченные по KeyCharLess
+        std::vector<uint32_t>   m_codeTable;        // Коды однобайтовых символов
+        std::vector<uint32_t>   m_lowerCodeTable;   // Наименьшие коды, большие или равные однобайтовым символам
+
+        std::vector<int32_t>    m_base;             // Смещения переходов для состояний
+        std::vector<int32_t>    m_check;            // Родительские состояния
+        std::vector<int32_t>    m_firstChild;       // Первое дочернее состояние (для упорядоченного обхода)
+        std::vector<int32_t>    m_nextSibling;      // Следующее состояние-брат (для упорядоченного обхода)
+        std::vector<int32_t>    m_valueIndex;       // Индекс значения в m_values
+        std::vector<TCharType>  m_labels;           // Символы ключа состояний (в том виде, в котором они хранились в Trie)
+        std::vector<TValueType> m_values;           // Значения
+
+        // Двусвязный список свободных ячеек, упорядоченный по индексу (только при построении)
+        std::vector<int32_t>    m_nextFree;         // Следующая свободная ячейка (no_state - последняя)
+        std::vector<int32_t>    m_prevFree;         // Предыдущая свободная ячейка (no_state - первая)
+        int32_t                 m_firstFree = no_state;
+        int32_t                 m_lastFree  = no_state;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Представление состояния двойного массива в виде узла дерева
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    class DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::node_view
+    {
+    public:
+
+        node_view(const this_type* trie = nullptr, int32_t state = no_state) noexcept
+            : m_trie(trie), m_state(state)
+        { }
+
+        TCharType           getKeyChar() const  { return m_trie->m_labels[m_state]; }
+        bool                haveValue()  const  { return m_trie->intHaveValue(m_state); }
+        const TValueType&   getValue()   const  { return m_trie->m_values[m_trie->m_valueIndex[m_state]]; }
+
+    private:
+
+        const this_type*    m_trie;
+        int32_t             m_state;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Итератор двойного массива
+    /*
+     * Обход выполняется в том же порядке, что и для Trie: в порядке возрастания ключей
+     */
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    class DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator
+    {
+        friend class DoubleArrayTrie<TCharType, TValueType, KeyCharLess>;
+
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = node_view;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const node_view*;
+        using reference         = const node_view&;
+
+        using string_type       = TrieStrings::StringOfCharsZeroEnd<TCharType>;
+
+        const_iterator() noexcept;
+
+        bool                operator==  (const const_iterator& other) const;
+        bool                operator!=  (const const_iterator& other) const;
+        const node_view*    operator->  ()                            const;
+        const node_view&    operator*   ()                            const;
+
+        const_iterator&     operator++  ();
+
+        // Получение полного ключа, которому соответствует состояние
+        const string_type&  getString() const;
+
+    private:
+
+        explicit const_iterator(const this_type* trie);
+
+        // Перейти к следующему состоянию в порядке обхода
+        /*
+         * bToChild - признак захода в дочерние состояния текущего состояния
+         */
+        void                intStep(bool bToChild);
+
+        // Перейти к ближайшему состоянию со значением, начиная с текущего
+        void                intSeekValue();
+
+        // Обновить представление текущего состояния
+        void                intUpdateView();
+
+    private:
+
+        const this_type*        m_trie = nullptr;
+        std::vector<int32_t>    m_path;             // Путь от корня к текущему состоянию
+        node_view               m_view;             // Представление текущего состояния
+        mutable string_type     m_string;           // Ключ, которому соответствует состояние
+        mutable bool            m_bStringActual = false;
+    };
+
+    // Построение двойного массива по заполненному дереву
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>
+    freeze(const Trie<TCharType, TValueType, KeyCharLess>& trie)
+    {
+        return DoubleArrayTrie<TCharType, TValueType, KeyCharLess>(trie);
+    }
+
+}   // namespace Trie
+
+// Имплементация методов двойного массива
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::DoubleArrayTrie() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::DoubleArrayTrie(const trie_type& trie)
+    {
+        build(trie);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::build(const trie_type& trie)
+    {
+        m_base.clear();
+        m_check.clear();
+        m_firstChild.clear();
+        m_nextSibling.clear();
+        m_valueIndex.clear();
+        m_labels.clear();
+        m_values.clear();
+        m_nextFree.clear();
+        m_prevFree.clear();
+        m_firstFree = no_state;
+        m_lastFree  = no_state;
+
+        const node_type* root = trie.getRootNode();
+
+        intBuildAlphabet(root);
+
+        // Корневое состояние
+        intResize(1);
+        intOccupyState(root_state, root_state);
+
+        // Обход в ширину: узел исходного дерева и соответствующее ему состояние
+        std::deque<std::pair<const node_type*, int32_t>> queue;
+        queue.emplace_back(root, root_state);
+
+        std::vector<uint32_t> codes;
+        while (!queue.empty())
+        {
+            const node_type* node  = queue.front().first;
+            const int32_t    state = queue.front().second;
+            queue.pop_front();
+
+            const node_type* firstChild = node->getChildSimple();
+            if (!firstChild)
+                continue;
+
+            // Коды символов дочерних элементов (братья упорядочены по KeyCharLess,
+            // поэтому коды возрастают)
+            codes.clear();
+            for (const node_type* child = firstChild; child; child = child->getNext())
+            {
+                codes.push_back(intGetCode(child->getKeyChar()));
+            }
+
+            const int32_t base = intAllocateBase(codes);
+            m_base[state] = base;
+
+            int32_t prevChildState = no_state;
+            const node_type* child = firstChild;
+            for (uint32_t code : codes)
+            {
+                const int32_t childState = base + static_cast<int32_t>(code);
+
+                intOccupyState(childState, state);
+                m_labels[childState] = child->getKeyChar();
+
+                if (child->haveValue())
+                {
+                    m_valueIndex[childState] = static_cast<int32_t>(m_values.size());
+                    m_values.push_back(child->getValue());
+                }
+
+                if (prevChildState == no_state)
+                    m_firstChild[state] = childState;
+                else
+                    m_nextSibling[prevChildState] = childState;
+                prevChildState = childState;
+
+                queue.emplace_back(child, childState);
+                child = child->getNext();
+            }
+        }
+
+        m_values.shrink_to_fit();
+
+        // Список свободных ячеек нужен только при построении
+        m_nextFree = std::vector<int32_t>();
+        m_prevFree = std::vector<int32_t>();
+        m_firstFree = no_state;
+        m_lastFree  = no_state;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::find(const string_type& key) const
+    {
+        const_iterator_type it;
+
+        const int32_t state = intFindState(key.getStr(), key.length());
+        if (state != no_state && state != root_state)
+        {
+            // Восстановим путь от корня до найденного состояния
+            it.m_trie = this;
+            for (int32_t pathState = state; pathState != root_state; pathState = m_check[pathState])
+            {
+                it.m_path.push_back(pathState);
+            }
+            std::reverse(it.m_path.begin(), it.m_path.end());
+            it.intUpdateView();
+        }
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::contains(const string_type& key) const
+    {
+        return nullptr != get(key);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const TValueType*
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::get(const string_type& key) const
+    {
+        const int32_t state = intFindState(key.getStr(), key.length());
+        if (state == no_state || state == root_state || !intHaveValue(state))
+            return nullptr;
+
+        return &m_values[m_valueIndex[state]];
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::lower_bound(const string_type& key) const
+    {
+        const_iterator_type it(this);
+        if (m_firstChild.empty() || m_firstChild[root_state] == no_state)
+            return it;
+
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        int32_t state = root_state;
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            const uint32_t lowerCode = intGetLowerCode(keyBuf[keyCharIndex]);
+
+            // Найдем первое дочернее состояние с символом, большим или равным символу ключа
+            int32_t childState = m_firstChild[state];
+            while (childState != no_state
+                && static_cast<uint32_t>(childState - m_base[state]) < lowerCode)
+            {
+                childState = m_nextSibling[childState];
+            }
+
+            if (childState == no_state)
+            {
+                // Все ключи поддерева меньше искомого - переходим за поддерево
+                if (it.m_path.empty())
+                    return cend();
+
+                it.intUpdateView();
+                it.intStep(false);
+                it.intSeekValue();
+                return it;
+            }
+
+            it.m_path.push_back(childState);
+
+            // Символ не совпадает - первый ключ поддерева больше искомого
+            if (static_cast<uint32_t>(childState - m_base[state]) != intGetCode(keyBuf[keyCharIndex]))
+                break;
+
+            state = childState;
+        }
+
+        if (it.m_path.empty())
+        {
+            // Пустой ключ - первый элемент
+            return cbegin();
+        }
+
+        it.intUpdateView();
+        it.intSeekValue();
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::begin() const
+    {
+        return cbegin();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::end() const
+    {
+        return cend();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::cbegin() const
+    {
+        const_iterator_type it(this);
+
+        if (!m_firstChild.empty() && m_firstChild[root_state] != no_state)
+        {
+            it.m_path.push_back(m_firstChild[root_state]);
+            it.intUpdateView();
+            it.intSeekValue();
+        }
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::cend() const
+    {
+        return const_iterator_type();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    size_t
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::getStatesCount() const
+    {
+        return m_check.size();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    size_t
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::getAlphabetSize() const
+    {
+        return m_alphabet.size();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::intBuildAlphabet(const node_type* root)
+    {
+        m_alphabet.clear();
+        m_codeTable.clear();
+        m_lowerCodeTable.clear();
+
+        // Соберем все символы исходного дерева
+        std::vector<const node_type*> stack;
+        if (const node_type* firstChild = root->getChildSimple())
+            stack.push_back(firstChild);
+
+        while (!stack.empty())
+        {
+            const node_type* node = stack.back();
+            stack.pop_back();
+
+            for (; node; node = node->getNext())
+            {
+                m_alphabet.push_back(node->getKeyChar());
+
+                if (const node_type* child = node->getChildSimple())
+                    stack.push_back(child);
+            }
+        }
+
+        // Упорядочим символы и оставим по одному символу из каждого класса равных символов
+        std::sort(m_alphabet.begin(), m_alphabet.end(),
+            [](TCharType ch1, TCharType ch2) { return is_key_less<KeyCharLess>(ch1, ch2); });
+        m_alphabet.erase(std::unique(m_alphabet.begin(), m_alphabet.end(),
+            [](TCharType ch1, TCharType ch2) { return is_key_eq<KeyCharLess>(ch1, ch2); }),
+            m_alphabet.end());
+
+        // Для однобайтовых символов коды вычисляются заранее
+        if (sizeof(TCharType) == 1)
+        {
+            m_codeTable.resize(256);
+            m_lowerCodeTable.resize(256);
+
+            for (size_t charIndex = 0; charIndex < 256; ++charIndex)
+            {
+                const TCharType keyChar = static_cast<TCharType>(charIndex);
+
+                auto it = std::lower_bound(m_alphabet.begin(), m_alphabet.end(), keyChar,
+                    [](TCharType ch1, TCharType ch2) { return is_key_less<KeyCharLess>(ch1, ch2); });
+
+                const uint32_t lowerCode = static_cast<uint32_t>(it - m_alphabet.begin()) + 1;
+
+                m_lowerCodeTable[charIndex] = lowerCode;
+                m_codeTable[charIndex] = (it != m_alphabet.end() && is_key_eq<KeyCharLess>(*it, keyChar)) ? lowerCode : 0;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    uint32_t
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::intGetCode(TCharType keyChar) const
+    {
+        if (sizeof(TCharType) == 1)
+            return m_codeTable[static_cast<unsigned char>(keyChar)];
+
+        auto it = std::lower_bound(m_alphabet.begin(), m_alphabet.end(), keyChar,
+            [](TCharType ch1, TCharType ch2) { return is_key_less<KeyCharLess>(ch1, ch2); });
+
+        if (it == m_alphabet.end() || !is_key_eq<KeyCharLess>(*it, keyChar))
+            return 0;
+
+        return static_cast<uint32_t>(it - m_alphabet.begin()) + 1;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    uint32_t
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::intGetLowerCode(TCharType keyChar) const
+    {
+        if (sizeof(TCharType) == 1)
+            return m_lowerCodeTable[static_cast<unsigned char>(keyChar)];
+
+        auto it = std::lower_bound(m_alphabet.begin(), m_alphabet.end(), keyChar,
+            [](TCharType ch1, TCharType ch2) { return is_key_less<KeyCharLess>(ch1, ch2); });
+
+        return static_cast<uint32_t>(it - m_alphabet.begin()) + 1;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    int32_t
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::intAllocateBase(const std::vector<uint32_t>& codes)
+    {
+        // Первый код совмещаем со свободной ячейкой (перебираются только ячейки
+        // из списка свободных, за концом массива свободны все), остальные проверяем
+        size_t position = m_firstFree != no_state ? static_cast<size_t>(m_firstFree) : m_check.size();
+        for (;;)
+        {
+            if (position > codes.front())
+            {
+                const size_t base = position - codes.front();
+
+                bool bFits = true;
+                for (uint32_t code : codes)
+                {
+                    const size_t childState = base + code;
+                    if (childState < m_check.size() && m_check[childState] != no_state)
+                    {
+                        bFits = false;
+                        break;
+                    }
+                }
+
+                if (bFits)
+                {
+                    intResize(base + codes.back() + 1);
+                    return static_cast<int32_t>(base);
+                }
+            }
+
+            if (position >= m_check.size())
+                ++position;
+            else if (m_nextFree[position] != no_state)
+                position = static_cast<size_t>(m_nextFree[position]);
+            else
+                position = m_check.size();
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::intResize(size_t size)
+    {
+        if (size <= m_check.size())
+            return;
+
+        if (size - 1 > static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+            throw std::length_error("DoubleArrayTrie: too many states");
+
+        const size_t oldSize = m_check.size();
+
+        m_base.resize(size, 0);
+        m_check.resize(size, no_state);
+        m_firstChild.resize(size, no_state);
+        m_nextSibling.resize(size, no_state);
+        m_valueIndex.resize(size, no_state);
+        m_labels.resize(size, 0);
+        m_nextFree.resize(size, no_state);
+        m_prevFree.resize(size, no_state);
+
+        // Новые ячейки свободны
+        for (size_t cell = oldSize; cell < size; ++cell)
+        {
+            const int32_t state = static_cast<int32_t>(cell);
+
+            m_prevFree[cell] = m_lastFree;
+            if (m_lastFree != no_state)
+                m_nextFree[m_lastFree] = state;
+            else
+                m_firstFree = state;
+            m_lastFree = state;
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    void
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::intOccupyState(int32_t state, int32_t parentState)
+    {
+        assert(m_check[state] == no_state);
+
+        m_check[state] = parentState;
+
+        const int32_t prevFree = m_prevFree[state];
+        const int32_t nextFree = m_nextFree[state];
+
+        if (prevFree != no_state)
+            m_nextFree[prevFree] = nextFree;
+        else
+            m_firstFree = nextFree;
+
+        if (nextFree != no_state)
+            m_prevFree[nextFree] = prevFree;
+        else
+            m_lastFree = prevFree;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    int32_t
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::intFindState(const TCharType* key, size_t keyLength) const
+    {
+        if (m_check.empty())
+            return no_state;
+
+        int32_t state = root_state;
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            const uint32_t code = intGetCode(key[keyCharIndex]);
+            if (!code)
+                return no_state;
+
+            const size_t childState = static_cast<size_t>(m_base[state]) + code;
+            if (childState >= m_check.size() || m_check[childState] != state)
+                return no_state;
+
+            state = static_cast<int32_t>(childState);
+        }
+
+        return state;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    bool
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::intHaveValue(int32_t state) const
+    {
+        return m_valueIndex[state] != no_state;
+    }
+
+}   // namespace Trie (Имплементация методов двойного массива)
+
+// Имплементация итератора двойного массива
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator::const_iterator() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator::const_iterator(const this_type* trie)
+        : m_trie (trie)
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator==(
+        const const_iterator& other) const
+    {
+        if (m_path.empty() || other.m_path.empty())
+            return m_path.empty() && other.m_path.empty();
+
+        // Состояние однозначно определяет путь к нему
+        return m_trie == other.m_trie && m_path.back() == other.m_path.back();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator!=(
+        const const_iterator& other) const
+    {
+        return !operator==(other);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::node_view*
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator->() const
+    {
+        return &m_view;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::node_view&
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator*() const
+    {
+        return m_view;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator&
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator++()
+    {
+        if (!m_path.empty())
+        {
+            intStep(true);
+            intSeekValue();
+        }
+
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator::string_type&
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator::getString() const
+    {
+        if (!m_bStringActual)
+        {
+            m_string.clear();
+            m_string.reserve(m_path.size() + 1);
+
+            for (int32_t state : m_path)
+            {
+                m_string.appendChar(m_trie->m_labels[state]);
+            }
+
+            m_bStringActual = true;
+        }
+
+        return m_string;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator::intStep(bool bToChild)
+    {
+        if (bToChild)
+        {
+            const int32_t childState = m_trie->m_firstChild[m_path.back()];
+            if (childState != no_state)
+            {
+                m_path.push_back(childState);
+                intUpdateView();
+                return;
+            }
+        }
+
+        // Переходим к следующему брату текущего состояния или ближайшего из предков
+        while (!m_path.empty())
+        {
+            const int32_t nextState = m_trie->m_nextSibling[m_path.back()];
+            m_path.pop_back();
+
+            if (nextState != no_state)
+            {
+                m_path.push_back(nextState);
+                break;
+            }
+        }
+
+        intUpdateView();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator::intSeekValue()
+    {
+        while (!m_path.empty() && !m_trie->intHaveValue(m_path.back()))
+        {
+            intStep(true);
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    DoubleArrayTrie<TCharType, TValueType, KeyCharLess>::const_iterator::intUpdateView()
+    {
+        m_view = m_path.empty() ? node_view() : node_view(m_trie, m_path.back());
+        m_bStringActual = false;
+    }
+
+}   // namespace Trie (Имплементация итератора двойного массива)
@@ -0,0 +1,995 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "TrieData.h"
+
+namespace Trie
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Битовый вектор с поддержкой операций rank/select
+    /*
+     * Для rank хранится число единиц перед каждым блоком из 512 бит
+     * (дополнительно 12.5% к размеру вектора), select выполняется двоичным
+     * поиском по блокам и последующим просмотром слов блока.
+     */
+    class SuccinctBitVector
+    {
+    public:
+
+        // Добавить бит в конец вектора
+        void                push_back(bool bit);
+
+        // Построить индекс для rank/select (вызывается после заполнения вектора)
+        void                build();
+
+        // Очистить вектор
+        void                clear();
+
+        // Получить значение бита
+        bool                operator[](size_t position) const;
+
+        // Получить количество бит
+        size_t              size() const;
+
+        // Получить количество единичных бит на отрезке [0, position)
+        size_t              rank1(size_t position) const;
+
+        // Получить количество нулевых бит на отрезке [0, position)
+        size_t              rank0(size_t position) const;
+
+        // Получить позицию единичного бита с указанным номером (нумерация с 0)
+        size_t              select1(size_t index) const;
+
+        // Получить позицию нулевого бита с указанным номером (нумерация с 0)
+        size_t              select0(size_t index) const;
+
+        // Получить объем памяти, занимаемый вектором и индексом (в байтах)
+        size_t              getMemorySize() const;
+
+    private:
+
+        static constexpr size_t word_bits   = 64;
+        static constexpr size_t block_words = 8;
+        static constexpr size_t block_bits  = word_bits * block_words;
+
+        static unsigned     intPopCount(uint64_t word);
+
+        // Получить позицию единичного бита с указанным номером в слове
+        static unsigned     intSelectInWord(uint64_t word, unsigned index);
+
+        // Общий алгоритм select для единичных (bOnes == true) или нулевых бит
+        size_t              intSelect(size_t index, bool bOnes) const;
+
+    private:
+
+        std::vector<uint64_t>   m_words;
+        std::vector<uint64_t>   m_blockRanks;       // Количество единиц перед каждым блоком
+        size_t                  m_size = 0;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Сжатое (succinct) неизменяемое цифровое дерево в кодировке LOUDS
+    /*
+     * Структура дерева кодируется обходом в ширину: для каждого узла
+     * записывается 1 на каждый дочерний элемент и завершающий 0
+     * (2 бита на узел). Символы ключей хранятся в массиве меток в порядке
+     * обхода, признаки наличия значений - в отдельном битовом векторе,
+     * значения - в плотном массиве только для узлов со значениями.
+     * Дочерние элементы узла имеют последовательные номера, поэтому поиск
+     * символа среди них выполняется двоичным поиском по меткам.
+     */
+    template<typename TCharType, typename TValueType, typename KeyCharLess = compare_no_case>
+    class LoudsTrie
+    {
+    public:
+
+        using this_type     = LoudsTrie<TCharType, TValueType, KeyCharLess>;
+        using string_type   = TrieStrings::StringOfChars<TCharType>;
+        using trie_type     = Trie<TCharType, TValueType, KeyCharLess>;
+        using node_type     = typename trie_type::node_type;
+
+        class node_view;
+        class const_iterator;
+
+        using const_iterator_type = const_iterator;
+
+        LoudsTrie() noexcept;
+        explicit LoudsTrie(const trie_type& trie);
+
+        // Построение сжатого представления по заполненному дереву
+        /**
+         * Предыдущее содержимое удаляется.
+         *
+         * @param trie - исходное дерево
+         */
+        void                build(const trie_type& trie);
+
+        // Поиск заданного ключа (слова)
+        /**
+         * @param   key - искомый ключ
+         * @return  итератор для найденого узла по ключу.
+         *          Если не найдено, то будет возвращено cend()
+         */
+        const_iterator_type find(const string_type& key) const;
+
+        // Проверка наличия значения для заданного ключа (слова)
+        bool                contains(const string_type& key) const;
+
+        // Получение значения для заданного ключа (слова)
+        /**
+         * @return  указатель на значение, связанное с ключом.
+         *          Если значения нет, то будет возвращен nullptr
+         */
+        const TValueType*   get(const string_type& key) const;
+
+        // Поиск элемента, ключ которого больше или равен указанному
+        /**
+         * @param key - ключ
+         * @return итератор для элемента, ключ которого больше
+         *         или равен указанному ключу.
+         *         Если подходящих элементов не найдено, будет
+         *         возвращен итератор cend()
+         */
+        const_iterator_type lower_bound(const string_type& key) const;
+
+        // Получение диапазона элементов, ключи которых начинаются с указанного префикса
+        /**
+         * @param prefix - префикс ключей
+         * @return пара итераторов [первый элемент с префиксом, первый элемент после них)
+         */
+        std::pair<const_iterator_type, const_iterator_type>
+                            prefix_range(const string_type& prefix) const;
+
+        const_iterator_type begin()  const;
+        const_iterator_type end()    const;
+        const_iterator_type cbegin() const;
+        const_iterator_type cend()   const;
+
+        // Получить количество узлов (без корня)
+        size_t              getNodesCount() const;
+
+        // Получить объем памяти, занимаемый структурой дерева, метками и значениями (в байтах)
+        size_t              getMemorySize() const;
+
+    private:
+
+        // Узел в процессе обхода: номер узла и позиция его единичного бита в LOUDS
+        struct NodePos
+        {
+            size_t id;
+            size_t pos;
+        };
+
+        // Получить диапазон номеров дочерних элементов узла [first, first + count)
+        void                intGetChildren(size_t id, size_t& first, size_t& count) const;
+
+        // Найти дочерний элемент узла с указанным символом
+        bool                intFindChild(size_t id, TCharType keyChar, size_t& childId) const;
+
+        // Найти первый дочерний элемент узла с символом, большим или равным указанному
+        bool                intFindChildEqOrGreat(size_t id, TCharType keyChar, size_t& childId) const;
+
+        // Получить узел по ключу (false - если узла нет)
+        bool                intFindNode(const TCharType* key, size_t keyLength, size_t& id) const;
+
+        // Получить символ ключа узла
+        TCharType           intGetLabel(size_t id) const;
+
+        // Признак наличия значения в узле
+        bool                intHaveValue(size_t id) const;
+
+        // Получить значение узла
+        const TValueType&   intGetValue(size_t id) const;
+
+        // Построить итератор, указывающий на узел с указанным номером
+        const_iterator_type intMakeIterator(size_t id) const;
+
+    private:
+
+        SuccinctBitVector       m_louds;            // Структура дерева
+        SuccinctBitVector       m_terminals;        // Признаки наличия значений (по номерам узлов)
+        std::vector<TCharType>  m_labels;           // Символы ключей узлов (номер узла - 1)
+        std::vector<TValueType> m_values;           // Значения (по рангу в m_terminals)
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Представление узла LOUDS в виде узла дерева
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    class LoudsTrie<TCharType, TValueType, KeyCharLess>::node_view
+    {
+    public:
+
+        node_view(const this_type* trie = nullptr, size_t id = 0) noexcept
+            : m_trie(trie), m_id(id)
+        { }
+
+        TCharType           getKeyChar() const  { return m_trie->intGetLabel(m_id); }
+        bool                haveValue()  const  { return m_trie->intHaveValue(m_id); }
+        const TValueType&   getValue()   const  { return m_trie->intGetValue(m_id); }
+
+    private:
+
+        const this_type*    m_trie;
+        size_t              m_id;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Итератор сжатого дерева
+    /*
+     * Обход выполняется в том же порядке, что и для Trie: в порядке возрастания ключей
+     */
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    class LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator
+    {
+        friend class LoudsTrie<TCharType, TValueType, KeyCharLess>;
+
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = node_view;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const node_view*;
+        using reference         = const node_view&;
+
+        using string_type       = TrieStrings::StringOfCharsZeroEnd<TCharType>;
+
+        const_iterator() noexcept;
+
+        bool                operator==  (const const_iterator& other) const;
+        bool                operator!=  (const const_iterator& other) const;
+        const node_view*    operator->  ()                            const;
+        const node_view&    operator*   ()                            const;
+
+        const_iterator&     operator++  ();
+
+        // Получение полного ключа, которому соответствует узел
+        const string_type&  getString() const;
+
+    private:
+
+        explicit const_iterator(const this_type* trie);
+
+        // Перейти к следующему узлу в порядке обхода
+        /*
+         * bToChild - признак захода в дочерние элементы текущего узла
+         */
+        void                intStep(bool bToChild);
+
+        // Перейти к ближайшему узлу со значением, начиная с текущего
+        void                intSeekValue();
+
+        // Добавить в путь узел с указанным номером
+        void                intPush(size_t id);
+
+        // Обновить представление текущего узла
+        void                intUpdateView();
+
+    private:
+
+        const this_type*        m_trie = nullptr;
+        std::vector<NodePos>    m_path;             // Путь от корня к текущему узлу (без корня)
+        node_view               m_view;             // Представление текущего узла
+        mutable string_type     m_string;           // Ключ, которому соответствует узел
+        mutable bool            m_bStringActual = false;
+    };
+
+}   // namespace Trie
+
+// Имплементация методов битового вектора
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    inline
+    void
+    SuccinctBitVector::push_back(bool bit)
+    {
+        if (m_size % word_bits == 0)
+            m_words.push_back(0);
+
+        if (bit)
+            m_words.back() |= uint64_t(1) << (m_size % word_bits);
+
+        ++m_size;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    void
+    SuccinctBitVector::build()
+    {
+        m_words.shrink_to_fit();
+
+        const size_t blocksCount = (m_words.size() + block_words - 1) / block_words;
+
+        m_blockRanks.assign(blocksCount + 1, 0);
+
+        uint64_t rank = 0;
+        for (size_t wordIndex = 0; wordIndex < m_words.size(); ++wordIndex)
+        {
+            if (wordIndex % block_words == 0)
+                m_blockRanks[wordIndex / block_words] = rank;
+
+            rank += intPopCount(m_words[wordIndex]);
+        }
+
+        m_blockRanks[blocksCount] = rank;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    void
+    SuccinctBitVector::clear()
+    {
+        m_words.clear();
+        m_blockRanks.clear();
+        m_size = 0;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    bool
+    SuccinctBitVector::operator[](size_t position) const
+    {
+        return 0 != ((m_words[position / word_bits] >> (position % word_bits)) & 1);
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    SuccinctBitVector::size() const
+    {
+        return m_size;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    SuccinctBitVector::rank1(size_t position) const
+    {
+        const size_t wordIndex = position / word_bits;
+        const size_t blockIndex = wordIndex / block_words;
+
+        size_t rank = static_cast<size_t>(m_blockRanks[blockIndex]);
+        for (size_t index = blockIndex * block_words; index < wordIndex; ++index)
+        {
+            rank += intPopCount(m_words[index]);
+        }
+
+        const size_t bitIndex = position % word_bits;
+        if (bitIndex)
+            rank += intPopCount(m_words[wordIndex] & ((uint64_t(1) << bitIndex) - 1));
+
+        return rank;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    SuccinctBitVector::rank0(size_t position) const
+    {
+        return position - rank1(position);
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    SuccinctBitVector::select1(size_t index) const
+    {
+        return intSelect(index, true);
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    SuccinctBitVector::select0(size_t index) const
+    {
+        return intSelect(index, false);
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    SuccinctBitVector::getMemorySize() const
+    {
+        return m_words.size() * sizeof(uint64_t) + m_blockRanks.size() * sizeof(uint64_t);
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    unsigned
+    SuccinctBitVector::intPopCount(uint64_t word)
+    {
+#if defined(_MSC_VER) && defined(_M_X64)
+        return static_cast<unsigned>(__popcnt64(word));
+#elif defined(__GNUC__)
+        return static_cast<unsigned>(__builtin_popcountll(word));
+#else
+        word = word - ((word >> 1) & 0x5555555555555555ULL);
+        word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+        word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return static_cast<unsigned>((word * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    unsigned
+    SuccinctBitVector::intSelectInWord(uint64_t word, unsigned index)
+    {
+        // Пропустим целые байты, затем найдем бит внутри байта
+        unsigned position = 0;
+        while (true)
+        {
+            const unsigned byteOnes = intPopCount(word & 0xFF);
+            if (index < byteOnes)
+                break;
+
+            index -= byteOnes;
+            word >>= 8;
+            position += 8;
+        }
+
+        while (true)
+        {
+            if (word & 1)
+            {
+                if (index == 0)
+                    return position;
+                --index;
+            }
+
+            word >>= 1;
+            ++position;
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    SuccinctBitVector::intSelect(size_t index, bool bOnes) const
+    {
+        // Количество искомых бит перед блоком
+        auto blockCount = [&](size_t blockIndex) -> size_t
+        {
+            const size_t ones = static_cast<size_t>(m_blockRanks[blockIndex]);
+            return bOnes ? ones : blockIndex * block_bits - ones;
+        };
+
+        // Двоичный поиск последнего блока, перед которым искомых бит не больше index
+        size_t blockLow  = 0;
+        size_t blockHigh = m_blockRanks.size() - 1;
+        while (blockLow + 1 < blockHigh)
+        {
+            const size_t blockMiddle = (blockLow + blockHigh) / 2;
+            if (blockCount(blockMiddle) <= index)
+                blockLow = blockMiddle;
+            else
+                blockHigh = blockMiddle;
+        }
+
+        index -= blockCount(blockLow);
+
+        // Просмотр слов блока
+        for (size_t wordIndex = blockLow * block_words; wordIndex < m_words.size(); ++wordIndex)
+        {
+            const uint64_t word = bOnes ? m_words[wordIndex] : ~m_words[wordIndex];
+            const unsigned wordCount = intPopCount(word);
+
+            if (index < wordCount)
+                return wordIndex * word_bits + intSelectInWord(word, static_cast<unsigned>(index));
+
+            index -= wordCount;
+        }
+
+        return m_size;
+    }
+
+}   // namespace Trie (Имплементация методов битового вектора)
+
+// Имплементация методов сжатого дерева
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::LoudsTrie() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::LoudsTrie(const trie_type& trie)
+    {
+        build(trie);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::build(const trie_type& trie)
+    {
+        m_louds.clear();
+        m_terminals.clear();
+        m_labels.clear();
+        m_values.clear();
+
+        // Фиктивный предок корня: "10"
+        m_louds.push_back(true);
+        m_louds.push_back(false);
+
+        // Корень не имеет значения
+        m_terminals.push_back(false);
+
+        // Обход в ширину
+        std::deque<const node_type*> queue;
+        queue.push_back(trie.getRootNode());
+
+        while (!queue.empty())
+        {
+            const node_type* node = queue.front();
+            queue.pop_front();
+
+            for (const node_type* child = node->getChildSimple(); child; child = child->getNext())
+            {
+                m_louds.push_back(true);
+                m_labels.push_back(child->getKeyChar());
+
+                m_terminals.push_back(child->haveValue());
+                if (child->haveValue())
+                    m_values.push_back(child->getValue());
+
+                queue.push_back(child);
+            }
+
+            m_louds.push_back(false);
+        }
+
+        m_louds.build();
+        m_terminals.build();
+        m_labels.shrink_to_fit();
+        m_values.shrink_to_fit();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::find(const string_type& key) const
+    {
+        size_t id = 0;
+        if (!intFindNode(key.getStr(), key.length(), id) || id == 0)
+            return cend();
+
+        return intMakeIterator(id);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::contains(const string_type& key) const
+    {
+        return nullptr != get(key);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const TValueType*
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::get(const string_type& key) const
+    {
+        size_t id = 0;
+        if (!intFindNode(key.getStr(), key.length(), id) || !intHaveValue(id))
+            return nullptr;
+
+        return &intGetValue(id);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::lower_bound(const string_type& key) const
+    {
+        const_iterator_type it(this);
+        if (m_labels.empty())
+            return it;
+
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        size_t id = 0;
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            size_t childId = 0;
+            if (!intFindChildEqOrGreat(id, keyBuf[keyCharIndex], childId))
+            {
+                // Все ключи поддерева меньше искомого - переходим за поддерево
+                if (it.m_path.empty())
+                    return cend();
+
+                it.intStep(false);
+                it.intSeekValue();
+                return it;
+            }
+
+            it.intPush(childId);
+
+            // Символ не совпадает - первый ключ поддерева больше искомого
+            if (!is_key_eq<KeyCharLess>(intGetLabel(childId), keyBuf[keyCharIndex]))
+                break;
+
+            id = childId;
+        }
+
+        if (it.m_path.empty())
+            return cbegin();
+
+        it.intSeekValue();
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    std::pair<typename LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type,
+              typename LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type>
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::prefix_range(const string_type& prefix) const
+    {
+        size_t id = 0;
+        if (!intFindNode(prefix.getStr(), prefix.length(), id))
+            return std::make_pair(cend(), cend());
+
+        if (id == 0)
+            return std::make_pair(cbegin(), cend());
+
+        const_iterator_type first = intMakeIterator(id);
+        const_iterator_type last  = first;
+
+        first.intSeekValue();
+
+        last.intStep(false);
+        last.intSeekValue();
+
+        return std::make_pair(first, last);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::begin() const
+    {
+        return cbegin();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::end() const
+    {
+        return cend();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::cbegin() const
+    {
+        const_iterator_type it(this);
+
+        if (!m_labels.empty())
+        {
+            // Первый дочерний элемент корня имеет номер 1
+            it.intPush(1);
+            it.intSeekValue();
+        }
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::cend() const
+    {
+        return const_iterator_type();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    size_t
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::getNodesCount() const
+    {
+        return m_labels.size();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    size_t
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::getMemorySize() const
+    {
+        return m_louds.getMemorySize()
+            + m_terminals.getMemorySize()
+            + m_labels.size() * sizeof(TCharType)
+            + m_values.size() * sizeof(TValueType);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    void
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::intGetChildren(size_t id, size_t& first, size_t& count) const
+    {
+        // Блок дочерних элементов узла расположен между его нулевым битом
+        // и нулевым битом следующего узла
+        const size_t blockStart = m_louds.select0(id) + 1;
+
+        first = m_louds.rank1(blockStart);
+        count = m_louds.select0(id + 1) - blockStart;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    bool
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::intFindChild(size_t id, TCharType keyChar, size_t& childId) const
+    {
+        if (!intFindChildEqOrGreat(id, keyChar, childId))
+            return false;
+
+        return is_key_eq<KeyCharLess>(intGetLabel(childId), keyChar);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    bool
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::intFindChildEqOrGreat(size_t id, TCharType keyChar, size_t& childId) const
+    {
+        size_t first = 0;
+        size_t count = 0;
+        intGetChildren(id, first, count);
+        if (!count)
+            return false;
+
+        // Метки дочерних элементов упорядочены по KeyCharLess
+        auto labelsBegin = m_labels.begin() + (first - 1);
+        auto labelsEnd   = labelsBegin + count;
+        auto it = std::lower_bound(labelsBegin, labelsEnd, keyChar,
+            [](TCharType ch1, TCharType ch2) { return is_key_less<KeyCharLess>(ch1, ch2); });
+
+        if (it == labelsEnd)
+            return false;
+
+        childId = first + static_cast<size_t>(it - labelsBegin);
+
+        return true;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::intFindNode(const TCharType* key, size_t keyLength, size_t& id) const
+    {
+        id = 0;
+        if (m_louds.size() == 0)
+            return false;
+
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            if (!intFindChild(id, key[keyCharIndex], id))
+                return false;
+        }
+
+        return true;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    TCharType
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::intGetLabel(size_t id) const
+    {
+        return m_labels[id - 1];
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    bool
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::intHaveValue(size_t id) const
+    {
+        return m_terminals[id];
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    const TValueType&
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::intGetValue(size_t id) const
+    {
+        return m_values[m_terminals.rank1(id)];
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::intMakeIterator(size_t id) const
+    {
+        // Восстановим путь от корня до узла по родительским ссылкам
+        std::vector<size_t> ids;
+        for (; id != 0; id = m_louds.rank0(m_louds.select1(id)) - 1)
+        {
+            ids.push_back(id);
+        }
+
+        const_iterator_type it(this);
+        for (auto idIt = ids.rbegin(); idIt != ids.rend(); ++idIt)
+        {
+            it.intPush(*idIt);
+        }
+
+        return it;
+    }
+
+}   // namespace Trie (Имплементация методов сжатого дерева)
+
+// Имплементация итератора сжатого дерева
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator::const_iterator() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator::const_iterator(const this_type* trie)
+        : m_trie (trie)
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator==(
+        const const_iterator& other) const
+    {
+        if (m_path.empty() || other.m_path.empty())
+            return m_path.empty() && other.m_path.empty();
+
+        // Номер узла однозначно определяет путь к нему
+        return m_trie == other.m_trie && m_path.back().id == other.m_path.back().id;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator!=(
+        const const_iterator& other) const
+    {
+        return !operator==(other);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename LoudsTrie<TCharType, TValueType, KeyCharLess>::node_view*
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator->() const
+    {
+        return &m_view;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename LoudsTrie<TCharType, TValueType, KeyCharLess>::node_view&
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator*() const
+    {
+        return m_view;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator&
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator++()
+    {
+        if (!m_path.empty())
+        {
+            intStep(true);
+            intSeekValue();
+        }
+
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator::string_type&
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator::getString() const
+    {
+        if (!m_bStringActual)
+        {
+            m_string.clear();
+            m_string.reserve(m_path.size() + 1);
+
+            for (const NodePos& nodePos : m_path)
+            {
+                m_string.appendChar(m_trie->intGetLabel(nodePos.id));
+            }
+
+            m_bStringActual = true;
+        }
+
+        return m_string;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator::intStep(bool bToChild)
+    {
+        const SuccinctBitVector& louds = m_trie->m_louds;
+
+        if (bToChild)
+        {
+            const size_t blockStart = louds.select0(m_path.back().id) + 1;
+            if (blockStart < louds.size() && louds[blockStart])
+            {
+                m_path.push_back({ louds.rank1(blockStart), blockStart });
+                intUpdateView();
+                return;
+            }
+        }
+
+        // Переходим к следующему брату текущего узла или ближайшего из предков:
+        // брат существует, если за единичным битом узла следует единичный бит
+        while (!m_path.empty())
+        {
+            NodePos& nodePos = m_path.back();
+            if (nodePos.pos + 1 < louds.size() && louds[nodePos.pos + 1])
+            {
+                ++nodePos.id;
+                ++nodePos.pos;
+                break;
+            }
+
+            m_path.pop_back();
+        }
+
+        intUpdateView();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator::intSeekValue()
+    {
+        while (!m_path.empty() && !m_trie->intHaveValue(m_path.back().id))
+        {
+            intStep(true);
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator::intPush(size_t id)
+    {
+        m_path.push_back({ id, m_trie->m_louds.select1(id) });
+        intUpdateView();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    LoudsTrie<TCharType, TValueType, KeyCharLess>::const_iterator::intUpdateView()
+    {
+        m_view = m_path.empty() ? node_view() : node_view(m_trie, m_path.back().id);
+        m_bStringActual = false;
+    }
+
+}   // namespace Trie (Имплементация итератора сжатого дерева)
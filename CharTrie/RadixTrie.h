@@ -0,0 +1,996 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <memory_resource>
+#include <algorithm>
+
+#include "TrieData.h"
+
+namespace Trie
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Узел цифрового дерева со сжатыми путями
+    /*
+     * Узел соответствует ребру, помеченному цепочкой символов.
+     * Цепочки узлов без значений с единственным дочерним элементом
+     * объединяются в один узел.
+     */
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    class RadixNode
+    {
+    public:
+
+        using node_type  = RadixNode<TCharType, TValueType, KeyCharLess>;
+        using label_type = std::pmr::basic_string<TCharType>;
+
+        // Создание/разрушение узлов в указанном ресурсе памяти
+        static node_type*   create(std::pmr::memory_resource* resource, const TCharType* label, size_t labelLength);
+        static void         destroy(std::pmr::memory_resource* resource, node_type* node);
+
+        RadixNode(std::pmr::memory_resource* resource, const TCharType* label, size_t labelLength);
+
+        ///////////////////////////////////////////
+        // Работа с цепочкой символов ключа
+
+        const label_type&   getLabel() const;
+        label_type&         getLabel();
+
+        ///////////////////////////////////////////
+        // Работа со значением
+
+        bool                haveValue() const;
+        void                setValue(TValueType value);
+        void                resetValue();
+        const TValueType&   getValue() const;
+
+        ///////////////////////////////////////////
+        // Работа со следующими и дочерними элементами
+
+        void                setNext(node_type* next);
+        node_type*          getNext() const;
+
+        void                setChild(node_type* child);
+        node_type*          getChild() const;
+
+    private:
+
+        label_type          m_label;
+        bool                m_bHaveValue = false;
+        TValueType          m_value      = TValueType();
+        node_type*          m_pNext      = nullptr;
+        node_type*          m_pChild     = nullptr;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Цифровое дерево со сжатыми путями (Patricia/radix)
+    /*
+     * Интерфейс и порядок обхода совпадают с Trie, но цепочки символов,
+     * не имеющие ветвлений и значений, хранятся в одном узле.
+     * Добавление ключа разделяет ребро в точке расхождения, удаление
+     * объединяет оставшиеся цепочки обратно.
+     * Для ключей с длинными общими частями без ветвлений (URL, пути)
+     * количество узлов и переходов по указателям значительно меньше.
+     */
+    template<typename TCharType, typename TValueType, typename KeyCharLess = compare_no_case>
+    class RadixTrie
+    {
+    public:
+
+        using this_type     = RadixTrie<TCharType, TValueType, KeyCharLess>;
+        using string_type   = TrieStrings::StringOfChars<TCharType>;
+        using node_type     = RadixNode<TCharType, TValueType, KeyCharLess>;
+
+        class const_iterator;
+
+        using const_iterator_type = const_iterator;
+
+        RadixTrie(NodesAllocation allocation = NodesAllocation::Heap);
+        explicit RadixTrie(std::pmr::memory_resource* resource);
+
+        RadixTrie(const RadixTrie&) = delete;
+        RadixTrie& operator=(const RadixTrie&) = delete;
+        ~RadixTrie();
+
+        // Добавление пары ключ/значение
+        /**
+         * Если ключ найден, то заменяем значение на новое.
+         * Если ключ не найден, то добавляется новая пара ключ/значение
+         *
+         * @param   key - ключ для добавляемого узла (не пустой)
+         * @param   value - значение для добавляемого узла
+         * @return  указатель на узел, соответствующий ключу
+         */
+        node_type*          addKeyValue(const string_type& key, TValueType value);
+
+        // Удаление заданного ключа (слова) из дерева
+        /**
+         * Удаляется ключ, значение (если есть) и все другие пары
+         * ключ/значение, у которых ключ начинается с указанного
+         *
+         * @param   key - ключ для удаляемого элемента
+         * @return  true - если элемент по ключу был найден и удален, false - иначе
+         */
+        bool                removeKey(const string_type& key);
+
+        // Поиск заданного ключа (слова) в дереве
+        /**
+         * Промежуточных узлов для префиксов внутри ребер нет, поэтому
+         * находятся только ключи, с которыми связано значение.
+         *
+         * @param   key - искомый ключ
+         * @return  итератор для найденого ключа.
+         *          Если не найдено, то будет возвращено cend()
+         */
+        const_iterator_type find(const string_type& key) const;
+
+        // Проверка наличия значения для заданного ключа (слова)
+        bool                contains(const string_type& key) const;
+
+        // Получение значения для заданного ключа (слова)
+        /**
+         * @return  указатель на значение, связанное с ключом.
+         *          Если значения нет, то будет возвращен nullptr
+         */
+        const TValueType*   get(const string_type& key) const;
+
+        // Поиск элемента, ключ которого больше или равен указанному
+        /**
+         * @param key - ключ
+         * @return итератор для элемента, ключ которого больше
+         *         или равен указанному ключу.
+         *         Если подходящих элементов не найдено, будет
+         *         возвращен итератор cend()
+         */
+        const_iterator_type lower_bound(const string_type& key) const;
+
+        const_iterator_type begin()  const;
+        const_iterator_type end()    const;
+        const_iterator_type cbegin() const;
+        const_iterator_type cend()   const;
+
+        // Получить количество узлов дерева (без корня)
+        size_t              getNodesCount() const;
+
+    private:
+
+        // Найти среди братьев узел, цепочка которого начинается с указанного символа
+        /*
+         * prevNode - предыдущий брат найденного узла или узла, перед которым
+         * нужно вставить новый (nullptr - если это первый дочерний элемент)
+         */
+        static node_type*   intFindBrother(node_type* firstNode, TCharType keyChar, node_type*& prevNode);
+
+        // Получить длину общей части цепочки узла и ключа, начиная с указанной позиции
+        static size_t       intGetCommonLength(const node_type* node, const TCharType* key, size_t keyLength, size_t keyPos);
+
+        // Вставить узел в цепочку братьев после prevNode (или первым дочерним элементом parentNode)
+        static void         intLinkNode(node_type* parentNode, node_type* prevNode, node_type* node);
+
+        // Заменить в цепочке братьев oldNode на newNode
+        static void         intReplaceNode(node_type* parentNode, node_type* prevNode, node_type* oldNode, node_type* newNode);
+
+        // Объединить узел без значения с его единственным дочерним элементом
+        void                intMergeWithChild(node_type* node);
+
+        // Получить узел для ключа (nullptr - если ключ не заканчивается на границе узла)
+        const node_type*    intFindNode(const TCharType* key, size_t keyLength) const;
+
+        // Разрушение всех узлов дерева
+        void                intDestroyNodes();
+
+    private:
+
+        // Собственная арена дерева (при размещении узлов в арене)
+        std::unique_ptr<TrieArena>  m_ownArena;
+
+        // Ресурс памяти, в котором размещаются узлы дерева
+        std::pmr::memory_resource*  m_resource = nullptr;
+
+        // Корень цифрового дерева
+        node_type*                  m_rootNode = nullptr;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Итератор цифрового дерева со сжатыми путями
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    class RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator
+    {
+        friend class RadixTrie<TCharType, TValueType, KeyCharLess>;
+
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = const node_type*;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const node_type*;
+        using reference         = const node_type*;
+
+        using string_type       = TrieStrings::StringOfCharsZeroEnd<TCharType>;
+
+        const_iterator() noexcept;
+
+        bool                operator==  (const const_iterator& other) const;
+        bool                operator!=  (const const_iterator& other) const;
+        const node_type*    operator->  ()                            const;
+        const node_type*    operator*   ()                            const;
+
+        const_iterator&     operator++  ();
+
+        // Получение полного ключа, которому соответствует узел
+        const string_type&  getString() const;
+
+    private:
+
+        // Перейти к следующему узлу в порядке обхода
+        /*
+         * bToChild - признак захода в дочерние элементы текущего узла
+         */
+        void                intStep(bool bToChild);
+
+        // Перейти к ближайшему узлу со значением, начиная с текущего
+        void                intSeekValue();
+
+    private:
+
+        std::vector<const node_type*>   m_path;     // Путь от корня к текущему узлу (без корня)
+        mutable string_type             m_string;   // Ключ, которому соответствует узел
+        mutable bool                    m_bStringActual = false;
+    };
+
+}   // namespace Trie
+
+// Имплементация методов узла дерева со сжатыми путями
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename RadixNode<TCharType, TValueType, KeyCharLess>::node_type*
+    RadixNode<TCharType, TValueType, KeyCharLess>::create(
+        std::pmr::memory_resource* resource, const TCharType* label, size_t labelLength)
+    {
+        void* memory = resource->allocate(sizeof(node_type), alignof(node_type));
+        return new (memory) node_type(resource, label, labelLength);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    RadixNode<TCharType, TValueType, KeyCharLess>::destroy(std::pmr::memory_resource* resource, node_type* node)
+    {
+        // Разрушение узла, его дочерних элементов и следующих братьев без рекурсии
+        while (node)
+        {
+            if (node_type* child = node->m_pChild)
+            {
+                node->m_pChild = child->m_pNext;
+                child->m_pNext = node;
+                node = child;
+            }
+            else
+            {
+                node_type* next = node->m_pNext;
+
+                node->~RadixNode();
+                resource->deallocate(node, sizeof(node_type), alignof(node_type));
+
+                node = next;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    RadixNode<TCharType, TValueType, KeyCharLess>::RadixNode(
+        std::pmr::memory_resource* resource, const TCharType* label, size_t labelLength)
+        : m_label (label, labelLength, resource)
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    const typename RadixNode<TCharType, TValueType, KeyCharLess>::label_type&
+    RadixNode<TCharType, TValueType, KeyCharLess>::getLabel() const
+    {
+        return m_label;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    typename RadixNode<TCharType, TValueType, KeyCharLess>::label_type&
+    RadixNode<TCharType, TValueType, KeyCharLess>::getLabel()
+    {
+        return m_label;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    bool
+    RadixNode<TCharType, TValueType, KeyCharLess>::haveValue() const
+    {
+        return m_bHaveValue;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    RadixNode<TCharType, TValueType, KeyCharLess>::setValue(TValueType value)
+    {
+        m_value = std::move(value);
+        m_bHaveValue = true;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    RadixNode<TCharType, TValueType, KeyCharLess>::resetValue()
+    {
+        m_value = TValueType();
+        m_bHaveValue = false;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    const TValueType&
+    RadixNode<TCharType, TValueType, KeyCharLess>::getValue() const
+    {
+        return m_value;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    RadixNode<TCharType, TValueType, KeyCharLess>::setNext(node_type* next)
+    {
+        m_pNext = next;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    typename RadixNode<TCharType, TValueType, KeyCharLess>::node_type*
+    RadixNode<TCharType, TValueType, KeyCharLess>::getNext() const
+    {
+        return m_pNext;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    RadixNode<TCharType, TValueType, KeyCharLess>::setChild(node_type* child)
+    {
+        m_pChild = child;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    typename RadixNode<TCharType, TValueType, KeyCharLess>::node_type*
+    RadixNode<TCharType, TValueType, KeyCharLess>::getChild() const
+    {
+        return m_pChild;
+    }
+
+}   // namespace Trie (Имплементация методов узла дерева со сжатыми путями)
+
+// Имплементация методов дерева со сжатыми путями
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    RadixTrie<TCharType, TValueType, KeyCharLess>::RadixTrie(NodesAllocation allocation)
+    {
+        if (NodesAllocation::Arena == allocation)
+        {
+            m_ownArena.reset(new TrieArena());
+            m_resource = m_ownArena.get();
+        }
+        else
+        {
+            m_resource = std::pmr::new_delete_resource();
+        }
+
+        m_rootNode = node_type::create(m_resource, nullptr, 0);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    RadixTrie<TCharType, TValueType, KeyCharLess>::RadixTrie(std::pmr::memory_resource* resource)
+        : m_resource (resource ? resource : std::pmr::new_delete_resource())
+    {
+        m_rootNode = node_type::create(m_resource, nullptr, 0);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    RadixTrie<TCharType, TValueType, KeyCharLess>::~RadixTrie()
+    {
+        intDestroyNodes();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename RadixTrie<TCharType, TValueType, KeyCharLess>::node_type*
+    RadixTrie<TCharType, TValueType, KeyCharLess>::addKeyValue(const string_type& key, TValueType value)
+    {
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        assert(keyLength > 0);
+        if (0 == keyLength)
+            return nullptr;
+
+        node_type* parentNode = m_rootNode;
+        size_t     keyPos     = 0;
+
+        while (true)
+        {
+            node_type* prevNode = nullptr;
+            node_type* node = intFindBrother(parentNode->getChild(), keyBuf[keyPos], prevNode);
+
+            // Подходящего ребра нет - добавим лист с оставшейся частью ключа
+            if (!node)
+            {
+                node_type* leafNode = node_type::create(m_resource, keyBuf + keyPos, keyLength - keyPos);
+                leafNode->setValue(std::move(value));
+                intLinkNode(parentNode, prevNode, leafNode);
+
+                return leafNode;
+            }
+
+            const size_t labelLength  = node->getLabel().length();
+            const size_t commonLength = intGetCommonLength(node, keyBuf, keyLength, keyPos);
+
+            // Ребро пройдено целиком
+            if (commonLength == labelLength)
+            {
+                keyPos += commonLength;
+                if (keyPos == keyLength)
+                {
+                    node->setValue(std::move(value));
+                    return node;
+                }
+
+                parentNode = node;
+                continue;
+            }
+
+            // Ключ расходится с ребром или заканчивается внутри него - разделим ребро
+            node_type* splitNode = node_type::create(m_resource, node->getLabel().data(), commonLength);
+            node->getLabel().erase(0, commonLength);
+
+            intReplaceNode(parentNode, prevNode, node, splitNode);
+            node->setNext(nullptr);
+            splitNode->setChild(node);
+
+            keyPos += commonLength;
+            if (keyPos == keyLength)
+            {
+                splitNode->setValue(std::move(value));
+                return splitNode;
+            }
+
+            node_type* leafNode = node_type::create(m_resource, keyBuf + keyPos, keyLength - keyPos);
+            leafNode->setValue(std::move(value));
+
+            if (is_key_less<KeyCharLess>(keyBuf[keyPos], node->getLabel()[0]))
+                intLinkNode(splitNode, nullptr, leafNode);
+            else
+                intLinkNode(splitNode, node, leafNode);
+
+            return leafNode;
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    RadixTrie<TCharType, TValueType, KeyCharLess>::removeKey(const string_type& key)
+    {
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        if (0 == keyLength)
+        {
+            // Разрушим старое дерево и создадим новое дерево
+            intDestroyNodes();
+            m_rootNode = node_type::create(m_resource, nullptr, 0);
+            return true;
+        }
+
+        node_type* parentNode = m_rootNode;
+        size_t     keyPos     = 0;
+
+        while (true)
+        {
+            node_type* prevNode = nullptr;
+            node_type* node = intFindBrother(parentNode->getChild(), keyBuf[keyPos], prevNode);
+            if (!node)
+                return false;
+
+            const size_t labelLength  = node->getLabel().length();
+            const size_t commonLength = intGetCommonLength(node, keyBuf, keyLength, keyPos);
+
+            // Ключ заканчивается на ребре или в его конце - удаляется все поддерево узла
+            if (keyPos + commonLength == keyLength)
+            {
+                intReplaceNode(parentNode, prevNode, node, node->getNext());
+                node->setNext(nullptr);
+                node_type::destroy(m_resource, node);
+
+                // Восстановим сжатие цепочки родителя
+                if (parentNode != m_rootNode && !parentNode->haveValue())
+                    intMergeWithChild(parentNode);
+
+                return true;
+            }
+
+            // Ключ расходится с ребром - таких ключей нет
+            if (commonLength < labelLength)
+                return false;
+
+            keyPos += commonLength;
+            parentNode = node;
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    RadixTrie<TCharType, TValueType, KeyCharLess>::find(const string_type& key) const
+    {
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        const_iterator_type it;
+        if (0 == keyLength)
+            return it;
+
+        const node_type* parentNode = m_rootNode;
+        size_t           keyPos     = 0;
+
+        while (keyPos < keyLength)
+        {
+            node_type* prevNode = nullptr;
+            const node_type* node = intFindBrother(parentNode->getChild(), keyBuf[keyPos], prevNode);
+            if (!node)
+                return const_iterator_type();
+
+            const size_t labelLength = node->getLabel().length();
+            if (intGetCommonLength(node, keyBuf, keyLength, keyPos) != labelLength)
+                return const_iterator_type();
+
+            it.m_path.push_back(node);
+
+            keyPos += labelLength;
+            parentNode = node;
+        }
+
+        if (!parentNode->haveValue())
+            return const_iterator_type();
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    RadixTrie<TCharType, TValueType, KeyCharLess>::contains(const string_type& key) const
+    {
+        return nullptr != get(key);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const TValueType*
+    RadixTrie<TCharType, TValueType, KeyCharLess>::get(const string_type& key) const
+    {
+        const node_type* node = intFindNode(key.getStr(), key.length());
+
+        return node && node->haveValue() ? &node->getValue() : nullptr;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    RadixTrie<TCharType, TValueType, KeyCharLess>::lower_bound(const string_type& key) const
+    {
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        const_iterator_type it;
+
+        const node_type* parentNode = m_rootNode;
+        size_t           keyPos     = 0;
+
+        while (keyPos < keyLength)
+        {
+            // Найдем первое ребро, начинающееся с символа, большего или равного символу ключа
+            const node_type* node = parentNode->getChild();
+            while (node && is_key_less<KeyCharLess>(node->getLabel()[0], keyBuf[keyPos]))
+                node = node->getNext();
+
+            if (!node)
+            {
+                // Все ключи поддерева меньше искомого - переходим за поддерево
+                if (it.m_path.empty())
+                    return cend();
+
+                it.intStep(false);
+                it.intSeekValue();
+                return it;
+            }
+
+            it.m_path.push_back(node);
+
+            const size_t labelLength  = node->getLabel().length();
+            const size_t commonLength = intGetCommonLength(node, keyBuf, keyLength, keyPos);
+
+            if (commonLength == labelLength)
+            {
+                keyPos += labelLength;
+                parentNode = node;
+                continue;
+            }
+
+            // Ключ закончился внутри ребра или символ ребра больше символа ключа -
+            // все ключи поддерева больше искомого
+            if (keyPos + commonLength == keyLength
+                || is_key_less<KeyCharLess>(keyBuf[keyPos + commonLength], node->getLabel()[commonLength]))
+            {
+                break;
+            }
+
+            // Все ключи поддерева меньше искомого
+            it.intStep(false);
+            it.intSeekValue();
+            return it;
+        }
+
+        if (it.m_path.empty())
+            return cbegin();
+
+        it.m_bStringActual = false;
+        it.intSeekValue();
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    RadixTrie<TCharType, TValueType, KeyCharLess>::begin() const
+    {
+        return cbegin();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    RadixTrie<TCharType, TValueType, KeyCharLess>::end() const
+    {
+        return cend();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    RadixTrie<TCharType, TValueType, KeyCharLess>::cbegin() const
+    {
+        const_iterator_type it;
+
+        if (const node_type* firstChild = m_rootNode->getChild())
+        {
+            it.m_path.push_back(firstChild);
+            it.intSeekValue();
+        }
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    RadixTrie<TCharType, TValueType, KeyCharLess>::cend() const
+    {
+        return const_iterator_type();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    size_t
+    RadixTrie<TCharType, TValueType, KeyCharLess>::getNodesCount() const
+    {
+        size_t nodesCount = 0;
+
+        std::vector<const node_type*> stack;
+        if (const node_type* firstChild = m_rootNode->getChild())
+            stack.push_back(firstChild);
+
+        while (!stack.empty())
+        {
+            const node_type* node = stack.back();
+            stack.pop_back();
+
+            for (; node; node = node->getNext())
+            {
+                ++nodesCount;
+
+                if (const node_type* child = node->getChild())
+                    stack.push_back(child);
+            }
+        }
+
+        return nodesCount;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename RadixTrie<TCharType, TValueType, KeyCharLess>::node_type*
+    RadixTrie<TCharType, TValueType, KeyCharLess>::intFindBrother(
+        node_type* firstNode, TCharType keyChar, node_type*& prevNode)
+    {
+        prevNode = nullptr;
+
+        node_type* node = firstNode;
+        while (node && is_key_less<KeyCharLess>(node->getLabel()[0], keyChar))
+        {
+            prevNode = node;
+            node = node->getNext();
+        }
+
+        if (node && is_key_eq<KeyCharLess>(node->getLabel()[0], keyChar))
+            return node;
+
+        return nullptr;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    size_t
+    RadixTrie<TCharType, TValueType, KeyCharLess>::intGetCommonLength(
+        const node_type* node, const TCharType* key, size_t keyLength, size_t keyPos)
+    {
+        const auto&  label       = node->getLabel();
+        const size_t maxLength   = std::min(label.length(), keyLength - keyPos);
+
+        size_t commonLength = 0;
+        while (commonLength < maxLength && is_key_eq<KeyCharLess>(label[commonLength], key[keyPos + commonLength]))
+            ++commonLength;
+
+        return commonLength;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    RadixTrie<TCharType, TValueType, KeyCharLess>::intLinkNode(
+        node_type* parentNode, node_type* prevNode, node_type* node)
+    {
+        if (prevNode)
+        {
+            node->setNext(prevNode->getNext());
+            prevNode->setNext(node);
+        }
+        else
+        {
+            node->setNext(parentNode->getChild());
+            parentNode->setChild(node);
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    RadixTrie<TCharType, TValueType, KeyCharLess>::intReplaceNode(
+        node_type* parentNode, node_type* prevNode, node_type* oldNode, node_type* newNode)
+    {
+        if (newNode && newNode != oldNode->getNext())
+            newNode->setNext(oldNode->getNext());
+
+        if (prevNode)
+            prevNode->setNext(newNode);
+        else
+            parentNode->setChild(newNode);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    RadixTrie<TCharType, TValueType, KeyCharLess>::intMergeWithChild(node_type* node)
+    {
+        node_type* child = node->getChild();
+        if (!child || child->getNext())
+            return;
+
+        // Узел без значения с единственным дочерним элементом поглощает его
+        node->getLabel().append(child->getLabel());
+        if (child->haveValue())
+            node->setValue(child->getValue());
+        node->setChild(child->getChild());
+
+        child->setChild(nullptr);
+        node_type::destroy(m_resource, child);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename RadixTrie<TCharType, TValueType, KeyCharLess>::node_type*
+    RadixTrie<TCharType, TValueType, KeyCharLess>::intFindNode(const TCharType* key, size_t keyLength) const
+    {
+        if (0 == keyLength)
+            return nullptr;
+
+        node_type* parentNode = m_rootNode;
+        size_t     keyPos     = 0;
+
+        while (keyPos < keyLength)
+        {
+            node_type* prevNode = nullptr;
+            node_type* node = intFindBrother(parentNode->getChild(), key[keyPos], prevNode);
+            if (!node)
+                return nullptr;
+
+            const size_t labelLength = node->getLabel().length();
+            if (intGetCommonLength(node, key, keyLength, keyPos) != labelLength)
+                return nullptr;
+
+            keyPos += labelLength;
+            parentNode = node;
+        }
+
+        return parentNode;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    RadixTrie<TCharType, TValueType, KeyCharLess>::intDestroyNodes()
+    {
+        // Цепочки символов размещены в том же ресурсе, поэтому освобождать арену
+        // целиком можно только для значений без деструкторов
+        if (m_ownArena && std::is_trivially_destructible<TValueType>::value)
+        {
+            m_ownArena->release();
+        }
+        else
+        {
+            node_type::destroy(m_resource, m_rootNode);
+
+            if (m_ownArena)
+                m_ownArena->release();
+        }
+
+        m_rootNode = nullptr;
+    }
+
+}   // namespace Trie (Имплементация методов дерева со сжатыми путями)
+
+// Имплементация итератора дерева со сжатыми путями
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator::const_iterator() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator==(
+        const const_iterator& other) const
+    {
+        if (m_path.empty() || other.m_path.empty())
+            return m_path.empty() && other.m_path.empty();
+
+        return m_path.back() == other.m_path.back();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator!=(
+        const const_iterator& other) const
+    {
+        return !operator==(other);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename RadixTrie<TCharType, TValueType, KeyCharLess>::node_type*
+    RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator->() const
+    {
+        return m_path.back();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename RadixTrie<TCharType, TValueType, KeyCharLess>::node_type*
+    RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator*() const
+    {
+        return m_path.back();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator&
+    RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator++()
+    {
+        if (!m_path.empty())
+        {
+            intStep(true);
+            intSeekValue();
+        }
+
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator::string_type&
+    RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator::getString() const
+    {
+        if (!m_bStringActual)
+        {
+            std::basic_string<TCharType> key;
+            for (const node_type* node : m_path)
+            {
+                key.append(node->getLabel().data(), node->getLabel().length());
+            }
+
+            m_string.assign(key.data(), key.length());
+            m_bStringActual = true;
+        }
+
+        return m_string;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator::intStep(bool bToChild)
+    {
+        m_bStringActual = false;
+
+        if (bToChild)
+        {
+            if (const node_type* child = m_path.back()->getChild())
+            {
+                m_path.push_back(child);
+                return;
+            }
+        }
+
+        // Переходим к следующему брату текущего узла или ближайшего из предков
+        while (!m_path.empty())
+        {
+            const node_type* next = m_path.back()->getNext();
+            m_path.pop_back();
+
+            if (next)
+            {
+                m_path.push_back(next);
+                break;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    RadixTrie<TCharType, TValueType, KeyCharLess>::const_iterator::intSeekValue()
+    {
+        while (!m_path.empty() && !m_path.back()->haveValue())
+        {
+            intStep(true);
+        }
+    }
+
+}   // namespace Trie (Имплементация итератора дерева со сжатыми путями)
@@ -0,0 +1,566 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+
+#include "TrieData.h"
+
+namespace Trie
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Цифровое дерево, разделенное на сегменты по первому символу ключа
+    /*
+     * Ключи распределяются по N независимым деревьям (сегментам) по диапазонам
+     * первого символа: границы диапазонов упорядочены KeyCharLess, поэтому
+     * все ключи сегмента меньше ключей следующего сегмента.
+     *
+     * У каждого сегмента свой мьютекс писателя и своя арена (при размещении
+     * узлов в арене): писатели разных сегментов не конкурируют между собой.
+     * Сегменты работают в режиме одновременного чтения (Trie::enableConcurrentReads),
+     * поэтому contains/try_get не блокируются писателями.
+     *
+     * Обход (begin, find, lower_bound) выполняется по сегментам в порядке ключей.
+     * При одновременной записи итераторы используются только под защитой ReadGuard.
+     */
+    template<typename TCharType, typename TValueType, typename KeyCharLess = compare_no_case>
+    class ShardedTrie
+    {
+    public:
+
+        using this_type     = ShardedTrie<TCharType, TValueType, KeyCharLess>;
+        using string_type   = TrieStrings::StringOfChars<TCharType>;
+        using trie_type     = Trie<TCharType, TValueType, KeyCharLess>;
+        using node_type     = typename trie_type::node_type;
+        using key_traits    = key_char_traits<TCharType, KeyCharLess>;
+
+        class const_iterator;
+        class ReadGuard;
+
+        using const_iterator_type = const_iterator;
+
+        // Создание дерева с указанным количеством сегментов
+        /**
+         * Границы сегментов равномерно делят алфавит из цифр, латинских
+         * и кириллических букв.
+         *
+         * @param   shardsCount - количество сегментов (0 - по количеству ядер процессора)
+         * @param   allocation - способ размещения узлов сегментов
+         */
+        explicit ShardedTrie(size_t shardsCount = 0, NodesAllocation allocation = NodesAllocation::Heap);
+
+        // Создание дерева с указанными границами сегментов
+        /**
+         * Сегмент i содержит ключи, первый символ которых не меньше boundaries[i - 1]
+         * и меньше boundaries[i]. Количество сегментов на единицу больше количества границ.
+         *
+         * @param   boundaries - первые символы сегментов, начиная со второго
+         * @param   allocation - способ размещения узлов сегментов
+         */
+        ShardedTrie(const std::vector<TCharType>& boundaries, NodesAllocation allocation = NodesAllocation::Heap);
+
+        ShardedTrie(const ShardedTrie&) = delete;
+        ShardedTrie& operator=(const ShardedTrie&) = delete;
+
+        // Добавление пары ключ/значение
+        /**
+         * Если ключ найден, то заменяем значение на новое.
+         * Блокируется только сегмент ключа.
+         *
+         * @param   key - ключ (не пустой)
+         * @param   value - значение
+         */
+        void                addKeyValue(const string_type& key, TValueType value);
+
+        // Удаление заданного ключа (слова) из дерева
+        /**
+         * Удаляется ключ, значение (если есть) и все другие пары
+         * ключ/значение, у которых ключ начинается с указанного.
+         * Пустой ключ удаляет все пары всех сегментов.
+         *
+         * @param   key - ключ для удаляемого элемента
+         * @return  true - если элемент по ключу был найден и удален, false - иначе
+         */
+        bool                removeKey(const string_type& key);
+
+        // Проверка наличия значения для заданного ключа (слова)
+        /**
+         * Выполняется без блокировок.
+         */
+        bool                contains(const string_type& key) const;
+
+        // Получение значения для заданного ключа (слова)
+        /**
+         * Выполняется без блокировок. Значение копируется под защитой эпохи сегмента.
+         *
+         * @param   key - искомый ключ
+         * @param   value - значение, связанное с ключом (заполняется, только если ключ найден)
+         * @return  true - если ключ найден и с ним связано значение, false - иначе
+         */
+        bool                try_get(const string_type& key, TValueType& value) const;
+
+        // Поиск заданного ключа (слова) в дереве
+        /**
+         * @return  итератор для найденого узла по ключу.
+         *          Если не найдено, то будет возвращено cend()
+         */
+        const_iterator_type find(const string_type& key) const;
+
+        // Поиск элемента, ключ которого больше или равен указанному
+        /**
+         * Поиск выполняется в сегменте ключа и продолжается в следующих сегментах.
+         *
+         * @param key - ключ
+         * @return итератор для элемента, ключ которого больше
+         *         или равен указанному ключу.
+         *         Если подходящих элементов не найдено, будет
+         *         возвращен итератор cend()
+         */
+        const_iterator_type lower_bound(const string_type& key) const;
+
+        const_iterator_type begin()  const;
+        const_iterator_type end()    const;
+        const_iterator_type cbegin() const;
+        const_iterator_type cend()   const;
+
+        // Получить количество сегментов
+        size_t              getShardsCount() const;
+
+        // Получить номер сегмента для ключа
+        size_t              getShardIndex(const string_type& key) const;
+
+        // Получить дерево сегмента
+        /**
+         * Изменять дерево сегмента можно только при отсутствии других писателей.
+         */
+        trie_type&          getShard(size_t shardIndex);
+        const trie_type&    getShard(size_t shardIndex) const;
+
+    private:
+
+        // Сегмент дерева (в отдельных строках кэша)
+        struct alignas(64) Shard
+        {
+            explicit Shard(NodesAllocation allocation)
+                : trie(allocation)
+            {
+                trie.enableConcurrentReads();
+            }
+
+            std::mutex  writeMutex;     // Мьютекс писателя
+            trie_type   trie;           // Дерево сегмента
+        };
+
+        // Получить границы сегментов по умолчанию
+        static std::vector<TCharType>   intGetDefaultBoundaries(size_t shardsCount);
+
+        // Создание сегментов
+        void                intCreateShards(NodesAllocation allocation);
+
+        // Получить номер сегмента для первого символа ключа
+        size_t              intGetShardIndex(TCharType keyChar) const;
+
+    private:
+
+        std::vector<TCharType>              m_boundaries;   // Приведенные первые символы сегментов (без первого)
+        std::vector<std::unique_ptr<Shard>> m_shards;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Защита читателя всех сегментов
+    /*
+     * Пока объект существует, узлы, доступные итераторам, не освобождаются
+     * писателями. Объект создается одним потоком-читателем на время обхода.
+     */
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    class ShardedTrie<TCharType, TValueType, KeyCharLess>::ReadGuard
+    {
+    public:
+
+        explicit ReadGuard(const ShardedTrie& trie);
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+
+        std::vector<std::unique_ptr<EpochManager::Guard>> m_guards;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Итератор дерева, разделенного на сегменты
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    class ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator
+    {
+        friend class ShardedTrie<TCharType, TValueType, KeyCharLess>;
+
+    public:
+
+        using shard_iterator    = typename trie_type::const_iterator_type;
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = node_type*;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = node_type*;
+        using reference         = node_type*;
+
+        using string_type       = typename shard_iterator::string_type;
+
+        const_iterator() noexcept;
+
+        bool                operator==  (const const_iterator& other) const;
+        bool                operator!=  (const const_iterator& other) const;
+        node_type*          operator->  ()                            const;
+        node_type*          operator*   ()                            const;
+
+        const_iterator&     operator++  ();
+
+        // Получение полного ключа, которому соответствует узел
+        const string_type&  getString() const;
+
+    private:
+
+        const_iterator(const ShardedTrie* trie, size_t shardIndex, const shard_iterator& shardIt);
+
+        // Перейти к первому элементу ближайшего непустого сегмента, если текущий сегмент пройден
+        void                intSkipEmptyShards();
+
+    private:
+
+        const ShardedTrie*  m_trie       = nullptr;
+        size_t              m_shardIndex = 0;           // Номер сегмента (m_trie->getShardsCount() - конец обхода)
+        shard_iterator      m_shardIt;                  // Итератор в дереве сегмента
+    };
+
+}   // namespace Trie
+
+// Имплементация методов дерева, разделенного на сегменты
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::ShardedTrie(size_t shardsCount, NodesAllocation allocation)
+        : m_boundaries (intGetDefaultBoundaries(shardsCount ? shardsCount : (std::max)(1u, std::thread::hardware_concurrency())))
+    {
+        intCreateShards(allocation);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::ShardedTrie(const std::vector<TCharType>& boundaries, NodesAllocation allocation)
+    {
+        for (TCharType boundary : boundaries)
+            m_boundaries.push_back(key_traits::fold(boundary));
+
+        std::sort(m_boundaries.begin(), m_boundaries.end(), key_traits::less);
+        m_boundaries.erase(std::unique(m_boundaries.begin(), m_boundaries.end(), key_traits::eq), m_boundaries.end());
+
+        intCreateShards(allocation);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::addKeyValue(const string_type& key, TValueType value)
+    {
+        assert(key.length() > 0);
+        if (0 == key.length())
+            return;
+
+        Shard& shard = *m_shards[intGetShardIndex(key.getStr()[0])];
+
+        std::lock_guard<std::mutex> lock(shard.writeMutex);
+        shard.trie.addKeyValue(key, std::move(value));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::removeKey(const string_type& key)
+    {
+        if (0 == key.length())
+        {
+            for (auto& shard : m_shards)
+            {
+                std::lock_guard<std::mutex> lock(shard->writeMutex);
+                shard->trie.removeKey(key);
+            }
+            return true;
+        }
+
+        Shard& shard = *m_shards[intGetShardIndex(key.getStr()[0])];
+
+        std::lock_guard<std::mutex> lock(shard.writeMutex);
+        return shard.trie.removeKey(key);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::contains(const string_type& key) const
+    {
+        const trie_type& trie = m_shards[getShardIndex(key)]->trie;
+
+        EpochManager::Guard guard(*trie.getEpochManager());
+        return trie.contains(key);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::try_get(const string_type& key, TValueType& value) const
+    {
+        const trie_type& trie = m_shards[getShardIndex(key)]->trie;
+
+        EpochManager::Guard guard(*trie.getEpochManager());
+        return trie.try_get(key, value);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::find(const string_type& key) const
+    {
+        const size_t shardIndex = getShardIndex(key);
+        const trie_type& trie = m_shards[shardIndex]->trie;
+
+        auto shardIt = trie.find(key);
+        if (shardIt == trie.cend())
+            return cend();
+
+        return const_iterator_type(this, shardIndex, shardIt);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::lower_bound(const string_type& key) const
+    {
+        if (0 == key.length())
+            return cbegin();
+
+        const size_t shardIndex = getShardIndex(key);
+
+        const_iterator_type it(this, shardIndex, m_shards[shardIndex]->trie.lower_bound(key));
+        it.intSkipEmptyShards();
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::begin() const
+    {
+        return cbegin();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::end() const
+    {
+        return cend();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::cbegin() const
+    {
+        const_iterator_type it(this, 0, m_shards.front()->trie.cbegin());
+        it.intSkipEmptyShards();
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::cend() const
+    {
+        return const_iterator_type(this, m_shards.size(), typename const_iterator_type::shard_iterator());
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    size_t
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::getShardsCount() const
+    {
+        return m_shards.size();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    size_t
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::getShardIndex(const string_type& key) const
+    {
+        return key.length() ? intGetShardIndex(key.getStr()[0]) : 0;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename ShardedTrie<TCharType, TValueType, KeyCharLess>::trie_type&
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::getShard(size_t shardIndex)
+    {
+        return m_shards[shardIndex]->trie;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename ShardedTrie<TCharType, TValueType, KeyCharLess>::trie_type&
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::getShard(size_t shardIndex) const
+    {
+        return m_shards[shardIndex]->trie;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    std::vector<TCharType>
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::intGetDefaultBoundaries(size_t shardsCount)
+    {
+        // Алфавит: цифры, латинские и кириллические буквы (CP1251 или Unicode)
+        std::vector<TCharType> alphabet;
+        for (TCharType ch = '0'; ch <= '9'; ++ch)
+            alphabet.push_back(key_traits::fold(ch));
+        for (TCharType ch = 'A'; ch <= 'Z'; ++ch)
+            alphabet.push_back(key_traits::fold(ch));
+        for (TCharType ch = 'a'; ch <= 'z'; ++ch)
+            alphabet.push_back(key_traits::fold(ch));
+
+        const unsigned firstCyrillic = sizeof(TCharType) == 1 ? 0xC0 : 0x0410;
+        for (unsigned cyrillicIndex = 0; cyrillicIndex < 64; ++cyrillicIndex)
+            alphabet.push_back(key_traits::fold(static_cast<TCharType>(firstCyrillic + cyrillicIndex)));
+
+        std::sort(alphabet.begin(), alphabet.end(), key_traits::less);
+        alphabet.erase(std::unique(alphabet.begin(), alphabet.end(), key_traits::eq), alphabet.end());
+
+        // Сегменты получают поровну символов алфавита
+        shardsCount = (std::min)(shardsCount, alphabet.size());
+
+        std::vector<TCharType> boundaries;
+        for (size_t shardIndex = 1; shardIndex < shardsCount; ++shardIndex)
+            boundaries.push_back(alphabet[shardIndex * alphabet.size() / shardsCount]);
+
+        return boundaries;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::intCreateShards(NodesAllocation allocation)
+    {
+        for (size_t shardIndex = 0; shardIndex <= m_boundaries.size(); ++shardIndex)
+            m_shards.emplace_back(new Shard(allocation));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    size_t
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::intGetShardIndex(TCharType keyChar) const
+    {
+        // Номер сегмента - количество границ, не больших символа
+        return std::upper_bound(m_boundaries.begin(), m_boundaries.end(), key_traits::fold(keyChar), key_traits::less)
+               - m_boundaries.begin();
+    }
+
+}   // namespace Trie (Имплементация методов дерева, разделенного на сегменты)
+
+// Имплементация методов защиты читателя и итератора дерева, разделенного на сегменты
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::ReadGuard::ReadGuard(const ShardedTrie& trie)
+    {
+        m_guards.reserve(trie.getShardsCount());
+        for (size_t shardIndex = 0; shardIndex < trie.getShardsCount(); ++shardIndex)
+            m_guards.emplace_back(new EpochManager::Guard(*trie.getShard(shardIndex).getEpochManager()));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator::const_iterator() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator::const_iterator(
+        const ShardedTrie* trie, size_t shardIndex, const shard_iterator& shardIt)
+        : m_trie       (trie),
+          m_shardIndex (shardIndex),
+          m_shardIt    (shardIt)
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator==(const const_iterator& other) const
+    {
+        return m_shardIndex == other.m_shardIndex && m_shardIt == other.m_shardIt;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator!=(const const_iterator& other) const
+    {
+        return !(*this == other);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename ShardedTrie<TCharType, TValueType, KeyCharLess>::node_type*
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator->() const
+    {
+        return *m_shardIt;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename ShardedTrie<TCharType, TValueType, KeyCharLess>::node_type*
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator*() const
+    {
+        return *m_shardIt;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator&
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator::operator++()
+    {
+        ++m_shardIt;
+        intSkipEmptyShards();
+
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator::string_type&
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator::getString() const
+    {
+        return m_shardIt.getString();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    ShardedTrie<TCharType, TValueType, KeyCharLess>::const_iterator::intSkipEmptyShards()
+    {
+        const size_t shardsCount = m_trie->getShardsCount();
+
+        while (m_shardIndex < shardsCount && m_shardIt == m_trie->getShard(m_shardIndex).cend())
+        {
+            if (++m_shardIndex < shardsCount)
+                m_shardIt = m_trie->getShard(m_shardIndex).cbegin();
+        }
+
+        if (m_shardIndex == shardsCount)
+            m_shardIt = shard_iterator();
+    }
+
+}   // namespace Trie (Имплементация методов защиты читателя и итератора дерева, разделенного на сегменты)
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <memory_resource>
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+namespace Trie
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Арена (слэб-аллокатор) для размещения узлов цифрового дерева
+    /*
+     * Память запрашивается у вышестоящего ресурса крупными блоками (слэбами),
+     * внутри которых узлы размещаются подряд.
+     * Освобожденные узлы попадают в список свободных блоков своего размера
+     * и переиспользуются при следующих выделениях.
+     * Крупные блоки (и блоки с особым выравниванием) занимают отдельные слэбы,
+     * которые при освобождении блока сразу возвращаются вышестоящему ресурсу.
+     * Остальные слэбы освобождаются разом методом release() или при разрушении арены.
+     */
+    class TrieArena : public std::pmr::memory_resource
+    {
+    public:
+
+        // Размер слэба по умолчанию
+        static constexpr size_t default_slab_size = 64 * 1024;
+
+        explicit TrieArena(size_t slabSize = default_slab_size,
+                           std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+        TrieArena(const TrieArena&) = delete;
+        TrieArena& operator=(const TrieArena&) = delete;
+        virtual ~TrieArena();
+
+        // Освободить все слэбы разом
+        /**
+         * Все блоки, выделенные ареной, становятся недействительными.
+         * Деструкторы размещенных в арене объектов не вызываются.
+         */
+        void                release() noexcept;
+
+        // Получить объем памяти, полученной у вышестоящего ресурса и еще не возвращенной
+        size_t              getAllocatedSize() const noexcept;
+
+        // Принять слэбы другой арены
+        /**
+         * Блоки, выделенные другой ареной, остаются действительными и далее
+         * освобождаются этой ареной. Другая арена становится пустой.
+         * Вышестоящие ресурсы арен должны совпадать.
+         *
+         * @param   other - арена, слэбы которой передаются
+         */
+        void                adopt(TrieArena& other);
+
+    protected:
+
+        virtual void*       do_allocate(size_t bytes, size_t alignment) override;
+        virtual void        do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        virtual bool        do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+
+        // Элемент списка свободных блоков
+        struct FreeBlock
+        {
+            FreeBlock* pNext;
+        };
+
+        // Слэб, полученный у вышестоящего ресурса
+        struct Slab
+        {
+            void*  pData;
+            size_t size;
+            size_t alignment;       // Выравнивание, с которым слэб запрошен (и освобождается)
+        };
+
+        // Гранулярность размеров блоков в списках свободных блоков
+        static constexpr size_t block_granularity = alignof(std::max_align_t);
+
+        // Максимальный размер блока, обслуживаемого списками свободных блоков
+        /*
+         * Покрывает крупные узлы AdaptiveTrie (Node48, Node256), которые
+         * заменяются при росте и сжатии узлов.
+         */
+        static constexpr size_t max_pooled_block_size = 4096;
+
+        // Получить индекс списка свободных блоков для указанного размера
+        static size_t       intGetFreeListIndex(size_t bytes) noexcept;
+
+        // Выделить память в новом слэбе
+        void*               intAllocateSlab(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        // Вернуть вышестоящему ресурсу отдельный слэб крупного блока
+        void                intReleaseSlab(void* p, size_t size);
+
+    private:
+
+        size_t                          m_slabSize;
+        std::pmr::memory_resource*      m_upstream;
+        std::vector<Slab>               m_slabs;
+        char*                           m_pCurrent = nullptr;
+        char*                           m_pEnd     = nullptr;
+        size_t                          m_allocatedSize = 0;
+        FreeBlock*                      m_freeLists[max_pooled_block_size / block_granularity] = {};
+    };
+
+}   // namespace Trie
+
+// Имплементация методов арены
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    inline
+    TrieArena::TrieArena(size_t slabSize, std::pmr::memory_resource* upstream)
+        : m_slabSize (slabSize < max_pooled_block_size ? max_pooled_block_size : slabSize),
+          m_upstream (upstream)
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    TrieArena::~TrieArena()
+    {
+        release();
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    void
+    TrieArena::release() noexcept
+    {
+        for (const Slab& slab : m_slabs)
+        {
+            m_upstream->deallocate(slab.pData, slab.size, slab.alignment);
+        }
+        m_slabs.clear();
+
+        m_pCurrent = nullptr;
+        m_pEnd     = nullptr;
+        m_allocatedSize = 0;
+
+        for (FreeBlock*& freeList : m_freeLists)
+        {
+            freeList = nullptr;
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    TrieArena::getAllocatedSize() const noexcept
+    {
+        return m_allocatedSize;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    void
+    TrieArena::adopt(TrieArena& other)
+    {
+        assert(&other != this);
+        assert(m_upstream->is_equal(*other.m_upstream));
+
+        m_slabs.insert(m_slabs.end(), other.m_slabs.begin(), other.m_slabs.end());
+        m_allocatedSize += other.m_allocatedSize;
+
+        // Остаток текущего слэба и свободные блоки другой арены не переиспользуются
+        other.m_slabs.clear();
+        other.m_pCurrent = nullptr;
+        other.m_pEnd     = nullptr;
+        other.m_allocatedSize = 0;
+
+        for (FreeBlock*& freeList : other.m_freeLists)
+        {
+            freeList = nullptr;
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    void*
+    TrieArena::do_allocate(size_t bytes, size_t alignment)
+    {
+        // Крупные блоки и блоки с особым выравниванием размещаются в отдельных слэбах
+        if (bytes > max_pooled_block_size || alignment > block_granularity)
+        {
+            return intAllocateSlab(bytes, alignment);
+        }
+
+        const size_t freeListIndex = intGetFreeListIndex(bytes);
+
+        // Переиспользуем ранее освобожденный блок того же размера
+        if (FreeBlock* block = m_freeLists[freeListIndex])
+        {
+            m_freeLists[freeListIndex] = block->pNext;
+            return block;
+        }
+
+        const size_t blockSize = (freeListIndex + 1) * block_granularity;
+        if (static_cast<size_t>(m_pEnd - m_pCurrent) < blockSize)
+        {
+            m_pCurrent = static_cast<char*>(intAllocateSlab(m_slabSize));
+            m_pEnd     = m_pCurrent + m_slabSize;
+        }
+
+        void* result = m_pCurrent;
+        m_pCurrent += blockSize;
+
+        return result;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    void
+    TrieArena::do_deallocate(void* p, size_t bytes, size_t alignment)
+    {
+        if (!p)
+            return;
+
+        if (bytes > max_pooled_block_size || alignment > block_granularity)
+        {
+            intReleaseSlab(p, bytes);
+            return;
+        }
+
+        const size_t freeListIndex = intGetFreeListIndex(bytes);
+
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        block->pNext = m_freeLists[freeListIndex];
+        m_freeLists[freeListIndex] = block;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    bool
+    TrieArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    TrieArena::intGetFreeListIndex(size_t bytes) noexcept
+    {
+        if (bytes == 0)
+            bytes = 1;
+
+        return (bytes + block_granularity - 1) / block_granularity - 1;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    void*
+    TrieArena::intAllocateSlab(size_t size, size_t alignment)
+    {
+        if (alignment < alignof(std::max_align_t))
+            alignment = alignof(std::max_align_t);
+
+        // Место в списке резервируется заранее (с геометрическим ростом),
+        // чтобы добавление слэба после выделения памяти не выбрасывало исключений
+        if (m_slabs.size() == m_slabs.capacity())
+            m_slabs.reserve(m_slabs.empty() ? 16 : m_slabs.size() * 2);
+
+        void* pData = m_upstream->allocate(size, alignment);
+        m_slabs.push_back({ pData, size, alignment });
+        m_allocatedSize += size;
+
+        return pData;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    void
+    TrieArena::intReleaseSlab(void* p, size_t size)
+    {
+        // Отдельные слэбы обычно выделены последними - поиск с конца списка
+        for (size_t slabIndex = m_slabs.size(); slabIndex > 0; --slabIndex)
+        {
+            Slab& slab = m_slabs[slabIndex - 1];
+            if (slab.pData != p)
+                continue;
+
+            assert(slab.size == size);
+
+            m_upstream->deallocate(slab.pData, slab.size, slab.alignment);
+            m_allocatedSize -= slab.size;
+
+            slab = m_slabs.back();
+            m_slabs.pop_back();
+            return;
+        }
+
+        assert(false && "Блок не выделен этой ареной");
+    }
+
+}   // namespace Trie (Имплементация методов арены)
@@ -0,0 +1,414 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <istream>
+#include <utility>
+#include <algorithm>
+
+#include "TrieData.h"
+
+namespace Trie
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Построитель цифрового дерева по упорядоченным парам ключ/значение
+    /*
+     * Построитель хранит путь к наибольшему ключу дерева (правый путь).
+     * Для очередного ключа, не меньшего предыдущих, общая с правым путем часть
+     * пропускается, а отличающийся суффикс добавляется новыми узлами в конец
+     * цепочек братьев - без поиска среди братьев и без спуска от корня.
+     * Время построения пропорционально суммарной длине ключей.
+     *
+     * Ключ, меньший уже добавленных, добавляется обычным addKeyValue.
+     * Узлы создаются в ресурсе памяти дерева: чтобы строить дерево в арене,
+     * достаточно создать его с NodesAllocation::Arena.
+     *
+     * Суффикс ключа присоединяется к дереву уже заполненным, поэтому построитель
+     * можно использовать как писателя в режиме одновременного чтения.
+     * Пока у дерева есть снимки, ключи добавляются через addKeyValue.
+     *
+     * Между вызовами append дерево можно изменять и напрямую (addKeyValue,
+     * removeKey): такие изменения обнаруживаются по счетчику изменений дерева,
+     * и правый путь перед добавлением очередного ключа строится заново.
+     */
+    template<typename TTrie>
+    class TrieBuilder
+    {
+    public:
+
+        using trie_type     = TTrie;
+        using node_type     = typename trie_type::node_type;
+        using key_traits    = typename node_type::key_traits;
+        using char_type     = std::decay_t<decltype(std::declval<const node_type&>().getKeyChar())>;
+        using value_type    = std::decay_t<decltype(std::declval<const node_type&>().getValue())>;
+        using string_type   = TrieStrings::StringOfChars<char_type>;
+
+        // Создание построителя для дерева
+        /**
+         * Дерево может быть непустым: новые ключи, большие уже имеющихся,
+         * добавляются в конец дерева.
+         *
+         * @param trie - заполняемое дерево (должно существовать все время работы построителя)
+         */
+        explicit TrieBuilder(trie_type& trie);
+
+        TrieBuilder(const TrieBuilder&) = delete;
+        TrieBuilder& operator=(const TrieBuilder&) = delete;
+
+        // Добавление пары ключ/значение
+        /**
+         * Ожидается, что ключи поступают в порядке возрастания.
+         * Если ключ найден, то значение заменяется на новое.
+         *
+         * @param   key - ключ (не пустой)
+         * @param   keyLength - длина ключа
+         * @param   value - значение
+         * @return  указатель на узел, соответствующий ключу
+         */
+        node_type*          append(const char_type* key, size_t keyLength, value_type value);
+        node_type*          append(const string_type& key, value_type value);
+        node_type*          append(const std::basic_string<char_type>& key, value_type value);
+
+        // Добавление пар ключ/значение из диапазона
+        /**
+         * Элементы диапазона - пары (ключ, значение), ключ - std::basic_string
+         * или StringOfChars.
+         *
+         * @return  количество добавленных пар
+         */
+        template<typename InputIterator>
+        size_t              append(InputIterator first, InputIterator last);
+
+        // Добавление пар ключ/значение из потока
+        /**
+         * Поток содержит пары "ключ значение", разделенные пробельными символами.
+         * Чтение прекращается на конце потока или на первой ошибке разбора.
+         *
+         * @return  количество добавленных пар
+         */
+        size_t              append(std::basic_istream<char_type>& stream);
+
+        // Получить количество ключей, поступивших не по порядку
+        size_t              getOutOfOrderCount() const;
+
+    private:
+
+        // Добавление ключа, меньшего ключей правого пути
+        node_type*          intAppendOutOfOrder(const char_type* key, size_t keyLength, value_type value);
+
+        // Добавление ключа через addKeyValue с восстановлением правого пути
+        node_type*          intAppendByTrie(const char_type* key, size_t keyLength, value_type value);
+
+        // Построение правого пути по дереву (последний брат на каждом уровне)
+        void                intLoadPath();
+
+        // Построение правого пути по символам m_pathChars
+        void                intRestorePath();
+
+        // Построение правого пути по символам m_pathChars или по ключу, если он больше
+        void                intRestorePath(const char_type* key, size_t keyLength);
+
+        // Учет нового ключа в количестве ключей корня и первых depth узлов правого пути
+        void                intAddPathSubtreeCount(size_t depth);
+
+        // Учет значения нового ключа в наибольших значениях корня и первых depth узлов правого пути
+        void                intRaisePathSubtreeMaxValue(size_t depth, const value_type& value);
+
+    private:
+
+        trie_type&                  m_trie;
+        node_type*                  m_rootNode;
+        std::pmr::memory_resource*  m_resource;
+
+        std::vector<node_type*>     m_path;         // Правый путь (без корня)
+        std::vector<char_type>      m_pathChars;    // Символы узлов правого пути
+        size_t                      m_modificationCount = 0;    // Счетчик изменений дерева, для которого построен правый путь
+        size_t                      m_outOfOrderCount = 0;
+    };
+
+}   // namespace Trie
+
+// Имплементация методов построителя цифрового дерева
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    TrieBuilder<TTrie>::TrieBuilder(trie_type& trie)
+        : m_trie     (trie),
+          m_rootNode (nullptr),
+          m_resource (trie.getMemoryResource())
+    {
+        intLoadPath();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    typename TrieBuilder<TTrie>::node_type*
+    TrieBuilder<TTrie>::append(const char_type* key, size_t keyLength, value_type value)
+    {
+        assert(keyLength > 0);
+        if (0 == keyLength)
+            return nullptr;
+
+        // Дерево изменено в обход построителя - узлы правого пути могли быть освобождены
+        if (m_modificationCount != m_trie.intGetModificationCount())
+            intLoadPath();
+
+        // Узлы правого пути, разделяемые со снимками, изменяются только через addKeyValue
+        if (m_trie.intHasSnapshots())
+        {
+            node_type* node = m_trie.addKeyValue(key, keyLength, std::move(value));
+
+            intRestorePath(key, keyLength);
+            return node;
+        }
+
+        // Общая часть ключа и правого пути
+        size_t commonLength = 0;
+        while (commonLength < keyLength && commonLength < m_path.size()
+               && key_traits::eq(m_pathChars[commonLength], key_traits::fold(key[commonLength])))
+        {
+            ++commonLength;
+        }
+
+        // Ключ является префиксом правого пути - узел уже существует
+        if (commonLength == keyLength)
+        {
+            // В режиме одновременного чтения узел заменяется новым
+            // (ключ не меньше предыдущих - в количестве ключей не по порядку не учитывается)
+            if (m_trie.getEpochManager())
+                return intAppendByTrie(key, keyLength, std::move(value));
+
+            node_type* node = m_path[keyLength - 1];
+            const bool bNewKey = !node->haveValue();
+            if (bNewKey)
+                intAddPathSubtreeCount(keyLength);
+            node->intEmplaceValue(std::move(value));
+
+            // Замененное значение могло быть наибольшим - путь пересчитывается деревом
+            if (bNewKey)
+                intRaisePathSubtreeMaxValue(keyLength, node->getValue());
+            else
+                m_trie.intUpdatePathSubtreeMaxValue(key, keyLength);
+            return node;
+        }
+
+        // Ключ меньше правого пути
+        if (commonLength < m_path.size()
+            && key_traits::less(key_traits::fold(key[commonLength]), m_pathChars[commonLength]))
+        {
+            return intAppendOutOfOrder(key, keyLength, std::move(value));
+        }
+
+        // Новый узел становится последним братом на уровне расхождения,
+        // остальные символы суффикса - цепочкой дочерних элементов
+        node_type* parentNode  = commonLength ? m_path[commonLength - 1] : m_rootNode;
+        node_type* lastBrother = commonLength < m_path.size() ? m_path[commonLength] : nullptr;
+
+        m_path.resize(commonLength);
+        m_pathChars.resize(commonLength);
+
+        intAddPathSubtreeCount(commonLength);
+        intRaisePathSubtreeMaxValue(commonLength, value);
+
+        node_type* headNode = node_type::create(m_resource, key[commonLength]);
+        node_type* node     = headNode;
+        trie_type::intAddSubtreeCount(node, 1);
+        trie_type::intRaiseSubtreeMaxValue(node, value);
+
+        m_path.push_back(node);
+        m_pathChars.push_back(node->getKeyChar());
+
+        for (size_t keyCharIndex = commonLength + 1; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            node_type* child = node_type::create(m_resource, key[keyCharIndex]);
+            trie_type::intAddSubtreeCount(child, 1);
+            trie_type::intRaiseSubtreeMaxValue(child, value);
+            node->setChild(child);
+            node = child;
+
+            m_path.push_back(node);
+            m_pathChars.push_back(node->getKeyChar());
+        }
+
+        node->intEmplaceValue(std::move(value));
+
+        // Суффикс публикуется в дереве уже заполненным
+        m_trie.intLinkChild(parentNode, headNode, lastBrother);
+
+        // Изменение учитывается в счетчике дерева, чтобы его обнаружили другие построители
+        m_modificationCount = ++m_trie.m_modificationCount;
+
+        return node;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    typename TrieBuilder<TTrie>::node_type*
+    TrieBuilder<TTrie>::append(const string_type& key, value_type value)
+    {
+        return append(key.getStr(), key.length(), std::move(value));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    typename TrieBuilder<TTrie>::node_type*
+    TrieBuilder<TTrie>::append(const std::basic_string<char_type>& key, value_type value)
+    {
+        return append(key.data(), key.size(), std::move(value));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    template<typename InputIterator>
+    size_t
+    TrieBuilder<TTrie>::append(InputIterator first, InputIterator last)
+    {
+        size_t count = 0;
+        for (; first != last; ++first, ++count)
+        {
+            append((*first).first, (*first).second);
+        }
+
+        return count;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    size_t
+    TrieBuilder<TTrie>::append(std::basic_istream<char_type>& stream)
+    {
+        size_t count = 0;
+
+        std::basic_string<char_type> key;
+        value_type value = value_type();
+        while (stream >> key >> value)
+        {
+            append(key, value);
+            ++count;
+        }
+
+        return count;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    size_t
+    TrieBuilder<TTrie>::getOutOfOrderCount() const
+    {
+        return m_outOfOrderCount;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    typename TrieBuilder<TTrie>::node_type*
+    TrieBuilder<TTrie>::intAppendOutOfOrder(const char_type* key, size_t keyLength, value_type value)
+    {
+        ++m_outOfOrderCount;
+
+        return intAppendByTrie(key, keyLength, std::move(value));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    typename TrieBuilder<TTrie>::node_type*
+    TrieBuilder<TTrie>::intAppendByTrie(const char_type* key, size_t keyLength, value_type value)
+    {
+        node_type* node = m_trie.addKeyValue(key, keyLength, std::move(value));
+
+        // Замена узла (режим одновременного чтения) может заменить узел правого пути
+        intRestorePath();
+
+        return node;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    void
+    TrieBuilder<TTrie>::intLoadPath()
+    {
+        m_rootNode = m_trie.intGetRoot();
+        m_path.clear();
+        m_pathChars.clear();
+
+        // Правый путь: последний брат на каждом уровне
+        for (node_type* node = m_rootNode->getChildSimple(); node; node = node->getChildSimple())
+        {
+            while (node->getNext())
+                node = node->getNext();
+
+            m_path.push_back(node);
+            m_pathChars.push_back(node->getKeyChar());
+        }
+
+        m_modificationCount = m_trie.intGetModificationCount();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    void
+    TrieBuilder<TTrie>::intRestorePath()
+    {
+        node_type* parentNode = m_rootNode;
+        for (size_t level = 0; level < m_pathChars.size(); ++level)
+        {
+            node_type* node = parentNode->findChild(m_pathChars[level]);
+            assert(node);
+
+            m_path[level] = node;
+            parentNode = node;
+        }
+
+        m_modificationCount = m_trie.intGetModificationCount();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    void
+    TrieBuilder<TTrie>::intRestorePath(const char_type* key, size_t keyLength)
+    {
+        const bool bKeyGreater = std::lexicographical_compare(
+            m_pathChars.begin(), m_pathChars.end(), key, key + keyLength,
+            [](char_type ch1, char_type ch2) { return key_traits::less(key_traits::fold(ch1), key_traits::fold(ch2)); });
+
+        if (bKeyGreater)
+        {
+            m_pathChars.clear();
+            for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+                m_pathChars.push_back(key_traits::fold(key[keyCharIndex]));
+
+            m_path.resize(keyLength);
+        }
+
+        intRestorePath();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    void
+    TrieBuilder<TTrie>::intAddPathSubtreeCount(size_t depth)
+    {
+        if constexpr (trie_type::has_subtree_counts)
+        {
+            trie_type::intAddSubtreeCount(m_rootNode, 1);
+
+            for (size_t level = 0; level < depth; ++level)
+                trie_type::intAddSubtreeCount(m_path[level], 1);
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    void
+    TrieBuilder<TTrie>::intRaisePathSubtreeMaxValue(size_t depth, const value_type& value)
+    {
+        if constexpr (trie_type::has_subtree_max_values)
+        {
+            trie_type::intRaiseSubtreeMaxValue(m_rootNode, value);
+
+            for (size_t level = 0; level < depth; ++level)
+                trie_type::intRaiseSubtreeMaxValue(m_path[level], value);
+        }
+    }
+
+}   // namespace Trie (Имплементация методов построителя цифрового дерева)
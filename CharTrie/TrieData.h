@@ -3,113 +3,542 @@
 #include <vector>
 #include <iterator>
 #include <cctype>
+#include <array>
+#include <functional>
+#include <memory>
+#include <new>
+#include <memory_resource>
+#include <type_traits>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <queue>
+#include <limits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #include "TrieStrings.h"
+#include "TrieArena.h"
+#include "TrieEpoch.h"
+#include "TrieSmallVector.h"
+#include "TrieSimd.h"
 
 namespace Trie
 {
-    //      ,   
-    template <typename TValueType>
-    TValueType get_undefined_value()
+    ////////////////////////////////////////////////////////////////////////////
+    // Таблица приведения однобайтовых символов к нижнему регистру
+    /*
+     * Покрывает латиницу ASCII и кириллицу Windows-1251 (включая Ё/ё).
+     * Строится при компиляции и не зависит от текущей локали.
+     */
+    constexpr std::array<unsigned char, 256> build_no_case_fold_table()
+    {
+        std::array<unsigned char, 256> table = {};
+        for (size_t charIndex = 0; charIndex < 256; ++charIndex)
+            table[charIndex] = static_cast<unsigned char>(charIndex);
+
+        for (size_t charIndex = 'A'; charIndex <= 'Z'; ++charIndex)
+            table[charIndex] = static_cast<unsigned char>(charIndex + ('a' - 'A'));
+
+        for (size_t charIndex = 0xC0; charIndex <= 0xDF; ++charIndex)
+            table[charIndex] = static_cast<unsigned char>(charIndex + 0x20);
+
+        table[0xA8] = 0xB8;
+
+        return table;
+    }
+
+    inline constexpr std::array<unsigned char, 256> no_case_fold_table = build_no_case_fold_table();
+
+    // Приведение символа к нижнему регистру
+    inline char fold_no_case(char ch)
+    {
+        return static_cast<char>(no_case_fold_table[static_cast<unsigned char>(ch)]);
+    }
+
+    // Приведение широкого символа (UTF-16 или UTF-32) к нижнему регистру
+    /*
+     * Соответствует таблице однобайтовых символов: латиница ASCII и кириллица
+     * U+0410..U+042F, U+0401 (Ё). Не зависит от текущей локали.
+     */
+    template<typename TWideChar>
+    constexpr TWideChar fold_no_case_wide(TWideChar ch)
     {
-        static_assert("    ");
+        if (ch >= TWideChar('A') && ch <= TWideChar('Z'))
+            return static_cast<TWideChar>(ch + ('a' - 'A'));
+
+        if (ch >= TWideChar(0x0410) && ch <= TWideChar(0x042F))
+            return static_cast<TWideChar>(ch + 0x20);
+
+        if (ch == TWideChar(0x0401))
+            return TWideChar(0x0451);
+
+        return ch;
     }
 
-    template <>
-    int get_undefined_value()
+    inline constexpr wchar_t  fold_no_case(wchar_t ch)  { return fold_no_case_wide(ch); }
+    inline constexpr char16_t fold_no_case(char16_t ch) { return fold_no_case_wide(ch); }
+    inline constexpr char32_t fold_no_case(char32_t ch) { return fold_no_case_wide(ch); }
+
+    // Признак типа символа, для которого определено fold_no_case
+    template<typename TCharType>
+    inline constexpr bool is_no_case_char = std::is_same<TCharType, char>::value
+        || std::is_same<TCharType, wchar_t>::value
+        || std::is_same<TCharType, char16_t>::value
+        || std::is_same<TCharType, char32_t>::value;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Предварительная загрузка узла в кэш процессора
+    inline void prefetch_node(const void* node)
     {
-        return -1;
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(node);
+#elif defined(_M_X64) || defined(_M_IX86)
+        _mm_prefetch(static_cast<const char*>(node), _MM_HINT_T0);
+#else
+        (void)node;
+#endif
     }
 
+    ////////////////////////////////////////////////////////////////////////////
+    // Сравнение символов без учета регистра
+    /*
+     * Регистр учитывается не для всего Unicode, а только для символов,
+     * приводимых fold_no_case:
+     *      - char - латиница ASCII и кириллица Windows-1251 (включая Ё/ё);
+     *      - wchar_t, char16_t, char32_t - латиница ASCII, U+0410..U+042F и U+0401 (Ё).
+     * Остальные символы (другие алфавиты, буквы с диакритикой, суррогатные
+     * пары) сравниваются по значению. Приведение не зависит от текущей локали.
+     * Для других типов символов нужно использовать собственный KeyCharLess.
+     */
     struct compare_no_case
     {
-        bool operator()(char ch1, char ch2) const
+        template<typename TCharType>
+        bool operator()(TCharType ch1, TCharType ch2) const
+        {
+            static_assert(is_no_case_char<TCharType>,
+                "compare_no_case поддерживает только char, wchar_t, char16_t и char32_t");
+
+            return fold_no_case(ch1) < fold_no_case(ch2);
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Свойства символов ключа для заданного способа сравнения
+    /*
+     * fold() приводит символ к виду, в котором он хранится в узлах дерева
+     * (один символ на класс равных символов). Для приведенных символов
+     * less() и eq() сравнивают значения без обращения к KeyCharLess,
+     * если это возможно.
+     */
+    template<typename TCharType, typename KeyCharLess>
+    struct key_char_traits
+    {
+        static TCharType fold(TCharType ch) { return ch; }
+
+        static bool less(TCharType ch1, TCharType ch2)
+        {
+            return ch1 == ch2 ? false : KeyCharLess()(ch1, ch2);
+        }
+
+        static bool eq(TCharType ch1, TCharType ch2)
         {
-			char ch1l = tolower(ch1);
-			char ch2l = tolower(ch2);
-            return ch1l < ch2l;
+            KeyCharLess less;
+            return ch1 == ch2 ? true : (!less(ch1, ch2) && !less(ch2, ch1));
         }
     };
 
+    // Сравнение с учетом регистра - сравниваются сами значения символов
+    template<typename TCharType>
+    struct key_char_traits<TCharType, std::less<TCharType>>
+    {
+        static TCharType fold(TCharType ch) { return ch; }
+
+        static bool less(TCharType ch1, TCharType ch2) { return ch1 < ch2; }
+        static bool eq  (TCharType ch1, TCharType ch2) { return ch1 == ch2; }
+    };
+
+    // Сравнение без учета регистра - сравниваются символы, приведенные к нижнему регистру
+    template<typename TCharType>
+    struct key_char_traits<TCharType, compare_no_case>
+    {
+        static_assert(is_no_case_char<TCharType>,
+            "compare_no_case поддерживает только char, wchar_t, char16_t и char32_t");
+
+        static TCharType fold(TCharType ch) { return fold_no_case(ch); }
+
+        static bool less(TCharType ch1, TCharType ch2) { return ch1 < ch2; }
+        static bool eq  (TCharType ch1, TCharType ch2) { return ch1 == ch2; }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Расширения узлов цифрового дерева
+    /*
+     * Узел наследует расширение, поэтому пустое расширение не увеличивает
+     * размер узла. Данные расширения поддерживаются деревом при изменении
+     * ключей и копируются вместе с узлом (Node::copyExt).
+     */
+
+    // Узел без расширения
+    struct NoNodeExt
+    {
+    };
+
+    // Количество ключей в поддереве узла
+    /*
+     * Количество включает ключ самого узла и ключи его дочерних элементов
+     * (братья не учитываются), у корня - количество ключей дерева.
+     * Дерево с такими узлами поддерживает size(), count_prefix(), count_range(),
+     * rank() и select().
+     *
+     * Счетчик изменяет только поток-писатель. В режиме одновременного чтения
+     * читатели получают значения счетчиков без гонок, но во время изменения
+     * счетчики разных узлов могут кратковременно не соответствовать друг другу.
+     */
+    class SubtreeCountExt
+    {
+    public:
+
+        SubtreeCountExt() noexcept;
+        SubtreeCountExt(const SubtreeCountExt& other) noexcept;
+        SubtreeCountExt& operator=(const SubtreeCountExt& other) noexcept;
+
+        // Получить количество ключей в поддереве
+        size_t              getSubtreeCount() const;
+
+        // Изменить количество ключей в поддереве (вызывается деревом)
+        void                addSubtreeCount(ptrdiff_t delta);
+
+    private:
+
+        std::atomic<size_t>     m_subtreeCount { 0 };
+    };
+
+    // Наибольшее значение в поддереве узла
+    /*
+     * Наибольшее из значений самого узла и его дочерних элементов (братья
+     * не учитываются), у поддерева без значений - numeric_limits::lowest().
+     * Дерево с такими узлами поддерживает top_k().
+     * Значения должны быть арифметического типа.
+     *
+     * Расширения можно объединять наследованием:
+     *      struct MyExt : SubtreeCountExt, SubtreeMaxValueExt<int> {};
+     *
+     * Как и количество ключей, значение изменяет только поток-писатель.
+     */
+    template<typename TValueType>
+    class SubtreeMaxValueExt
+    {
+        static_assert(std::is_arithmetic<TValueType>::value, "SubtreeMaxValueExt requires arithmetic values");
+
+    public:
+
+        SubtreeMaxValueExt() noexcept;
+        SubtreeMaxValueExt(const SubtreeMaxValueExt& other) noexcept;
+        SubtreeMaxValueExt& operator=(const SubtreeMaxValueExt& other) noexcept;
+
+        // Получить наибольшее значение в поддереве
+        TValueType          getSubtreeMaxValue() const;
+
+        // Установить наибольшее значение в поддереве (вызывается деревом)
+        void                setSubtreeMaxValue(TValueType value);
+
+    private:
+
+        std::atomic<TValueType> m_subtreeMaxValue;
+    };
+
+    // Непрерывный массив символов дочерних элементов узла
+    /*
+     * Узел, у которого не меньше min_children_count дочерних элементов, хранит
+     * упорядоченный массив их символов и указателей на них. Поиск символа на
+     * таком уровне (find, lower_bound, contains, get) выполняется по массиву
+     * (однобайтовые символы с обычным сравнением или без учета регистра -
+     * командами SSE2, остальные - двоичным поиском), а не переходами по цепочке
+     * братьев. Узлы с меньшим количеством дочерних элементов массива не имеют.
+     *
+     * Массив поддерживает дерево (и его построители) при каждом изменении
+     * цепочки дочерних элементов. Емкость массива растет геометрически:
+     * вставка и удаление выполняются на месте сдвигом элементов, новый массив
+     * строится, только когда емкость исчерпана или заполнена меньше чем на четверть.
+     * В режиме одновременного чтения на месте выполняются только добавление
+     * в конец и замена дочернего элемента (читатели не видят промежуточных
+     * состояний), остальные изменения строят новый массив, а прежний
+     * освобождается отложенно.
+     * Массив размещается в ресурсе памяти дерева. Копия узла создается без
+     * массива: массив копии строит дерево.
+     */
+    class ChildLabelsExt
+    {
+    public:
+
+        // Заголовок массива (за ним размещаются указатели на дочерние элементы
+        // (std::atomic), затем их символы)
+        struct Labels
+        {
+            std::pmr::memory_resource*  pResource;
+            size_t                      blockSize;
+            size_t                      capacity;
+            std::atomic<size_t>         count;      // Записывается после заполнения элементов
+        };
+
+        // Наименьшее количество дочерних элементов, для которого строится массив
+        static constexpr size_t min_children_count = 8;
+
+        ChildLabelsExt() noexcept;
+        ChildLabelsExt(const ChildLabelsExt& other) noexcept;
+        ChildLabelsExt& operator=(const ChildLabelsExt& other) noexcept;
+        ~ChildLabelsExt();
+
+        // Получить массив (nullptr - массива нет)
+        const Labels*       getChildLabels() const;
+
+        // Заменить массив (вызывается деревом)
+        /**
+         * @return  прежний массив (освобождается вызывающей стороной)
+         */
+        Labels*             exchangeChildLabels(Labels* labels);
+
+        // Освободить массив
+        /**
+         * Сигнатура подходит для отложенного освобождения (EpochManager::retire).
+         *
+         * @param   labels - массив
+         * @param   context - не используется
+         */
+        static void         freeChildLabels(void* labels, void* context);
+
+    private:
+
+        std::atomic<Labels*>    m_pChildLabels { nullptr };
+    };
+
     ////////////////////////////////////////////////////////////////////////////
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    class Node
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt = NoNodeExt>
+    class Node : public TNodeExt
     {
+        template<typename, typename, typename, typename>
+        friend class Trie;
+        template<typename TTrie>
+        friend class TrieBuilder;
+        template<typename TTrie>
+        friend class ParallelTrieBuilder;
+
     public:
 
-        using node_type = Node<TCharType, TValueType, KeyCharLess>;
+        using node_type  = Node<TCharType, TValueType, KeyCharLess, TNodeExt>;
+        using key_traits = key_char_traits<TCharType, KeyCharLess>;
+
+        // Расширение узлов зависит от значений (SubtreeCountExt, SubtreeMaxValueExt)
+        static constexpr bool has_value_dependent_ext = std::is_base_of<SubtreeCountExt, TNodeExt>::value
+                                                        || std::is_base_of<SubtreeMaxValueExt<TValueType>, TNodeExt>::value;
+
+        // Узлы хранят массив символов дочерних элементов (ChildLabelsExt)
+        static constexpr bool has_child_labels = std::is_base_of<ChildLabelsExt, TNodeExt>::value;
+
+        // Ссылка на значение неконстантного узла (при таком расширении - только для чтения)
+        using value_reference = std::conditional_t<has_value_dependent_ext, const TValueType&, TValueType&>;
+
+        // Создание узлов в указанном ресурсе памяти
+        static node_type* create(std::pmr::memory_resource* resource);
+        static node_type* create(std::pmr::memory_resource* resource, TCharType keyChar);
+        static node_type* create(std::pmr::memory_resource* resource, TCharType keyChar, TValueType value);
 
-        static node_type* create();
-        static node_type* create(TCharType keyChar);
-        static node_type* create(TCharType keyChar, TValueType value);
-        static node_type* clone (node_type* node);
+        // Создание узла со значением, построенным из указанных аргументов
+        template<typename... Args>
+        static node_type* createEmplace(std::pmr::memory_resource* resource, TCharType keyChar, Args&&... args);
+
+        // Разрушение узла вместе с дочерними элементами и следующими за ним братьями
+        /*
+         * Обход выполняется без рекурсии и без выделения дополнительной памяти
+         */
+        static void       destroy(std::pmr::memory_resource* resource, node_type* node);
+
+        // Разрушение узла вместе с дочерними элементами (следующие братья не затрагиваются)
+        static void       destroySubtree(std::pmr::memory_resource* resource, node_type* node);
+
+        // Освобождение ссылки на узел
+        /*
+         * Узел, на который больше нет ссылок, разрушается, а ссылки на его
+         * дочерний элемент и следующего брата освобождаются (без рекурсии
+         * и без выделения дополнительной памяти)
+         */
+        static void       release(std::pmr::memory_resource* resource, node_type* node);
 
         Node() noexcept;
         Node(TCharType keyChar);
-        Node(TCharType keyChar, TValueType value);
-        virtual ~Node();
+        template<typename... Args>
+        Node(TCharType keyChar, std::in_place_t, Args&&... args);
+        ~Node();
+
+        ///////////////////////////////////////////
+        // Счетчик ссылок
+
+        // Добавить ссылку на узел
+        /*
+         * Ссылками считаются указатели на узел из родителя или предыдущего брата
+         * в каждой версии дерева (снимки разделяют неизмененные узлы).
+         * Счетчик 32-битный, поэтому на практике не переполняется (каждая ссылка -
+         * это отдельный узел или снимок). Насыщение оставлено как страховка: узел
+         * с max_ref_count ссылок больше не освобождается по счетчику.
+         */
+        void                addRef();
+
+        // Определить, разделяется ли узел несколькими версиями дерева
+        bool                isShared() const;
+
+        // Скопировать расширение другого узла (при замене узла копией)
+        void                copyExt(const node_type& other);
 
         ///////////////////////////////////////////
-        //   
+        // Работа с ключем
 
-        // /  
+        // Установить/получить символ ключа
+        /*
+         * Символ хранится приведенным (key_char_traits::fold)
+         */
         void                setKeyChar(TCharType keyChar);
         TCharType           getKeyChar() const;
 
         ///////////////////////////////////////////
-        //   
+        // Работа со значением
 
-        // ,   
+        // Определить, хранится ли значение
+        /*
+         * Наличие значения хранится отдельным признаком, поэтому значением
+         * может быть любое значение типа. Значение создается, только
+         * когда оно устанавливается, и разрушается вместе с узлом.
+         */
         bool                haveValue() const;
 
-        // / 
+        // Установить/получить значение
+        /*
+         * Изменять значение через узел (setValue, emplaceValue, resetValue,
+         * ссылка getValue) можно, только если расширение узлов не зависит
+         * от значений: иначе количества ключей и наибольшие значения поддеревьев
+         * не будут пересчитаны. В дереве с такими расширениями значения изменяются
+         * через дерево (insert_or_assign, removeKey), а getValue возвращает
+         * константную ссылку.
+         */
         void                setValue(TValueType value);
         const TValueType&   getValue() const;
+        value_reference     getValue();
+
+        // Установить значение, построенное из указанных аргументов
+        /*
+         * Если значения нет, оно создается на месте, иначе - заменяется
+         * (присваиванием построенного значения)
+         */
+        template<typename... Args>
+        TValueType&         emplaceValue(Args&&... args);
+
+        // Удалить значение
+        void                resetValue();
 
         ///////////////////////////////////////////
-        //    
+        // Работа со следющими элементами
 
-        // /     
+        // Установить/получить указатель на следующий элемент дерева
+        /*
+         * Указатели на следующий и дочерний элементы записываются с семантикой release
+         * и читаются с семантикой acquire: узел, полностью заполненный до записи
+         * указателя на него, виден читателям из других потоков целиком.
+         */
         void                setNext(node_type* next);
         node_type*          getNext() const;
 
 		///////////////////////////////////////////
-		//   
+		// Работа с дочерним
 
-		// /     
+		// Установить/получить указатель на дочерний элемент дерева
 		void                setChild(node_type* child);
 		node_type*          getChildSimple() const;
-		node_type*          getChildCreate(bool& bCreated);
+
+		// Получить дочерний элемент для указанного символа
+		/**
+		 * Если элемент не найден - он будет создан и размещен в цепочке
+		 * дочерних элементов в нужном месте.
+		 */
+		node_type*          getChildCreate(TCharType keyChar, bool& bCreated, std::pmr::memory_resource* resource);
+
+		// Найти дочерний элемент для указанного символа
+		/**
+		 * @param   keyChar - символ ключа
+		 * @param   prevChild - последний дочерний элемент с меньшим символом (nullptr - если такого нет)
+		 * @return  найденный элемент или nullptr
+		 */
+		node_type*          findChild(TCharType keyChar, node_type*& prevChild) const;
+
+		// Найти дочерний элемент для указанного символа (по массиву символов, если он есть)
+		/**
+		 * @param   keyChar - символ ключа
+		 * @return  найденный элемент или nullptr
+		 */
+		node_type*          findChild(TCharType keyChar) const;
+
+		// Найти первый дочерний элемент с символом, большим или равным указанному
+		/**
+		 * @param   keyChar - символ ключа
+		 * @return  найденный элемент или nullptr, если все символы меньше указанного
+		 */
+		node_type*          findChildEqOrGreat(TCharType keyChar) const;
+
+		// Вставить полностью заполненный элемент в цепочку дочерних элементов
+		/**
+		 * @param   child - вставляемый элемент
+		 * @param   prevChild - элемент, после которого выполняется вставка (nullptr - в начало цепочки)
+		 */
+		void                linkChild(node_type* child, node_type* prevChild);
+
+		// Заменить дочерний элемент новым элементом
+		/**
+		 * Новый элемент получает дочерние элементы и следующего брата заменяемого
+		 * (ссылки на них передаются новому элементу).
+		 * Заменяемый элемент остается неизменным для читателей, которые его уже получили.
+		 *
+		 * @param   oldChild - заменяемый элемент
+		 * @param   newChild - новый элемент
+		 * @param   prevChild - элемент, предшествующий заменяемому (nullptr - заменяемый первый в цепочке)
+		 */
+		void                replaceChild(node_type* oldChild, node_type* newChild, node_type* prevChild);
+
+		// Исключить элемент из цепочки дочерних элементов
+		/**
+		 * Указатель на следующего брата у исключенного элемента сохраняется,
+		 * чтобы читатели, находящиеся на нем, могли продолжить обход
+		 * (ссылка на брата передается предыдущему элементу).
+		 *
+		 * @param   child - исключаемый элемент
+		 * @param   prevChild - элемент, предшествующий исключаемому (nullptr - исключаемый первый в цепочке)
+		 */
+		void                unlinkChild(node_type* child, node_type* prevChild);
 
 		///////////////////////////////////////////
-		//   
+		// Работа с братьями
 
-        //        
+        // Получить указатель на следующий элемент для указанного символа
         /*
-         *      (),   
-         *     
+         * Возращает элемент в цепочке элементов (братьев), обладающих указанным символом
+         * Поиск начинается с текущего элемента
          */
         node_type*          getBrotherSimple(TCharType keyChar);
         const node_type*    getBrotherSimple(TCharType keyChar) const;
 
-        //        
+        // Получить указатель на следующий элемент для указанного символа
         /**
-         *      (),  
-         *    
-         *     
+         * Возращает элемент в цепочке элементов (братьев), обладающих символом
+         * большим или равным указанного
+         * Поиск начинается с текущего элемента
          */
         node_type*          getBrotherEqOrGreatSimple(TCharType keyChar);
         const node_type*    getBrotherEqOrGreatSimple(TCharType keyChar) const;
 
-        //        
-        /**
-         *      (),   
-         *     
-         *      -   
-         *      ()   
-         */
-        node_type*          getBrotherCreate(TCharType keyChar, bool& bCreated);
-
     private:
 
 		template <typename PNodeType>
@@ -118,110 +547,487 @@ namespace Trie
 		template <typename PNodeType>
 		PNodeType           intGetBrotherEqOrGreatSimple(PNodeType thisNode, TCharType keyChar) const;
 
+        ///////////////////////////////////////////
+        // Массив символов дочерних элементов (только для узлов с ChildLabelsExt)
+        /*
+         * Однобайтовые символы с обычным сравнением или без учета регистра хранятся
+         * байтами, упорядоченными как беззнаковые (для векторного поиска),
+         * остальные - как есть.
+         */
+        static constexpr bool simd_labels = sizeof(TCharType) == 1
+            && (std::is_same<KeyCharLess, std::less<TCharType>>::value || std::is_same<KeyCharLess, compare_no_case>::value);
+
+        using label_type = std::conditional_t<simd_labels, uint8_t, TCharType>;
+
+        // Получить элемент массива для приведенного символа
+        static label_type   intToLabel(TCharType keyChar);
+
+        // Получить указатели на дочерние элементы и символы массива
+        /*
+         * Элементы изменяются только писателем (методами узла, не являющимися const)
+         */
+        static std::atomic<node_type*>*     intGetLabelChildren(const ChildLabelsExt::Labels* labels);
+        static label_type*                  intGetLabelChars(const ChildLabelsExt::Labels* labels);
+
+        // Найти в массиве индекс символа или первого большего символа
+        /**
+         * @return  индекс или count, если символ не найден (все символы меньше)
+         */
+        static size_t       intFindLabel(const ChildLabelsExt::Labels* labels, size_t count, TCharType keyChar);
+        static size_t       intFindLabelEqOrGreat(const ChildLabelsExt::Labels* labels, size_t count, TCharType keyChar);
+
+        // Построить массив по цепочке дочерних элементов
+        /**
+         * @return  прежний массив (освобождается вызывающей стороной)
+         */
+        ChildLabelsExt::Labels* intBuildChildLabels(std::pmr::memory_resource* resource);
+
+        // Вставить в массив элемент, добавленный в цепочку
+        /**
+         * @param   child - добавленный элемент
+         * @param   bAppendOnly - вставлять только в конец массива (режим одновременного чтения)
+         * @return  false - элемент не вставлен (массива нет, емкость исчерпана или
+         *          элемент не последний при bAppendOnly), массив нужно построить заново
+         */
+        bool                intInsertChildLabel(node_type* child, bool bAppendOnly);
+
+        // Удалить из массива элемент, исключенный из цепочки
+        /**
+         * @return  false - элемент не удален (массива нет или он станет заполнен
+         *          меньше чем на четверть), массив нужно построить заново
+         */
+        bool                intEraseChildLabel(node_type* child);
+
+        // Заменить в массиве указатель на замененный дочерний элемент
+        /**
+         * @return  false - массива нет
+         */
+        bool                intReplaceChildLabel(node_type* oldChild, node_type* newChild);
+
+    public:
+
+        // Максимальное значение счетчика ссылок
+        static constexpr uint32_t max_ref_count = 0xFFFFFFFF;
+
+    private:
+
+        // Указатель на хранилище значения (значение существует, только если m_bHaveValue)
+        TValueType*         intGetValuePtr();
+        const TValueType*   intGetValuePtr() const;
+
+        // Установить/удалить значение (вызывается деревом и построителями, которые
+        // сами пересчитывают расширения узлов)
+        template<typename... Args>
+        TValueType&         intEmplaceValue(Args&&... args);
+        void                intResetValue();
+
     private:
 
-        TCharType          m_keyChar = 0;
-        TValueType         m_value   = get_undefined_value<TValueType>();
-        node_type*         m_pNext   = nullptr;
-        node_type*         m_pChild  = nullptr;
+        TCharType          m_keyChar    = 0;
+        bool               m_bHaveValue = false;    // Признак и счетчик размещаются в выравнивании между символом и значением
+        uint32_t           m_refCount   = 1;
+        alignas(TValueType) unsigned char m_value[sizeof(TValueType)];
+        std::atomic<node_type*> m_pNext  { nullptr };
+        std::atomic<node_type*> m_pChild { nullptr };
     };
 
     ////////////////////////////////////////////////////////////////////////////
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    // Способ размещения узлов цифрового дерева в памяти
+    enum class NodesAllocation
+    {
+        Heap,       // Каждый узел размещается в куче отдельно
+        Arena,      // Узлы размещаются в собственной арене дерева (слэбами)
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
     class const_iterator;
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
     class iterator;
 
     ////////////////////////////////////////////////////////////////////////////
-    template<typename TCharType, typename TValueType, typename KeyCharLess = compare_no_case>
+    template<typename TTrie>
+    class TrieBuilder;
+    template<typename TTrie>
+    class ParallelTrieBuilder;
+
+    ////////////////////////////////////////////////////////////////////////////
+    template<typename TCharType, typename TValueType, typename KeyCharLess = compare_no_case, typename TNodeExt = NoNodeExt>
     class Trie
     {
+        template<typename TTrie>
+        friend class TrieBuilder;
+        template<typename TTrie>
+        friend class ParallelTrieBuilder;
+
     public:
 
         using string_type               = TrieStrings::StringOfChars<typename TCharType>;
 
-        using node_type                 = Node<TCharType, TValueType, KeyCharLess>;
+        // Ключ, символы которого читаются из памяти вызывающей стороны без копирования
+        using key_view_type             = std::basic_string_view<TCharType>;
+
+        using node_type                 = Node<TCharType, TValueType, KeyCharLess, TNodeExt>;
         using nodes_vector_type         = std::vector<node_type*>;
 
-        using iterator_type             = iterator<typename TCharType, typename TValueType, typename KeyCharLess>;
-        using const_iterator_type       = const_iterator<typename TCharType, typename TValueType, typename KeyCharLess>;
+        using iterator_type             = iterator<typename TCharType, typename TValueType, typename KeyCharLess, TNodeExt>;
+        using const_iterator_type       = const_iterator<typename TCharType, typename TValueType, typename KeyCharLess, TNodeExt>;
 
-        Trie() noexcept;
+        // Узлы дерева хранят количество ключей в поддереве (SubtreeCountExt)
+        static constexpr bool has_subtree_counts = std::is_base_of<SubtreeCountExt, TNodeExt>::value;
+
+        // Узлы дерева хранят наибольшее значение в поддереве (SubtreeMaxValueExt)
+        static constexpr bool has_subtree_max_values = std::is_base_of<SubtreeMaxValueExt<TValueType>, TNodeExt>::value;
+
+        Trie(NodesAllocation allocation = NodesAllocation::Heap);
+
+        // Создание дерева, узлы которого размещаются во внешнем ресурсе памяти
+        /**
+         * Ресурс должен существовать все время жизни дерева.
+         * Узлы освобождаются в ресурсе по одному.
+         */
+        explicit Trie(std::pmr::memory_resource* resource);
+
+        Trie(const Trie&) = delete;
+        Trie& operator=(const Trie&) = delete;
         ~Trie();
 
-        //   /
+        // Получить ресурс памяти, в котором размещаются узлы дерева
+        std::pmr::memory_resource* getMemoryResource() const;
+
+        // Включить режим одновременного чтения
+        /**
+         * В этом режиме один поток-писатель изменяет дерево (addKeyValue, removeKey),
+         * а любое количество читателей без блокировок выполняет find, lower_bound,
+         * contains, get и обход итераторами. На время чтения читатель создает
+         * EpochManager::Guard для менеджера эпох дерева.
+         *
+         * Узлы публикуются только полностью заполненными, значение существующего
+         * ключа заменяется вместе с узлом, а исключенные узлы освобождаются
+         * отложенно - после завершения читателей, которые могли их получить.
+         * Значение узла, полученного от addKeyValue, нельзя изменять через setValue.
+         *
+         * Режим включается до начала работы читателей и не отключается.
+         *
+         * @param   epochManager - менеджер эпох (nullptr - дерево создает собственный).
+         *          Внешний менеджер должен существовать все время жизни дерева.
+         */
+        void                enableConcurrentReads(EpochManager* epochManager = nullptr);
+
+        // Получить менеджер эпох (nullptr - режим одновременного чтения не включен)
+        EpochManager*       getEpochManager() const;
+
+        // Получить неизменяемый снимок текущего состояния дерева
+        /**
+         * Снимок разделяет с деревом все узлы. Последующие addKeyValue/removeKey
+         * копируют только узлы на пути к изменяемому узлу (путь в цепочках
+         * дочерних элементов, начиная с корня), если они разделяются со снимками.
+         * Поэтому читатели снимка не блокируют писателя и не видят его изменений.
+         *
+         * Снимок создается потоком-писателем и может использоваться (и разрушаться)
+         * в любом потоке, в том числе после разрушения дерева. Внешний ресурс
+         * памяти дерева должен существовать, пока существуют снимки.
+         * Значения копируемых узлов копируются, поэтому снимки доступны
+         * только для копируемых типов значений.
+         *
+         * @return  снимок - дерево, доступное только для чтения
+         */
+        std::shared_ptr<const Trie> snapshot();
+
+        // Получить корневой узел дерева
+        /**
+         * Корневой узел не содержит символа ключа, его дочерние элементы
+         * соответствуют первым символам ключей.
+         * Используется для построения компактных представлений дерева.
+         */
+        const node_type*    getRootNode() const;
+
+        // Добавление пары ключ/значение
         /**
-         *   ,     .
-         *    ,     /
+         * Если ключ найден, то заменяем значение на новое.
+         * Если ключ не найден, то добавляется новая пара ключ/значение
          *
-         * @param   key -    
-         * @param   value -    
-         * @return    ,  
+         * @param   key - ключ для добавляемого узла
+         * @param   value - значение для добавляемого узла
+         * @return  указатель на узел, соответствующий ключу
          */
         node_type*          addKeyValue(const string_type& key, typename TValueType value);
 
-        //    ()  
+        // Добавление пары ключ/значение по ключу без копирования
+        /**
+         * Символы ключа читаются из памяти вызывающей стороны без виртуальных
+         * вызовов и без построения StringOfChars.
+         *
+         * @param   key, keyLength - ключ для добавляемого узла
+         * @param   value - значение для добавляемого узла
+         * @return  указатель на узел, соответствующий ключу
+         */
+        node_type*          addKeyValue(key_view_type key, TValueType value);
+        node_type*          addKeyValue(const TCharType* key, size_t keyLength, TValueType value);
+
+        // Добавление пары ключ/значение с построением значения на месте
+        /**
+         * Если ключ найден и с ним связано значение, то дерево не изменяется
+         * и значение не строится.
+         *
+         * @param   key - ключ для добавляемого узла
+         * @param   args - аргументы конструктора значения
+         * @return  указатель на узел, соответствующий ключу, и признак добавления значения
+         */
+        template<typename... Args>
+        std::pair<node_type*, bool> emplace(const string_type& key, Args&&... args);
+        template<typename... Args>
+        std::pair<node_type*, bool> emplace(key_view_type key, Args&&... args);
+
+        // Добавление пары ключ/значение или замена значения найденного ключа
+        /**
+         * @param   key - ключ для добавляемого узла
+         * @param   value - значение (перемещается в узел)
+         * @return  указатель на узел, соответствующий ключу, и признак добавления
+         *          нового ключа (false - значение ключа заменено)
+         */
+        std::pair<node_type*, bool> insert_or_assign(const string_type& key, TValueType&& value);
+        std::pair<node_type*, bool> insert_or_assign(const string_type& key, const TValueType& value);
+        std::pair<node_type*, bool> insert_or_assign(key_view_type key, TValueType&& value);
+        std::pair<node_type*, bool> insert_or_assign(key_view_type key, const TValueType& value);
+
+        // Удаление заданного ключа (слова) из дерева
         /**
-         *  ,  ( )    
-		 * /,      
+         * Удаляется ключ, значение (если есть) и все другие пары
+		 * ключ/значение, у которых ключ начинается с указанного
          *
-         * @param   key -    
-         * @return  true -        , false - 
+         * @param   key - ключ для удаляемого элемента
+         * @return  true - если элемент по ключу был найден и удален, false - иначе
          */
         bool                removeKey(const TrieStrings::StringOfChars<TCharType>& key);
+        bool                removeKey(key_view_type key);
+        bool                removeKey(const TCharType* key, size_t keyLength);
 
-        //    ()  
+        // Поиск заданного ключа (слова) в дереве
         /**
-         *  ,   ,  .
+         * В случае, если слово найдено, возвращается значение.
          *
-         * @param   key -  
-         * @return       .
-         *            ,    end()
+         * @param   key - искомый ключ
+         * @return  итератор для найденого узла по ключу.
+         *          Если не найдено, то будет возвращено end()
          */
         iterator_type       find(const TrieStrings::StringOfChars<TCharType>& key);
+        iterator_type       find(key_view_type key);
+        iterator_type       find(const TCharType* key, size_t keyLength);
 
-        //    ()  
+        // Поиск заданного ключа (слова) в дереве
         /**
-         *  ,   ,  .
+         * В случае, если слово найдено, возвращается значение.
          *
-         * @param   key -  
-         * @return       .
-         *            ,    end()
+         * @param   key - искомый ключ
+         * @return  итератор для найденого узла по ключу.
+         *          Если не найдено, то будет возвращено сend()
          */
         const_iterator_type find(const TrieStrings::StringOfChars<TCharType>& key) const;
+        const_iterator_type find(key_view_type key) const;
+        const_iterator_type find(const TCharType* key, size_t keyLength) const;
+
+        // Проверка наличия значения для заданного ключа (слова) в дереве
+        /**
+         * Поиск выполняется без выделения памяти и без построения итератора.
+         *
+         * @param   key - искомый ключ
+         * @return  true - если ключ найден и с ним связано значение, false - иначе
+         */
+        bool                contains(const TrieStrings::StringOfChars<TCharType>& key) const;
+        bool                contains(key_view_type key) const;
+        bool                contains(const TCharType* key, size_t keyLength) const;
+
+        // Получение значения для заданного ключа (слова)
+        /**
+         * Поиск выполняется без выделения памяти и без построения итератора.
+         *
+         * @param   key - искомый ключ
+         * @return  указатель на значение, связанное с ключом.
+         *          Если значения нет, то будет возвращен nullptr
+         */
+        const TValueType*   get(const TrieStrings::StringOfChars<TCharType>& key) const;
+        const TValueType*   get(key_view_type key) const;
+        const TValueType*   get(const TCharType* key, size_t keyLength) const;
+
+        // Получение значения для заданного ключа (слова)
+        /**
+         * Поиск выполняется без выделения памяти и без построения итератора.
+         *
+         * @param   key - искомый ключ
+         * @param   value - значение, связанное с ключом (заполняется, только если ключ найден)
+         * @return  true - если ключ найден и с ним связано значение, false - иначе
+         */
+        bool                try_get(const TrieStrings::StringOfChars<TCharType>& key, TValueType& value) const;
+        bool                try_get(key_view_type key, TValueType& value) const;
+
+        // Найти самый длинный ключ, являющийся префиксом текста
+        /**
+         * Текст просматривается один раз от корня; запоминается последний
+         * пройденный узел со значением. Поиск выполняется без выделения памяти.
+         *
+         * @param   buf - текст
+         * @param   len - количество символов текста
+         * @return  длина найденного ключа и указатель на его значение.
+         *          Если ни один ключ не является префиксом текста, то будет
+         *          возвращено { 0, nullptr }
+         */
+        std::pair<size_t, const TValueType*>
+                            longest_prefix(const TCharType* buf, size_t len) const;
+
+        // Найти все ключи, являющиеся префиксами текста
+        /**
+         * Текст просматривается один раз от корня, ключи сообщаются в порядке
+         * возрастания длины. Поиск выполняется без выделения памяти.
+         *
+         * @param   buf - текст
+         * @param   len - количество символов текста
+         * @param   callback - функция callback(size_t length, const TValueType& value),
+         *          length - длина найденного ключа
+         * @return  количество найденных ключей
+         */
+        template<typename Callback>
+        size_t              all_prefixes(const TCharType* buf, size_t len, Callback callback) const;
 
-        // ,        
-        //   .
-        // :
-        //        : {, , , , }.
-        //      C    .
-        //              - ..  ,
-        //         , , . 
-        //   ,      
+        // Получение значений для группы ключей
+        /**
+         * Поиски по ключам группы выполняются поочередно по одному переходу между
+         * узлами, при этом следующий узел каждого поиска заранее запрашивается
+         * в кэш процессора. Задержки обращений к памяти разных поисков перекрываются.
+         * Переход к дочернему элементу узла с массивом символов (ChildLabelsExt)
+         * выполняется поиском в массиве, без прохода по цепочке братьев.
+         * Поиск выполняется без выделения памяти.
+         *
+         * @param   keys - массив указателей на искомые ключи (массив ключей;
+         *          массивы указателей на символы ключей и их длин)
+         * @param   count - количество ключей
+         * @param   results - массив для указателей на значения (nullptr - значения нет)
+         * @return  количество найденных значений
+         */
+        size_t              find_batch(const TrieStrings::StringOfChars<TCharType>* const* keys, size_t count,
+                                       const TValueType** results) const;
+        size_t              find_batch(const key_view_type* keys, size_t count, const TValueType** results) const;
+        size_t              find_batch(const TCharType* const* keys, const size_t* keyLengths, size_t count,
+                                       const TValueType** results) const;
+
+        // Также, необходимо предоставить пример перебора всех значений для всех
+        // слов больше заданного.
+        // Пример:
+        //      дерево содержит слова: {альфа, бета, гамма, дельта, эпсилон}.
+        //      C каждым словом связано число.
+        //      Нужно получить все числа для слов больше бета - т.е. найти числа,
+        //      связанные со словами гамма, дельта, эпсилон. 
+        // Поиск узла дерева, ключ которого больше или равен указанному
         
         /**
-         *      ,   
-         *    .
+         * Метод возвращает итератор для элемента дерева, ключ которого больше
+         * или равен указанному ключу.
          *
-         * @param key - 
-         * @return      ,   
-         *            .
-         *             , 
-         *           cend()
+         * @param key - ключ
+         * @return итератор для итератор для элемента дерева, ключ которого больше
+         *         или равен указанному ключу.
+         *         Если подходящих элементов не найдено, будет
+         *         возвращен итератор cend()
          */
         iterator_type lower_bound(const TrieStrings::StringOfChars<TCharType>& key);
+        iterator_type lower_bound(key_view_type key);
+        iterator_type lower_bound(const TCharType* key, size_t keyLength);
 
         /**
-         *      ,   
-         *    .
+         * Метод возвращает итератор для элемента дерева, ключ которого больше
+         * или равен указанному ключу.
          *
-         * @param key - 
-         * @return      ,   
-         *            .
-         *             , 
-         *           cend()
+         * @param key - ключ
+         * @return итератор для итератор для элемента дерева, ключ которого больше
+         *         или равен указанному ключу.
+         *         Если подходящих элементов не найдено, будет
+         *         возвращен итератор cend()
          */
         const_iterator_type lower_bound(const TrieStrings::StringOfChars<TCharType>& key) const;
+        const_iterator_type lower_bound(key_view_type key) const;
+        const_iterator_type lower_bound(const TCharType* key, size_t keyLength) const;
+
+        // Нечеткий поиск: найти ключи, редакционное расстояние до которых не больше указанного
+        /**
+         * Дерево обходится один раз. Для каждого узла по строке матрицы расстояний
+         * Левенштейна его родителя вычисляется строка узла; поддерево отбрасывается,
+         * если все значения строки больше maxDistance. Символы сравниваются
+         * с учетом KeyCharLess (без учета регистра - по умолчанию).
+         *
+         * Ключ найденного элемента накапливается в одном буфере по ходу обхода
+         * и передается в виде, в котором он хранится в дереве.
+         *
+         * @param   key - искомый ключ
+         * @param   maxDistance - максимальное количество вставок, удалений и замен символов
+         * @param   callback - функция callback(const std::basic_string<TCharType>& key,
+         *          const TValueType& value, size_t distance)
+         * @return  количество найденных ключей
+         */
+        template<typename Callback>
+        size_t              fuzzy_search(const TrieStrings::StringOfChars<TCharType>& key, size_t maxDistance,
+                                         Callback callback) const;
+        template<typename Callback>
+        size_t              fuzzy_search(key_view_type key, size_t maxDistance, Callback callback) const;
+
+        ///////////////////////////////////////////
+        // Подсчет ключей (только для узлов с SubtreeCountExt)
+        /*
+         * Методы выполняются за время, пропорциональное длине ключа и количеству
+         * братьев на пути к нему, без обхода поддеревьев.
+         */
+
+        // Получить количество ключей дерева
+        size_t              size() const;
+
+        // Получить количество ключей, начинающихся с указанного префикса
+        /**
+         * @param   prefix - префикс (ключ, равный префиксу, тоже учитывается)
+         * @return  количество ключей
+         */
+        size_t              count_prefix(const TrieStrings::StringOfChars<TCharType>& prefix) const;
+        size_t              count_prefix(key_view_type prefix) const;
+
+        // Получить количество ключей из диапазона [lo, hi)
+        /**
+         * @param   lo - нижняя граница (включается)
+         * @param   hi - верхняя граница (не включается)
+         * @return  количество ключей, 0 - если hi не больше lo
+         */
+        size_t              count_range(const TrieStrings::StringOfChars<TCharType>& lo,
+                                        const TrieStrings::StringOfChars<TCharType>& hi) const;
+        size_t              count_range(key_view_type lo, key_view_type hi) const;
+
+        // Получить количество ключей, меньших указанного
+        /**
+         * Ключ может отсутствовать в дереве. Если ключ есть, результат - его
+         * порядковый номер (с 0) в порядке обхода.
+         */
+        size_t              rank(const TrieStrings::StringOfChars<TCharType>& key) const;
+        size_t              rank(key_view_type key) const;
+
+        // Получить итератор на ключ с указанным порядковым номером
+        /**
+         * @param   index - порядковый номер ключа (с 0) в порядке обхода
+         * @return  итератор для найденного ключа.
+         *          Если index не меньше size(), то будет возвращен end()
+         */
+        iterator_type       select(size_t index);
+        const_iterator_type select(size_t index) const;
+
+        // Получить ключи с наибольшими значениями среди ключей с указанным префиксом
+        /**
+         * Только для узлов с SubtreeMaxValueExt. Поиск выполняется по наибольшим
+         * значениям поддеревьев: сначала раскрываются поддеревья с большими
+         * значениями, поэтому просматриваются O(k * длина ключа) узлов
+         * (и их братья), а не все поддерево префикса.
+         *
+         * @param   prefix - префикс (ключ, равный префиксу, тоже учитывается)
+         * @param   k - наибольшее количество ключей
+         * @return  пары (ключ, значение) в порядке убывания значений.
+         *          Ключи - в виде, в котором они хранятся в дереве
+         */
+        std::vector<std::pair<std::basic_string<TCharType>, TValueType>>
+                            top_k(const TrieStrings::StringOfChars<TCharType>& prefix, size_t k) const;
 
         iterator_type       begin();
         iterator_type       end();
@@ -230,50 +1036,186 @@ namespace Trie
 
     private:
 
-        //     
-        node_type*                          intGetRoot() const;
+        // Состояние, общее для дерева и его снимков
+        struct SnapshotState
+        {
+            std::mutex                  mutex;
+            bool                        bWriterAlive = true;    // Дерево-писатель существует
+            std::vector<node_type*>     releasedRoots;          // Корни разрушенных снимков
+            std::atomic<size_t>         releasedCount { 0 };
+            size_t                      snapshotsCount = 0;     // Снимки, корни которых еще не освобождены писателем
+        };
 
-        //   
-        void                                intResetRoot(node_type* newRoot);
+        // Создание снимка дерева с указанным корнем
+        Trie(const Trie& source, node_type* rootNode);
 
-        //      
-        iterator_type                       intGetNodeSimple(const TrieStrings::StringOfChars<TCharType>& key, size_t keyLength);
-        const_iterator_type                 intGetNodeSimple(const TrieStrings::StringOfChars<TCharType>& key, size_t keyLength) const;
-        iterator_type                       intGetNodeCreate(const TrieStrings::StringOfChars<TCharType>& key, size_t keyLength);
+        // Создание и получение корневого узла
+        node_type*                          intGetRoot() const;
 
-        //       
-        nodes_vector_type                   intGetNodePathSimple(const TrieStrings::StringOfChars<TCharType>& key, size_t keyLength) const;
+        // Освободить корни разрушенных снимков (вызывается писателем)
+        void                                intReleaseSnapshots();
 
-        //           
-        nodes_vector_type                   intGetNodePathCreate(const TrieStrings::StringOfChars<TCharType>& key, size_t keyLength);
+        // Определить, есть ли снимки, разделяющие узлы с деревом (вызывается писателем)
+        bool                                intHasSnapshots();
 
-		//       
-		/*
-		 *     ,      
-		 *   
-		 */
-		nodes_vector_type                   intGetNodePathGreatEq(const TrieStrings::StringOfChars<TCharType>& key, size_t keyLength) const;
+        // Получить счетчик изменений дерева
+        /*
+         * Счетчик увеличивается каждым изменением дерева, при котором узлы могут
+         * быть созданы, заменены или исключены. Построители, хранящие указатели
+         * на узлы между вызовами, по нему обнаруживают изменения в обход себя
+         */
+        size_t                              intGetModificationCount() const;
 
+        // Найти дочерний элемент для изменения
+        /*
+         * Элементы цепочки дочерних элементов родителя до найденного (или до места
+         * вставки) включительно, разделяемые со снимками, заменяются копиями.
+         * Родитель должен быть доступен для изменения.
+         *
+         * prevNode - последний элемент с меньшим символом (nullptr - если такого нет)
+         */
+        node_type*                          intFindChildWritable(node_type* parentNode, TCharType keyChar, node_type*& prevNode);
+
+        // Разрушение всех узлов дерева
+        /*
+         * Если узлы размещены в собственной арене дерева и значения не требуют
+         * вызова деструкторов, то узлы не обходятся - арена освобождается целиком
+         */
+        void                                intDestroyNodes();
+
+        // Получить узел для указанного значения ключа
+        iterator_type                       intGetNodeSimple(const TCharType* key, size_t keyLength);
+        const_iterator_type                 intGetNodeSimple(const TCharType* key, size_t keyLength) const;
+
+        // Получить узел для указанного значения ключа без построения пути
+        const node_type*                    intFindNode(const TCharType* key, size_t keyLength) const;
+
+        // Групповой поиск значений (getKey(keyIndex) возвращает key_view_type ключа)
+        template <typename KeyAccessor>
+        size_t                              intFindBatch(KeyAccessor getKey, size_t count, const TValueType** results) const;
+
+        // Получить первый узел для поиска символа среди дочерних элементов
+        /*
+         * При наличии массива символов (ChildLabelsExt) - сразу узел с символом
+         * (nullptr - если его нет), иначе - первый элемент цепочки
+         */
+        static const node_type*             intGetBatchChild(const node_type* parentNode, TCharType keyChar);
+
+        // Получить итератор с путем к узлу дерева по ключу (путь строится сразу в итераторе)
+        template <typename IteratorType>
+        IteratorType                        intGetNodePathSimple(const TCharType* key, size_t keyLength) const;
+
+		// Получить итератор на первый ключ, больший или равный указанному
+		template <typename IteratorType>
+		IteratorType intGetLowerBound(const TCharType* key, size_t keyLength) const;
+
+		// Получить итератор на первый ключ дерева
 		template <typename IteratorType>
-		IteratorType intGetLowerBound(const TrieStrings::StringOfChars<TCharType>& key) const;
+		IteratorType intGetBegin() const;
+
+		// Получить итератор на ключ с указанным порядковым номером
+		template <typename IteratorType>
+		IteratorType intSelect(size_t index) const;
+
+        // Учет количества ключей в поддеревьях (без SubtreeCountExt - пустые операции)
+        /*
+         * intAddPathSubtreeCount изменяет счетчики корня и первых depth узлов
+         * пути по ключу (узлы пути должны существовать и быть доступны для изменения)
+         */
+        static size_t                       intGetSubtreeCount(const node_type* node);
+        static void                         intAddSubtreeCount(node_type* node, ptrdiff_t delta);
+        void                                intAddPathSubtreeCount(const TCharType* key, size_t depth, ptrdiff_t delta);
+
+        // Учет наибольших значений в поддеревьях (без SubtreeMaxValueExt - пустые операции)
+        /*
+         * intComputeSubtreeMaxValue        - наибольшее из значения узла и значений поддеревьев дочерних элементов
+         * intRaiseSubtreeMaxValue          - учет нового значения в поддереве узла
+         * intRebuildSubtreeMaxValues       - пересчет значений всех узлов поддерева (после построения поддерева)
+         * intUpdatePathSubtreeMaxValue     - пересчет значений первых depth узлов пути по ключу
+         *                                    и корня после изменения последнего из них
+         *                                    (узлы пути должны быть доступны для изменения)
+         */
+        static TValueType                   intComputeSubtreeMaxValue(const node_type* node);
+        static void                         intRaiseSubtreeMaxValue(node_type* node, const TValueType& value);
+        static void                         intRebuildSubtreeMaxValues(node_type* node);
+        void                                intUpdatePathSubtreeMaxValue(const TCharType* key, size_t depth);
+
+        // Добавление значения ключа, построенного из указанных аргументов
+        /*
+         * bAssign - заменять ли значение найденного ключа
+         * Возвращает узел ключа и признак добавления нового ключа
+         */
+        template<typename... Args>
+        std::pair<node_type*, bool>         intEmplace(const TCharType* keyBuf, size_t keyLength, bool bAssign, Args&&... args);
+
+        // Освобождение исключенных узлов (отложенно - в режиме одновременного чтения)
+        /*
+         * intRetireNode        - замененный узел (ссылки на дочерние элементы и брата переданы новому узлу)
+         * intRetireSubtree     - исключенный узел (ссылка на брата передана предыдущему элементу)
+         * intReleaseNode       - освобождение ссылки на узел (узлы, на которые не остается
+         *                        ссылок, разрушаются вместе с дочерними элементами и братьями)
+         */
+        void                                intRetireNode(node_type* node);
+        void                                intRetireSubtree(node_type* node);
+        void                                intReleaseNode(node_type* node);
+
+        // Изменение цепочки дочерних элементов с поддержкой массивов символов (ChildLabelsExt)
+        /*
+         * intLinkChild, intReplaceChild, intUnlinkChild - как у узла; массив родителя
+         *                                   изменяется на месте, если хватает емкости
+         *                                   (при одновременном чтении - только добавление
+         *                                   в конец и замена), иначе строится заново
+         * intUpdateChildLabels            - построение массива узла по его цепочке
+         *                                   (прежний освобождается отложенно в режиме
+         *                                   одновременного чтения)
+         * intBuildSubtreeChildLabels      - построение массивов узла и всех его потомков
+         *                                   (после вставки поддерева, построенного без массивов)
+         */
+        void                                intLinkChild(node_type* parentNode, node_type* child, node_type* prevChild);
+        void                                intReplaceChild(node_type* parentNode, node_type* oldChild, node_type* newChild, node_type* prevChild);
+        void                                intUnlinkChild(node_type* parentNode, node_type* child, node_type* prevChild);
+        void                                intUpdateChildLabels(node_type* node);
+        void                                intBuildSubtreeChildLabels(node_type* node);
 	
 	private:
 
-        //   
-        node_type* m_rootNode = Node<TCharType, TValueType, KeyCharLess>::create();
+        // Собственная арена дерева (при размещении узлов в арене, общая со снимками)
+        std::shared_ptr<TrieArena>  m_ownArena;
+
+        // Ресурс памяти, в котором размещаются узлы дерева
+        std::pmr::memory_resource*  m_resource = nullptr;
+
+        // Корень цифрового дерева
+        node_type*                  m_rootNode = nullptr;
+
+        // Счетчик изменений дерева (см. intGetModificationCount)
+        size_t                      m_modificationCount = 0;
+
+        // Состояние снимков (создается первым снимком)
+        std::shared_ptr<SnapshotState>  m_snapshotState;
+        bool                            m_bSnapshot = false;    // Дерево является снимком
+
+        // Менеджер эпох режима одновременного чтения
+        std::unique_ptr<EpochManager>   m_ownEpochManager;
+        EpochManager*                   m_epochManager = nullptr;
     };
 
     ////////////////////////////////////////////////////////////////////////////
     //
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    class base_interator : public std::iterator<std::forward_iterator_tag, Node<typename TCharType, typename TValueType, typename KeyCharLess>* >
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    class base_interator : public std::iterator<std::forward_iterator_tag, Node<typename TCharType, typename TValueType, typename KeyCharLess, TNodeExt>* >
     {
+        friend class Trie<TCharType, TValueType, KeyCharLess, TNodeExt>;
+
     public:
 
-        using this_type         = base_interator<TCharType, TValueType, KeyCharLess>;
+        using this_type         = base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>;
+
+        // Количество уровней пути (и символов ключа), размещаемых внутри итератора
+        static constexpr size_t inline_path_length = 16;
 
-        using string_type       = TrieStrings::StringOfCharsZeroEnd<TCharType>;
-        using node_type         = Node<typename TCharType, typename TValueType, typename KeyCharLess>;
+        using string_type       = TrieStrings::StringOfCharsInline<TCharType, inline_path_length>;
+        using node_type         = Node<typename TCharType, typename TValueType, typename KeyCharLess, TNodeExt>;
         using nodes_vector_type = std::vector<node_type*>;
 
         base_interator() noexcept;
@@ -290,35 +1232,40 @@ namespace Trie
         this_type&          operator=   (this_type&& other) noexcept;
         this_type&          operator++  ();
 
-        //   ,   
+        // Получение полного ключ, которому соответствует узел
         const string_type&  getString() const;
 
 	protected:
 
-		struct TrieLevelInfo
-		{
-            TrieLevelInfo(node_type* _pNode, bool _bToChild)
-                : pNode(_pNode), bToChild(_bToChild)
-            { }
+        // Добавить узел в конец пути
+        void                intPush(node_type* node);
+
+        // Перейти к следующему узлу в порядке обхода
+        /*
+         * bToChild - признак захода в дочерние элементы текущего узла
+         */
+        void                intStep(bool bToChild);
 
-            node_type* pNode   = nullptr;  //     
-            bool       bToChild = false;    //  ,          
-		};
-        using TrieLevelInfoVector = std::vector<TrieLevelInfo>;
+        // Перейти к ближайшему узлу со значением, начиная с текущего
+        void                intSeekValue();
 
-        TrieLevelInfoVector m_path;         //     ,    
-        mutable string_type m_string;       // ,   
+    protected:
+
+        using path_type = SmallVector<node_type*, inline_path_length>;
+
+        path_type           m_path;         // Путь к узлу цифрового дерева, на который указывает итератор
+        string_type         m_string;       // Ключ, которому соответствует узел (изменяется вместе с путем)
     };
 
     ////////////////////////////////////////////////////////////////////////////
     //
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    class const_iterator : public base_interator<TCharType, TValueType, KeyCharLess>
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    class const_iterator : public base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>
     {
-        using base_iterator_type = base_interator<TCharType, TValueType, KeyCharLess>;
+        using base_iterator_type = base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>;
     public:
 
-        using this_type         = const_iterator<TCharType, TValueType, KeyCharLess>;
+        using this_type         = const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>;
 
         using base_type         = typename base_iterator_type::this_type;
         using node_type         = typename base_iterator_type::node_type;
@@ -341,13 +1288,13 @@ namespace Trie
 
     ////////////////////////////////////////////////////////////////////////////
     //
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    class iterator : public const_iterator<TCharType, TValueType, KeyCharLess>
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    class iterator : public const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>
     {
-        using base_iterator_type = const_iterator<TCharType, TValueType, KeyCharLess>;
+        using base_iterator_type = const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>;
     public:
 
-        using this_type         = iterator<TCharType, TValueType, KeyCharLess>;
+        using this_type         = iterator<TCharType, TValueType, KeyCharLess, TNodeExt>;
 
         using base_type         = typename base_iterator_type::this_type;
         using node_type         = typename base_iterator_type::node_type;
@@ -370,802 +1317,2675 @@ namespace Trie
 
 }   // namespace Trie
 
-//     
+// Имплементация методов узла цифрового дерева
 namespace Trie
 {
+    //------------------------------------------------------------------------//
+    inline
+    SubtreeCountExt::SubtreeCountExt() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    SubtreeCountExt::SubtreeCountExt(const SubtreeCountExt& other) noexcept
+        : m_subtreeCount (other.m_subtreeCount.load(std::memory_order_relaxed))
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    SubtreeCountExt&
+    SubtreeCountExt::operator=(const SubtreeCountExt& other) noexcept
+    {
+        m_subtreeCount.store(other.m_subtreeCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    SubtreeCountExt::getSubtreeCount() const
+    {
+        return m_subtreeCount.load(std::memory_order_relaxed);
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    void
+    SubtreeCountExt::addSubtreeCount(ptrdiff_t delta)
+    {
+        // Счетчик изменяет только писатель - атомарное чтение-изменение-запись не требуется
+        const size_t count = m_subtreeCount.load(std::memory_order_relaxed);
+        assert(delta >= 0 || static_cast<size_t>(-delta) <= count);
+
+        m_subtreeCount.store(count + static_cast<size_t>(delta), std::memory_order_relaxed);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TValueType>
+    SubtreeMaxValueExt<TValueType>::SubtreeMaxValueExt() noexcept
+        : m_subtreeMaxValue ((std::numeric_limits<TValueType>::lowest)())
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TValueType>
+    SubtreeMaxValueExt<TValueType>::SubtreeMaxValueExt(const SubtreeMaxValueExt& other) noexcept
+        : m_subtreeMaxValue (other.m_subtreeMaxValue.load(std::memory_order_relaxed))
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TValueType>
+    SubtreeMaxValueExt<TValueType>&
+    SubtreeMaxValueExt<TValueType>::operator=(const SubtreeMaxValueExt& other) noexcept
+    {
+        m_subtreeMaxValue.store(other.m_subtreeMaxValue.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TValueType>
+    inline
+    TValueType
+    SubtreeMaxValueExt<TValueType>::getSubtreeMaxValue() const
+    {
+        return m_subtreeMaxValue.load(std::memory_order_relaxed);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TValueType>
+    inline
+    void
+    SubtreeMaxValueExt<TValueType>::setSubtreeMaxValue(TValueType value)
+    {
+        m_subtreeMaxValue.store(value, std::memory_order_relaxed);
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    ChildLabelsExt::ChildLabelsExt() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    ChildLabelsExt::ChildLabelsExt(const ChildLabelsExt&) noexcept
+    {
+        // Массив принадлежит узлу и не копируется
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    ChildLabelsExt&
+    ChildLabelsExt::operator=(const ChildLabelsExt&) noexcept
+    {
+        // Массив описывает цепочку дочерних элементов этого узла и не заменяется
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    ChildLabelsExt::~ChildLabelsExt()
+    {
+        freeChildLabels(m_pChildLabels.load(std::memory_order_relaxed), nullptr);
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    const ChildLabelsExt::Labels*
+    ChildLabelsExt::getChildLabels() const
+    {
+        return m_pChildLabels.load(std::memory_order_acquire);
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    ChildLabelsExt::Labels*
+    ChildLabelsExt::exchangeChildLabels(Labels* labels)
+    {
+        // Массив публикуется уже заполненным
+        return m_pChildLabels.exchange(labels, std::memory_order_acq_rel);
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    void
+    ChildLabelsExt::freeChildLabels(void* labels, void*)
+    {
+        if (!labels)
+            return;
+
+        Labels* header = static_cast<Labels*>(labels);
+        std::pmr::memory_resource* resource = header->pResource;
+        const size_t blockSize = header->blockSize;
+
+        header->~Labels();
+        resource->deallocate(header, blockSize, alignof(Labels));
+    }
+
 	//------------------------------------------------------------------------//
 	template<typename KeyCharLess, typename TCharType>
 	bool is_key_less(TCharType ch1, TCharType ch2)
 	{
-		return ch1 == ch2 ? false : KeyCharLess()(ch1, ch2);
+		using key_traits = key_char_traits<TCharType, KeyCharLess>;
+		return key_traits::less(key_traits::fold(ch1), key_traits::fold(ch2));
+	}
+
+	//------------------------------------------------------------------------//
+	template<typename KeyCharLess, typename TCharType>
+	bool is_key_eq(TCharType ch1, TCharType ch2)
+	{
+		using key_traits = key_char_traits<TCharType, KeyCharLess>;
+		return key_traits::eq(key_traits::fold(ch1), key_traits::fold(ch2));
 	}
 
-	//------------------------------------------------------------------------//
-	template<typename KeyCharLess, typename TCharType>
-	bool is_key_eq(TCharType ch1, TCharType ch2)
-	{
-		KeyCharLess less;
-		return ch1 == ch2 ? true : (!less(ch1, ch2) && !less(ch2, ch1));
-	}
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::create(std::pmr::memory_resource* resource)
+    {
+        void* memory = resource->allocate(sizeof(node_type), alignof(node_type));
+        return new (memory) Node<TCharType, TValueType, KeyCharLess, TNodeExt>();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::create(std::pmr::memory_resource* resource, TCharType keyChar)
+    {
+        void* memory = resource->allocate(sizeof(node_type), alignof(node_type));
+        return new (memory) Node<TCharType, TValueType, KeyCharLess, TNodeExt>(keyChar);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::create(std::pmr::memory_resource* resource, TCharType keyChar, TValueType value)
+    {
+        return createEmplace(resource, keyChar, std::move(value));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    template<typename... Args>
+    typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::createEmplace(std::pmr::memory_resource* resource, TCharType keyChar, Args&&... args)
+    {
+        void* memory = resource->allocate(sizeof(node_type), alignof(node_type));
+        try
+        {
+            return new (memory) Node<TCharType, TValueType, KeyCharLess, TNodeExt>(keyChar, std::in_place, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            resource->deallocate(memory, sizeof(node_type), alignof(node_type));
+            throw;
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::destroy(std::pmr::memory_resource* resource, node_type* node)
+    {
+        // Узлы образуют двоичное дерево (дочерний элемент / следующий брат).
+        // Поворачиваем его так, чтобы у текущего узла не оставалось дочерних
+        // элементов, после чего узел можно разрушить и перейти к следующему
+        while (node)
+        {
+            if (node_type* child = node->m_pChild.load(std::memory_order_relaxed))
+            {
+                node->m_pChild.store(child->m_pNext.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                child->m_pNext.store(node, std::memory_order_relaxed);
+                node = child;
+            }
+            else
+            {
+                node_type* next = node->m_pNext.load(std::memory_order_relaxed);
+
+                node->~Node();
+                resource->deallocate(node, sizeof(node_type), alignof(node_type));
+
+                node = next;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::destroySubtree(std::pmr::memory_resource* resource, node_type* node)
+    {
+        if (!node)
+            return;
+
+        destroy(resource, node->m_pChild.load(std::memory_order_relaxed));
+
+        node->~Node();
+        resource->deallocate(node, sizeof(node_type), alignof(node_type));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::release(std::pmr::memory_resource* resource, node_type* node)
+    {
+        if (!node || node->m_refCount == max_ref_count || --node->m_refCount > 0)
+            return;
+
+        // Как в destroy, двоичное дерево освобождаемых узлов поворачивается.
+        // Следующий брат освобождаемого узла - либо ссылка, либо (после поворота)
+        // возврат к освобождаемому родителю, у которого ссылок уже нет
+        while (node)
+        {
+            if (node_type* child = node->m_pChild.load(std::memory_order_relaxed))
+            {
+                if (child->m_refCount != max_ref_count && 0 == --child->m_refCount)
+                {
+                    node->m_pChild.store(child->m_pNext.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    child->m_pNext.store(node, std::memory_order_relaxed);
+                    node = child;
+                }
+                else
+                {
+                    node->m_pChild.store(nullptr, std::memory_order_relaxed);
+                }
+            }
+            else
+            {
+                node_type* next = node->m_pNext.load(std::memory_order_relaxed);
+
+                node->~Node();
+                resource->deallocate(node, sizeof(node_type), alignof(node_type));
+
+                if (next && next->m_refCount != 0)
+                {
+                    if (next->m_refCount == max_ref_count || --next->m_refCount > 0)
+                        next = nullptr;
+                }
+
+                node = next;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::Node() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::Node(TCharType keyChar)
+        : m_keyChar (key_traits::fold(keyChar))
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    template<typename... Args>
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::Node(TCharType keyChar, std::in_place_t, Args&&... args)
+        : m_keyChar (key_traits::fold(keyChar))
+    {
+        new (m_value) TValueType(std::forward<Args>(args)...);
+        m_bHaveValue = true;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::~Node()
+    {
+        // Дочерние элементы и братья разрушаются методом destroy()
+        intResetValue();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::setKeyChar(TCharType keyChar)
+    {
+        m_keyChar = key_traits::fold(keyChar);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    TCharType
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::getKeyChar() const
+    {
+        return m_keyChar;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    bool
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::haveValue() const
+    {
+        return m_bHaveValue;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::setValue(TValueType value)
+    {
+        static_assert(!has_value_dependent_ext, "Значения узлов с SubtreeCountExt/SubtreeMaxValueExt изменяются через дерево");
+
+        intEmplaceValue(std::move(value));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    const TValueType&
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::getValue() const
+    {
+        assert(m_bHaveValue);
+        return *intGetValuePtr();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::value_reference
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::getValue()
+    {
+        assert(m_bHaveValue);
+        return *intGetValuePtr();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    template<typename... Args>
+    TValueType&
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::emplaceValue(Args&&... args)
+    {
+        static_assert(!has_value_dependent_ext, "Значения узлов с SubtreeCountExt/SubtreeMaxValueExt изменяются через дерево");
+
+        return intEmplaceValue(std::forward<Args>(args)...);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::resetValue()
+    {
+        static_assert(!has_value_dependent_ext, "Значения узлов с SubtreeCountExt/SubtreeMaxValueExt изменяются через дерево");
+
+        intResetValue();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    template<typename... Args>
+    TValueType&
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::intEmplaceValue(Args&&... args)
+    {
+        if (m_bHaveValue)
+        {
+            // Старое значение сохраняется, если построение нового значения завершится исключением
+            *intGetValuePtr() = TValueType(std::forward<Args>(args)...);
+        }
+        else
+        {
+            new (m_value) TValueType(std::forward<Args>(args)...);
+            m_bHaveValue = true;
+        }
+
+        return *intGetValuePtr();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::intResetValue()
+    {
+        if (m_bHaveValue)
+        {
+            m_bHaveValue = false;
+            intGetValuePtr()->~TValueType();
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    TValueType*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::intGetValuePtr()
+    {
+        return std::launder(reinterpret_cast<TValueType*>(m_value));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    const TValueType*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::intGetValuePtr() const
+    {
+        return std::launder(reinterpret_cast<const TValueType*>(m_value));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::setNext(typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type* next)
+    {
+        m_pNext.store(next, std::memory_order_release);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::getNext() const
+    {
+        return m_pNext.load(std::memory_order_acquire);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::getBrotherSimple(TCharType keyChar)
+    {
+		return intGetBrotherSimple(this, keyChar);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    const typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::getBrotherSimple(TCharType keyChar) const
+    {
+		return intGetBrotherSimple(this, keyChar);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::getBrotherEqOrGreatSimple(TCharType keyChar)
+    {
+		return intGetBrotherEqOrGreatSimple(this, keyChar);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    const typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::getBrotherEqOrGreatSimple(TCharType keyChar) const
+    {
+		return intGetBrotherEqOrGreatSimple(this, keyChar);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::setChild(typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type* child)
+    {
+        m_pChild.store(child, std::memory_order_release);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::getChildSimple() const
+    {
+        return m_pChild.load(std::memory_order_acquire);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::getChildCreate(TCharType keyChar, bool& bCreated, std::pmr::memory_resource* resource)
+    {
+        node_type* prevChild = nullptr;
+        node_type* child = findChild(keyChar, prevChild);
+
+        bCreated = !child;
+        if (!child)
+        {
+            child = Node::create(resource, keyChar);
+            linkChild(child, prevChild);
+        }
+
+        return child;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::findChild(TCharType keyChar, node_type*& prevChild) const
+    {
+        // Символы в узлах хранятся приведенными - приведем искомый символ один раз
+        keyChar = key_traits::fold(keyChar);
+
+        prevChild = nullptr;
+
+        node_type* child = getChildSimple();
+        while (child && key_traits::less(child->getKeyChar(), keyChar))
+        {
+            prevChild = child;
+            child = child->getNext();
+        }
+
+        return child && key_traits::eq(child->getKeyChar(), keyChar) ? child : nullptr;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::findChild(TCharType keyChar) const
+    {
+        if constexpr (has_child_labels)
+        {
+            if (const ChildLabelsExt::Labels* labels = this->getChildLabels())
+            {
+                const size_t count = labels->count.load(std::memory_order_acquire);
+                const size_t index = intFindLabel(labels, count, key_traits::fold(keyChar));
+                return index < count ? intGetLabelChildren(labels)[index].load(std::memory_order_acquire) : nullptr;
+            }
+        }
+
+        node_type* child = getChildSimple();
+        return child ? child->getBrotherSimple(keyChar) : nullptr;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::findChildEqOrGreat(TCharType keyChar) const
+    {
+        if constexpr (has_child_labels)
+        {
+            if (const ChildLabelsExt::Labels* labels = this->getChildLabels())
+            {
+                const size_t count = labels->count.load(std::memory_order_acquire);
+                const size_t index = intFindLabelEqOrGreat(labels, count, key_traits::fold(keyChar));
+                return index < count ? intGetLabelChildren(labels)[index].load(std::memory_order_acquire) : nullptr;
+            }
+        }
+
+        node_type* child = getChildSimple();
+        return child ? child->getBrotherEqOrGreatSimple(keyChar) : nullptr;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::label_type
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::intToLabel(TCharType keyChar)
+    {
+        if constexpr (simd_labels)
+        {
+            // Знаковые символы упорядочиваются как беззнаковые инвертированием старшего бита
+            const uint8_t label = static_cast<uint8_t>(keyChar);
+            return std::is_signed<TCharType>::value ? static_cast<uint8_t>(label ^ 0x80) : label;
+        }
+        else
+        {
+            return keyChar;
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    std::atomic<typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*>*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::intGetLabelChildren(const ChildLabelsExt::Labels* labels)
+    {
+        return reinterpret_cast<std::atomic<node_type*>*>(const_cast<ChildLabelsExt::Labels*>(labels) + 1);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    typename Node<TCharType, TValueType, KeyCharLess, TNodeExt>::label_type*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::intGetLabelChars(const ChildLabelsExt::Labels* labels)
+    {
+        return reinterpret_cast<label_type*>(intGetLabelChildren(labels) + labels->capacity);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    size_t
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::intFindLabel(const ChildLabelsExt::Labels* labels, size_t count, TCharType keyChar)
+    {
+        const label_type* chars = intGetLabelChars(labels);
+
+        if constexpr (simd_labels)
+        {
+            return simd_find_key(chars, count, intToLabel(keyChar));
+        }
+        else
+        {
+            const label_type* found = std::lower_bound(chars, chars + count, keyChar, &key_traits::less);
+            return found != chars + count && key_traits::eq(*found, keyChar) ? static_cast<size_t>(found - chars) : count;
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    size_t
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::intFindLabelEqOrGreat(const ChildLabelsExt::Labels* labels, size_t count, TCharType keyChar)
+    {
+        const label_type* chars = intGetLabelChars(labels);
+
+        if constexpr (simd_labels)
+            return simd_lower_bound_key(chars, count, intToLabel(keyChar));
+        else
+            return static_cast<size_t>(std::lower_bound(chars, chars + count, keyChar, &key_traits::less) - chars);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    ChildLabelsExt::Labels*
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::intBuildChildLabels(std::pmr::memory_resource* resource)
+    {
+        size_t count = 0;
+        for (node_type* child = getChildSimple(); child; child = child->getNext())
+            ++count;
+
+        ChildLabelsExt::Labels* labels = nullptr;
+        if (count >= ChildLabelsExt::min_children_count)
+        {
+            // Запас емкости (половина количества) для вставки на месте;
+            // емкость кратна 16, чтобы массив символов занимал целые блоки
+            const size_t capacity  = (count + count / 2 + 15) & ~static_cast<size_t>(15);
+            const size_t blockSize = sizeof(ChildLabelsExt::Labels) + capacity * (sizeof(std::atomic<node_type*>) + sizeof(label_type));
+
+            labels = new (resource->allocate(blockSize, alignof(ChildLabelsExt::Labels))) ChildLabelsExt::Labels;
+            labels->pResource = resource;
+            labels->blockSize = blockSize;
+            labels->capacity  = capacity;
+
+            std::atomic<node_type*>* children = intGetLabelChildren(labels);
+            label_type*              chars    = intGetLabelChars(labels);
+
+            size_t index = 0;
+            for (node_type* child = getChildSimple(); child; child = child->getNext(), ++index)
+            {
+                new (children + index) std::atomic<node_type*>(child);
+                chars[index] = intToLabel(child->getKeyChar());
+            }
+            for (; index < capacity; ++index)
+            {
+                new (children + index) std::atomic<node_type*>(nullptr);
+                chars[index] = label_type();
+            }
+
+            labels->count.store(count, std::memory_order_relaxed);
+        }
+
+        return this->exchangeChildLabels(labels);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    bool
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::intInsertChildLabel(node_type* child, bool bAppendOnly)
+    {
+        const ChildLabelsExt::Labels* labels = this->getChildLabels();
+        if (!labels || (bAppendOnly && child->getNext()))
+            return false;
+
+        ChildLabelsExt::Labels* writableLabels = const_cast<ChildLabelsExt::Labels*>(labels);
+
+        const size_t count = labels->count.load(std::memory_order_relaxed);
+        if (count == labels->capacity)
+            return false;
+
+        std::atomic<node_type*>* children = intGetLabelChildren(labels);
+        label_type*              chars    = intGetLabelChars(labels);
+
+        // Сдвиг элементов за позицией вставки (без одновременных читателей)
+        const size_t index = bAppendOnly ? count : intFindLabelEqOrGreat(labels, count, child->getKeyChar());
+        for (size_t moveIndex = count; moveIndex > index; --moveIndex)
+        {
+            children[moveIndex].store(children[moveIndex - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            chars[moveIndex] = chars[moveIndex - 1];
+        }
+
+        children[index].store(child, std::memory_order_relaxed);
+        chars[index] = intToLabel(child->getKeyChar());
+
+        // Читатели видят новый элемент только после записи количества
+        writableLabels->count.store(count + 1, std::memory_order_release);
+        return true;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    bool
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::intEraseChildLabel(node_type* child)
+    {
+        const ChildLabelsExt::Labels* labels = this->getChildLabels();
+        if (!labels)
+            return false;
+
+        ChildLabelsExt::Labels* writableLabels = const_cast<ChildLabelsExt::Labels*>(labels);
+
+        const size_t count = labels->count.load(std::memory_order_relaxed);
+        const size_t index = intFindLabel(labels, count, child->getKeyChar());
+        assert(index < count && intGetLabelChildren(labels)[index].load(std::memory_order_relaxed) == child);
+
+        // Массив, заполненный меньше чем на четверть, заменяется меньшим (или удаляется)
+        if ((count - 1) * 4 < labels->capacity)
+            return false;
+
+        std::atomic<node_type*>* children = intGetLabelChildren(labels);
+        label_type*              chars    = intGetLabelChars(labels);
+
+        for (size_t moveIndex = index + 1; moveIndex < count; ++moveIndex)
+        {
+            children[moveIndex - 1].store(children[moveIndex].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            chars[moveIndex - 1] = chars[moveIndex];
+        }
+
+        children[count - 1].store(nullptr, std::memory_order_relaxed);
+        chars[count - 1] = label_type();
+
+        writableLabels->count.store(count - 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    bool
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::intReplaceChildLabel(node_type* oldChild, node_type* newChild)
+    {
+        const ChildLabelsExt::Labels* labels = this->getChildLabels();
+        if (!labels)
+            return false;
+
+        const size_t count = labels->count.load(std::memory_order_relaxed);
+        const size_t index = intFindLabel(labels, count, oldChild->getKeyChar());
+        assert(index < count && intGetLabelChildren(labels)[index].load(std::memory_order_relaxed) == oldChild);
+
+        // Новый элемент публикуется полностью заполненным
+        intGetLabelChildren(labels)[index].store(newChild, std::memory_order_release);
+        return true;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::linkChild(node_type* child, node_type* prevChild)
+    {
+        child->setNext(prevChild ? prevChild->getNext() : getChildSimple());
+
+        // Публикация элемента - после того, как он полностью заполнен
+        if (prevChild)
+            prevChild->setNext(child);
+        else
+            setChild(child);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::replaceChild(node_type* oldChild, node_type* newChild, node_type* prevChild)
+    {
+        newChild->setNext(oldChild->getNext());
+        newChild->setChild(oldChild->getChildSimple());
+
+        if (prevChild)
+            prevChild->setNext(newChild);
+        else
+            setChild(newChild);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::unlinkChild(node_type* child, node_type* prevChild)
+    {
+        if (prevChild)
+            prevChild->setNext(child->getNext());
+        else
+            setChild(child->getNext());
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    void
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::addRef()
+    {
+        if (m_refCount != max_ref_count)
+            ++m_refCount;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    bool
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::isShared() const
+    {
+        return m_refCount > 1;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Node<TCharType, TValueType, KeyCharLess, TNodeExt>::copyExt(const node_type& other)
+    {
+        static_cast<TNodeExt&>(*this) = static_cast<const TNodeExt&>(other);
+    }
+
+	//------------------------------------------------------------------------//
+	template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+	template<typename PNodeType>
+	PNodeType
+	Node<TCharType, TValueType, KeyCharLess, TNodeExt>::intGetBrotherSimple(PNodeType thisNode, TCharType keyChar) const
+	{
+		PNodeType destNode = nullptr;
+
+		keyChar = key_traits::fold(keyChar);
+
+		if (key_traits::less(keyChar, getKeyChar()))
+		{
+			// Символ меньше символа в текущем элементе - нужного элемента нет
+		}
+
+		// Если символ из ключа хранится в текущем элементе - вернем текущий элемент
+		else if (key_traits::eq(keyChar, getKeyChar()))
+		{
+			return thisNode;
+		}
+		else
+		{
+			PNodeType nodePrev = thisNode;
+			PNodeType node = getNext();
+			while (node && key_traits::less(node->getKeyChar(), keyChar))
+			{
+				nodePrev = node;
+				node = node->getNext();
+			}
+
+			if (node)
+			{
+				if (key_traits::eq(node->getKeyChar(), keyChar))
+				{
+					destNode = node;
+				}
+			}
+		}
+
+		return destNode;
+	}
+
+	//------------------------------------------------------------------------//
+	template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+	template<typename PNodeType>
+	PNodeType Node<TCharType, TValueType, KeyCharLess, TNodeExt>::intGetBrotherEqOrGreatSimple(
+		PNodeType thisNode, TCharType keyChar) const
+	{
+		PNodeType destNode = nullptr;
+
+		keyChar = key_traits::fold(keyChar);
+
+		if (key_traits::less(keyChar, getKeyChar())
+			|| key_traits::eq(keyChar, getKeyChar()))
+		{
+			return thisNode;
+		}
+		else
+		{
+			PNodeType nodePrev = thisNode;
+			PNodeType node = getNext();
+			while (node && key_traits::less(node->getKeyChar(), keyChar))
+			{
+				nodePrev = node;
+				node = node->getNext();
+			}
+
+			if (node)
+			{
+				if (key_traits::less(keyChar, node->getKeyChar())
+					|| key_traits::eq(keyChar, node->getKeyChar()))
+				{
+					destNode = node;
+				}
+			}
+		}
+
+		return destNode;
+	}
+
+}   // namespace Trie (Имплементация методов узла цифрового дерева)
+
+// Имплементация методов цифрового дерева
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::Trie(NodesAllocation allocation)
+    {
+        if (NodesAllocation::Arena == allocation)
+        {
+            m_ownArena.reset(new TrieArena());
+            m_resource = m_ownArena.get();
+        }
+        else
+        {
+            m_resource = std::pmr::new_delete_resource();
+        }
+
+        m_rootNode = node_type::create(m_resource);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::Trie(std::pmr::memory_resource* resource)
+        : m_resource (resource ? resource : std::pmr::new_delete_resource())
+    {
+        m_rootNode = node_type::create(m_resource);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::Trie(const Trie& source, node_type* rootNode)
+        : m_ownArena      (source.m_ownArena),
+          m_resource      (source.m_resource),
+          m_rootNode      (rootNode),
+          m_snapshotState (source.m_snapshotState),
+          m_bSnapshot     (true)
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::~Trie()
+    {
+        // Отложенные узлы размещены в ресурсе дерева - освободим их раньше узлов дерева
+        if (m_epochManager)
+            m_epochManager->synchronize();
+
+        if (!m_snapshotState)
+        {
+            intDestroyNodes();
+            return;
+        }
+
+        // Счетчики ссылок изменяет только писатель, а после его разрушения - снимки под мьютексом
+        std::lock_guard<std::mutex> lock(m_snapshotState->mutex);
+
+        if (m_bSnapshot && m_snapshotState->bWriterAlive)
+        {
+            m_snapshotState->releasedRoots.push_back(m_rootNode);
+            m_snapshotState->releasedCount.fetch_add(1, std::memory_order_release);
+            m_rootNode = nullptr;
+            return;
+        }
+
+        if (!m_bSnapshot)
+        {
+            m_snapshotState->bWriterAlive = false;
+
+            for (node_type* releasedRoot : m_snapshotState->releasedRoots)
+                node_type::release(m_resource, releasedRoot);
+            m_snapshotState->releasedRoots.clear();
+        }
+
+        intDestroyNodes();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    std::pmr::memory_resource*
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::getMemoryResource() const
+    {
+        return m_resource;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::enableConcurrentReads(EpochManager* epochManager)
+    {
+        if (m_epochManager)
+            return;
+
+        if (!epochManager)
+        {
+            m_ownEpochManager.reset(new EpochManager());
+            epochManager = m_ownEpochManager.get();
+        }
+
+        m_epochManager = epochManager;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    EpochManager*
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::getEpochManager() const
+    {
+        return m_epochManager;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    std::shared_ptr<const Trie<TCharType, TValueType, KeyCharLess, TNodeExt>>
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::snapshot()
+    {
+        static_assert(std::is_copy_constructible<TValueType>::value, "Снимки поддерживаются только для копируемых значений");
+
+        intReleaseSnapshots();
+
+        if (!m_snapshotState)
+            m_snapshotState = std::make_shared<SnapshotState>();
+
+        // Корень дерева не разделяется: снимок получает копию корня,
+        // разделяемыми становятся дочерние элементы корня
+        node_type* rootNode = node_type::create(m_resource);
+        rootNode->copyExt(*intGetRoot());
+        if (node_type* firstNode = intGetRoot()->getChildSimple())
+        {
+            firstNode->addRef();
+            rootNode->setChild(firstNode);
+            intUpdateChildLabels(rootNode);
+        }
+
+        std::shared_ptr<const Trie> result(new Trie(*this, rootNode));
+
+        std::lock_guard<std::mutex> lock(m_snapshotState->mutex);
+        ++m_snapshotState->snapshotsCount;
+
+        return result;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    const typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::getRootNode() const
+    {
+        return intGetRoot();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::addKeyValue(
+        const string_type& key, TValueType value)
+    {
+        return intEmplace(key.getStr(), key.length(), true, std::move(value)).first;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::addKeyValue(key_view_type key, TValueType value)
+    {
+        return intEmplace(key.data(), key.size(), true, std::move(value)).first;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::addKeyValue(const TCharType* key, size_t keyLength, TValueType value)
+    {
+        return intEmplace(key, keyLength, true, std::move(value)).first;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    template<typename... Args>
+    std::pair<typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*, bool>
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::emplace(const string_type& key, Args&&... args)
+    {
+        return intEmplace(key.getStr(), key.length(), false, std::forward<Args>(args)...);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    template<typename... Args>
+    std::pair<typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*, bool>
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::emplace(key_view_type key, Args&&... args)
+    {
+        return intEmplace(key.data(), key.size(), false, std::forward<Args>(args)...);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    std::pair<typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*, bool>
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::insert_or_assign(const string_type& key, TValueType&& value)
+    {
+        return intEmplace(key.getStr(), key.length(), true, std::move(value));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    std::pair<typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*, bool>
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::insert_or_assign(const string_type& key, const TValueType& value)
+    {
+        return intEmplace(key.getStr(), key.length(), true, value);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    std::pair<typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*, bool>
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::insert_or_assign(key_view_type key, TValueType&& value)
+    {
+        return intEmplace(key.data(), key.size(), true, std::move(value));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    std::pair<typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*, bool>
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::insert_or_assign(key_view_type key, const TValueType& value)
+    {
+        return intEmplace(key.data(), key.size(), true, value);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    template<typename... Args>
+    std::pair<typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*, bool>
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intEmplace(const TCharType* keyBuf, size_t keyLength, bool bAssign, Args&&... args)
+    {
+        assert(keyLength > 0);
+        if (0 == keyLength)
+            return { nullptr, false };
+
+        intReleaseSnapshots();
+        ++m_modificationCount;
+
+        // Получим (и создадим недостающие элементы при необходимости) родителя узла для ключа
+        node_type* parentNode = intGetRoot();
+        for (size_t keyCharIndex = 0; keyCharIndex + 1 < keyLength; ++keyCharIndex)
+        {
+            node_type* prevNode = nullptr;
+            node_type* node     = intFindChildWritable(parentNode, keyBuf[keyCharIndex], prevNode);
+            if (!node)
+            {
+                node = node_type::create(m_resource, keyBuf[keyCharIndex]);
+                intLinkChild(parentNode, node, prevNode);
+            }
+
+            parentNode = node;
+        }
+
+        const TCharType keyChar = keyBuf[keyLength - 1];
+
+        node_type* prevNode = nullptr;
+        node_type* result   = intFindChildWritable(parentNode, keyChar, prevNode);
+
+        const bool bNewKey = !result || !result->haveValue();
+        if (!bNewKey && !bAssign)
+            return { result, false };
+
+        if (!result)
+        {
+            // Новый узел публикуется уже со значением
+            result = node_type::createEmplace(m_resource, keyChar, std::forward<Args>(args)...);
+            intAddSubtreeCount(result, 1);
+            intLinkChild(parentNode, result, prevNode);
+        }
+        else if (m_epochManager)
+        {
+            // Читатели могут работать с узлом - заменим его узлом с новым значением
+            node_type* newNode = node_type::createEmplace(m_resource, result->getKeyChar(), std::forward<Args>(args)...);
+            newNode->copyExt(*result);
+            if (bNewKey)
+                intAddSubtreeCount(newNode, 1);
+            intReplaceChild(parentNode, result, newNode, prevNode);
+
+            intRetireNode(result);
+            result = newNode;
+        }
+        else
+        {
+            // Установим значение
+            result->intEmplaceValue(std::forward<Args>(args)...);
+            if (bNewKey)
+                intAddSubtreeCount(result, 1);
+        }
+
+        // Ключ добавлен в поддеревья корня и узлов пути к родителю
+        if (bNewKey)
+            intAddPathSubtreeCount(keyBuf, keyLength - 1, 1);
+
+        // Значение ключа учитывается в наибольших значениях узла и его предков
+        intUpdatePathSubtreeMaxValue(keyBuf, keyLength);
+
+        return { result, bNewKey };
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    bool
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::removeKey(const TrieStrings::StringOfChars<TCharType>& key)
+    {
+        return removeKey(key.getStr(), key.length());
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    bool
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::removeKey(key_view_type key)
+    {
+        return removeKey(key.data(), key.size());
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    bool
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::removeKey(const TCharType* keyBuf, size_t keyLength)
+    {
+        bool bResult = false;
+
+        intReleaseSnapshots();
+        ++m_modificationCount;
+
+        if (0 == keyLength)
+        {
+            if (m_epochManager)
+            {
+                // Исключим все ключи, читатели продолжают работать со старыми узлами
+                node_type* firstNode = intGetRoot()->getChildSimple();
+                intGetRoot()->setChild(nullptr);
+                intUpdateChildLabels(intGetRoot());
+                intAddSubtreeCount(intGetRoot(), -static_cast<ptrdiff_t>(intGetSubtreeCount(intGetRoot())));
+                intUpdatePathSubtreeMaxValue(keyBuf, 0);
+                intReleaseNode(firstNode);
+            }
+            else
+            {
+                // Разрушим старое дерево и создадим новое дерево
+                intDestroyNodes();
+                m_rootNode = node_type::create(m_resource);
+            }
+            bResult = true;
+        }
+
+        else
+        {
+			// Определим родитель узла для удаления, путь к нему становится доступным для изменения
+			node_type* parentNode = intGetRoot();
+			for (size_t keyCharIndex = 0; parentNode && keyCharIndex + 1 < keyLength; ++keyCharIndex)
+			{
+				node_type* prevNode = nullptr;
+				parentNode = intFindChildWritable(parentNode, keyBuf[keyCharIndex], prevNode);
+			}
+
+			// Определим узел для удаления и исключим его из цепочки дочерних элементов родителя
+			node_type* prevNode     = nullptr;
+			node_type* nodeToRemove = parentNode ? intFindChildWritable(parentNode, keyBuf[keyLength - 1], prevNode) : nullptr;
+			if (nodeToRemove)
+			{
+				intUnlinkChild(parentNode, nodeToRemove, prevNode);
+				intAddPathSubtreeCount(keyBuf, keyLength - 1, -static_cast<ptrdiff_t>(intGetSubtreeCount(nodeToRemove)));
+				intUpdatePathSubtreeMaxValue(keyBuf, keyLength - 1);
+				intRetireSubtree(nodeToRemove);
+
+				bResult = true;
+			}
+        }
+
+        return bResult;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::find(const TrieStrings::StringOfChars<TCharType>& key)
+    {
+        return intGetNodeSimple(key.getStr(), key.length());
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::find(key_view_type key)
+    {
+        return intGetNodeSimple(key.data(), key.size());
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::find(const TCharType* key, size_t keyLength)
+    {
+        return intGetNodeSimple(key, keyLength);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::const_iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::find(const TrieStrings::StringOfChars<TCharType>& key) const
+    {
+        return intGetNodeSimple(key.getStr(), key.length());
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::const_iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::find(key_view_type key) const
+    {
+        return intGetNodeSimple(key.data(), key.size());
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::const_iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::find(const TCharType* key, size_t keyLength) const
+    {
+        return intGetNodeSimple(key, keyLength);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    bool
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::contains(const TrieStrings::StringOfChars<TCharType>& key) const
+    {
+        return nullptr != get(key.getStr(), key.length());
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    bool
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::contains(key_view_type key) const
+    {
+        return nullptr != get(key.data(), key.size());
+    }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Node<TCharType, TValueType, KeyCharLess>::node_type*
-    Node<TCharType, TValueType, KeyCharLess>::create()
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    bool
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::contains(const TCharType* key, size_t keyLength) const
     {
-        return new Node<TCharType, TValueType, KeyCharLess>();
+        return nullptr != get(key, keyLength);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Node<TCharType, TValueType, KeyCharLess>::node_type*
-    Node<TCharType, TValueType, KeyCharLess>::create(TCharType keyChar)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    const TValueType*
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::get(const TrieStrings::StringOfChars<TCharType>& key) const
     {
-        return new Node<TCharType, TValueType, KeyCharLess>(keyChar);
+        return get(key.getStr(), key.length());
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Node<TCharType, TValueType, KeyCharLess>::node_type*
-    Node<TCharType, TValueType, KeyCharLess>::create(TCharType keyChar, TValueType value)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    const TValueType*
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::get(key_view_type key) const
     {
-        return new Node<TCharType, TValueType, KeyCharLess>(keyChar, value);
+        return get(key.data(), key.size());
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Node<TCharType, TValueType, KeyCharLess>::node_type*
-    Node<TCharType, TValueType, KeyCharLess>::clone(typename Node<TCharType, TValueType, KeyCharLess>::node_type* node)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    const TValueType*
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::get(const TCharType* key, size_t keyLength) const
     {
-        node_type* newNode = create(node->getKeyChar(), node->getValue());
-        newNode->setNext(node->getNext());
-        newNode->setChild(node->getChildSimple());
+        const node_type* node = intFindNode(key, keyLength);
 
-        return newNode;
+        return node && node->haveValue() ? &node->getValue() : nullptr;
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    Node<TCharType, TValueType, KeyCharLess>::Node() noexcept
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    bool
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::try_get(const TrieStrings::StringOfChars<TCharType>& key, TValueType& value) const
     {
+        return try_get(key_view_type(key.getStr(), key.length()), value);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    Node<TCharType, TValueType, KeyCharLess>::Node(TCharType keyChar)
-        : m_keyChar (keyChar)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    bool
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::try_get(key_view_type key, TValueType& value) const
     {
+        const TValueType* foundValue = get(key.data(), key.size());
+        if (!foundValue)
+            return false;
+
+        value = *foundValue;
+
+        return true;
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    Node<TCharType, TValueType, KeyCharLess>::Node(TCharType keyChar, TValueType value)
-        : m_keyChar (keyChar),
-          m_value   (value)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    std::pair<size_t, const TValueType*>
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::longest_prefix(const TCharType* buf, size_t len) const
     {
+        std::pair<size_t, const TValueType*> result(0, nullptr);
+
+        all_prefixes(buf, len, [&result](size_t length, const TValueType& value)
+        {
+            result.first  = length;
+            result.second = &value;
+        });
+
+        return result;
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    Node<TCharType, TValueType, KeyCharLess>::~Node()
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    template<typename Callback>
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::all_prefixes(const TCharType* buf, size_t len, Callback callback) const
     {
-        delete m_pChild;
-        m_pChild = nullptr;
+        size_t foundCount = 0;
+
+        const node_type* currentNode = intGetRoot();
+        for (size_t charIndex = 0; charIndex < len; ++charIndex)
+        {
+            // Получим на вложенном уровне элемент для текущего символа текста
+            currentNode = currentNode->findChild(buf[charIndex]);
+            if (!currentNode)
+                break;
 
-        delete m_pNext;
-        m_pNext = nullptr;
+            if (currentNode->haveValue())
+            {
+                callback(charIndex + 1, currentNode->getValue());
+                ++foundCount;
+            }
+        }
+
+        return foundCount;
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    void
-    Node<TCharType, TValueType, KeyCharLess>::setKeyChar(TCharType keyChar)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::find_batch(
+        const TrieStrings::StringOfChars<TCharType>* const* keys, size_t count, const TValueType** results) const
     {
-        m_keyChar = keyChar;
+        return intFindBatch([keys](size_t keyIndex) { return key_view_type(keys[keyIndex]->getStr(), keys[keyIndex]->length()); },
+                            count, results);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    inline
-    TCharType
-    Node<TCharType, TValueType, KeyCharLess>::getKeyChar() const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::find_batch(const key_view_type* keys, size_t count, const TValueType** results) const
     {
-        return m_keyChar;
+        return intFindBatch([keys](size_t keyIndex) { return keys[keyIndex]; }, count, results);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    bool
-    Node<TCharType, TValueType, KeyCharLess>::haveValue() const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::find_batch(
+        const TCharType* const* keys, const size_t* keyLengths, size_t count, const TValueType** results) const
     {
-        return m_value != get_undefined_value<TValueType>();
+        return intFindBatch([keys, keyLengths](size_t keyIndex) { return key_view_type(keys[keyIndex], keyLengths[keyIndex]); },
+                            count, results);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    void
-    Node<TCharType, TValueType, KeyCharLess>::setValue(TValueType value)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    template<typename KeyAccessor>
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intFindBatch(KeyAccessor getKey, size_t count, const TValueType** results) const
     {
-        m_value = value;
+        using key_traits = typename node_type::key_traits;
+
+        // Количество одновременно выполняемых поисков
+        static constexpr size_t batch_group_size = 16;
+
+        // Состояние поиска: текущий узел в цепочке братьев и позиция в ключе
+        struct LookupState
+        {
+            const node_type*    pNode;
+            const TCharType*    pKey;
+            size_t              keyLength;
+            size_t              keyCharIndex;
+            TCharType           keyChar;        // Приведенный текущий символ ключа
+            size_t              resultIndex;
+        };
+
+        size_t foundCount = 0;
+
+        for (size_t groupStart = 0; groupStart < count; groupStart += batch_group_size)
+        {
+            const size_t groupEnd = std::min(count, groupStart + batch_group_size);
+
+            LookupState states[batch_group_size];
+            size_t      activeCount = 0;
+
+            for (size_t keyIndex = groupStart; keyIndex < groupEnd; ++keyIndex)
+            {
+                results[keyIndex] = nullptr;
+
+                const key_view_type key = getKey(keyIndex);
+                if (key.empty())
+                    continue;
+
+                const TCharType  keyChar   = key_traits::fold(key[0]);
+                const node_type* firstNode = intGetBatchChild(intGetRoot(), keyChar);
+                if (!firstNode)
+                    continue;
+
+                prefetch_node(firstNode);
+
+                states[activeCount++] = { firstNode, key.data(), key.size(), 0, keyChar, keyIndex };
+            }
+
+            // На каждом шаге каждый активный поиск выполняет один переход между узлами
+            while (activeCount)
+            {
+                for (size_t stateIndex = 0; stateIndex < activeCount; )
+                {
+                    LookupState& state = states[stateIndex];
+                    const node_type* node = state.pNode;
+
+                    const node_type* nextNode = nullptr;
+                    if (key_traits::eq(node->getKeyChar(), state.keyChar))
+                    {
+                        if (++state.keyCharIndex == state.keyLength)
+                        {
+                            if (node->haveValue())
+                            {
+                                results[state.resultIndex] = &node->getValue();
+                                ++foundCount;
+                            }
+                        }
+                        else
+                        {
+                            state.keyChar = key_traits::fold(state.pKey[state.keyCharIndex]);
+                            nextNode = intGetBatchChild(node, state.keyChar);
+                        }
+                    }
+                    else if (key_traits::less(node->getKeyChar(), state.keyChar))
+                    {
+                        nextNode = node->getNext();
+                    }
+
+                    if (nextNode)
+                    {
+                        prefetch_node(nextNode);
+                        state.pNode = nextNode;
+                        ++stateIndex;
+                    }
+                    else
+                    {
+                        // Поиск завершен - на его место переносится последний активный поиск
+                        state = states[--activeCount];
+                    }
+                }
+            }
+        }
+
+        return foundCount;
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
     inline
-    const TValueType&
-    Node<TCharType, TValueType, KeyCharLess>::getValue() const
+    const typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intGetBatchChild(const node_type* parentNode, TCharType keyChar)
     {
-        return m_value;
+        if constexpr (node_type::has_child_labels)
+        {
+            if (parentNode->getChildLabels())
+                return parentNode->findChild(keyChar);
+        }
+
+        return parentNode->getChildSimple();
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    void
-    Node<TCharType, TValueType, KeyCharLess>::setNext(typename Node<TCharType, TValueType, KeyCharLess>::node_type* next)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::lower_bound(const TrieStrings::StringOfChars<TCharType>& key)
+    {
+		return intGetLowerBound<iterator_type>(key.getStr(), key.length());
+	}
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::lower_bound(key_view_type key)
     {
-        m_pNext = next;
+        return intGetLowerBound<iterator_type>(key.data(), key.size());
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    inline
-    typename Node<TCharType, TValueType, KeyCharLess>::node_type*
-    Node<TCharType, TValueType, KeyCharLess>::getNext() const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::lower_bound(const TCharType* key, size_t keyLength)
     {
-        return m_pNext;
+        return intGetLowerBound<iterator_type>(key, keyLength);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Node<TCharType, TValueType, KeyCharLess>::node_type*
-    Node<TCharType, TValueType, KeyCharLess>::getBrotherSimple(TCharType keyChar)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::const_iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::lower_bound(const TrieStrings::StringOfChars<TCharType>& key) const
     {
-		return intGetBrotherSimple(this, keyChar);
+		return intGetLowerBound<const_iterator_type>(key.getStr(), key.length());
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    const typename Node<TCharType, TValueType, KeyCharLess>::node_type*
-    Node<TCharType, TValueType, KeyCharLess>::getBrotherSimple(TCharType keyChar) const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::const_iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::lower_bound(key_view_type key) const
     {
-		return intGetBrotherSimple(this, keyChar);
+        return intGetLowerBound<const_iterator_type>(key.data(), key.size());
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Node<TCharType, TValueType, KeyCharLess>::node_type*
-    Node<TCharType, TValueType, KeyCharLess>::getBrotherEqOrGreatSimple(TCharType keyChar)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::const_iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::lower_bound(const TCharType* key, size_t keyLength) const
     {
-		return intGetBrotherEqOrGreatSimple(this, keyChar);
+        return intGetLowerBound<const_iterator_type>(key, keyLength);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    const typename Node<TCharType, TValueType, KeyCharLess>::node_type*
-    Node<TCharType, TValueType, KeyCharLess>::getBrotherEqOrGreatSimple(TCharType keyChar) const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    template<typename Callback>
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::fuzzy_search(
+        const TrieStrings::StringOfChars<TCharType>& key, size_t maxDistance, Callback callback) const
     {
-		return intGetBrotherEqOrGreatSimple(this, keyChar);
+        return fuzzy_search(key_view_type(key.getStr(), key.length()), maxDistance, std::move(callback));
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Node<TCharType, TValueType, KeyCharLess>::node_type*
-    Node<TCharType, TValueType, KeyCharLess>::getBrotherCreate(TCharType keyChar, bool& bCreated)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    template<typename Callback>
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::fuzzy_search(key_view_type key, size_t maxDistance, Callback callback) const
     {
-        node_type* destNode = nullptr;
-        bCreated = false;
+        using key_traits = typename node_type::key_traits;
 
-        if (is_key_less<KeyCharLess>(keyChar, getKeyChar()))
-        {
-            node_type* newNode = Node::clone(this);
-            setNext(newNode);
-            setChild(nullptr);
+        const TCharType* keyBuf    = key.data();
+        const size_t     keyLength = key.size();
 
-            setKeyChar(keyChar);
-            setValue(get_undefined_value<TValueType>());
+        // Символы искомого ключа приводятся к виду, в котором они хранятся в узлах
+        std::vector<TCharType> foldedKey(keyLength);
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+            foldedKey[keyCharIndex] = key_traits::fold(keyBuf[keyCharIndex]);
 
-            destNode = this;
+        // Строки матрицы расстояний для узлов пути (строка depth - для узла глубины depth).
+        // Расстояния, превышающие maxDistance, ограничиваются значением overflowDistance
+        const size_t rowLength        = keyLength + 1;
+        const size_t overflowDistance = maxDistance + 1;
 
-            bCreated = true;
-        }
+        std::vector<size_t> rows(rowLength);
+        for (size_t column = 0; column < rowLength; ++column)
+            rows[column] = (std::min)(column, overflowDistance);
 
-        //         -   
-        else if (is_key_eq<KeyCharLess>(keyChar, getKeyChar()))
-        {
-            return this;
-        }
-        else
+        SmallVector<const node_type*, base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::inline_path_length> path;
+        std::basic_string<TCharType> foundKey;
+        size_t foundCount = 0;
+
+        const node_type* node = intGetRoot()->getChildSimple();
+        while (node)
         {
-            node_type* nodePrev = this;
-            node_type* node = getNext();
-            while (node && is_key_less<KeyCharLess>(node->getKeyChar(), keyChar))
+            const size_t depth = path.size() + 1;
+            if (rows.size() < (depth + 1) * rowLength)
+                rows.resize((depth + 1) * rowLength);
+
+            const size_t* parentRow = rows.data() + (depth - 1) * rowLength;
+            size_t*       row       = rows.data() + depth * rowLength;
+
+            const TCharType nodeChar = node->getKeyChar();
+
+            row[0] = (std::min)(depth, overflowDistance);
+            size_t minDistance = row[0];
+            for (size_t column = 1; column < rowLength; ++column)
             {
-                nodePrev = node;
-                node = node->getNext();
+                size_t distance = parentRow[column - 1] + (key_traits::eq(nodeChar, foldedKey[column - 1]) ? 0 : 1);
+                distance = (std::min)(distance, parentRow[column] + 1);
+                distance = (std::min)(distance, row[column - 1] + 1);
+
+                row[column] = (std::min)(distance, overflowDistance);
+                minDistance = (std::min)(minDistance, row[column]);
             }
 
-            if (node)
-            {
-                if (is_key_eq<KeyCharLess>(node->getKeyChar(), keyChar))
-                {
-                    destNode = node;
-                }
-                else
-                {
-                    node_type* newNode = Node::create(keyChar);
-                    node_type* oldNext = nodePrev->getNext();
-                    nodePrev->setNext(newNode);
-                    newNode->setNext(oldNext);
+            foundKey.resize(depth - 1);
+            foundKey.push_back(nodeChar);
 
-                    destNode = newNode;
+            if (node->haveValue() && row[keyLength] <= maxDistance)
+            {
+                callback(foundKey, node->getValue(), row[keyLength]);
+                ++foundCount;
+            }
 
-                    bCreated = true;
-                }
+            // Расстояния в поддереве не меньше минимума строки узла
+            const node_type* firstChild = minDistance <= maxDistance ? node->getChildSimple() : nullptr;
+            if (firstChild)
+            {
+                path.push_back(node);
+                node = firstChild;
+                continue;
             }
-            else
+
+            // Переход к следующему брату узла или ближайшего предка
+            node = node->getNext();
+            while (!node && !path.empty())
             {
-                node_type* newNode = Node::create(keyChar);
-                nodePrev->setNext(newNode);
+                node = path.back()->getNext();
+                path.pop_back();
+            }
+        }
+
+        return foundCount;
+    }
 
-                destNode = newNode;
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::size() const
+    {
+        static_assert(has_subtree_counts, "Количество ключей хранится только в узлах с SubtreeCountExt");
 
-                bCreated = true;
-            }
+        return intGetSubtreeCount(intGetRoot());
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::count_prefix(const TrieStrings::StringOfChars<TCharType>& prefix) const
+    {
+        return count_prefix(key_view_type(prefix.getStr(), prefix.length()));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::count_prefix(key_view_type prefix) const
+    {
+        static_assert(has_subtree_counts, "Количество ключей хранится только в узлах с SubtreeCountExt");
+
+        if (prefix.empty())
+            return size();
+
+        const node_type* node = intFindNode(prefix.data(), prefix.size());
+
+        return node ? intGetSubtreeCount(node) : 0;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::count_range(
+        const TrieStrings::StringOfChars<TCharType>& lo, const TrieStrings::StringOfChars<TCharType>& hi) const
+    {
+        return count_range(key_view_type(lo.getStr(), lo.length()), key_view_type(hi.getStr(), hi.length()));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::count_range(key_view_type lo, key_view_type hi) const
+    {
+        const size_t loRank = rank(lo);
+        const size_t hiRank = rank(hi);
+
+        return hiRank > loRank ? hiRank - loRank : 0;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::rank(const TrieStrings::StringOfChars<TCharType>& key) const
+    {
+        return rank(key_view_type(key.getStr(), key.length()));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::rank(key_view_type key) const
+    {
+        static_assert(has_subtree_counts, "Количество ключей хранится только в узлах с SubtreeCountExt");
+
+        using key_traits = typename node_type::key_traits;
+
+        const TCharType* keyBuf    = key.data();
+        const size_t     keyLength = key.size();
+
+        size_t result = 0;
+
+        const node_type* parentNode = intGetRoot();
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            const TCharType keyChar = key_traits::fold(keyBuf[keyCharIndex]);
+
+            // Поддеревья братьев с меньшими символами содержат только меньшие ключи
+            const node_type* node = parentNode->getChildSimple();
+            for (; node && key_traits::less(node->getKeyChar(), keyChar); node = node->getNext())
+                result += intGetSubtreeCount(node);
+
+            if (!node || !key_traits::eq(node->getKeyChar(), keyChar))
+                break;
+
+            // Ключ узла - собственный префикс искомого ключа, т.е. меньше него
+            if (keyCharIndex + 1 < keyLength && node->haveValue())
+                ++result;
+
+            parentNode = node;
         }
 
-        return destNode;
+        return result;
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    void
-    Node<TCharType, TValueType, KeyCharLess>::setChild(typename Node<TCharType, TValueType, KeyCharLess>::node_type* child)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::select(size_t index)
     {
-        m_pChild = child;
+        return intSelect<iterator_type>(index);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Node<TCharType, TValueType, KeyCharLess>::node_type*
-    Node<TCharType, TValueType, KeyCharLess>::getChildSimple() const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::const_iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::select(size_t index) const
     {
-        return m_pChild;
+        return intSelect<const_iterator_type>(index);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    inline
-    typename Node<TCharType, TValueType, KeyCharLess>::node_type*
-    Node<TCharType, TValueType, KeyCharLess>::getChildCreate(bool& bCreated)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    std::vector<std::pair<std::basic_string<TCharType>, TValueType>>
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::top_k(const TrieStrings::StringOfChars<TCharType>& prefix, size_t k) const
     {
-        bCreated = false;
+        static_assert(has_subtree_max_values, "Наибольшие значения поддеревьев хранятся только в узлах с SubtreeMaxValueExt");
+
+        using key_traits = typename node_type::key_traits;
+
+        std::vector<std::pair<std::basic_string<TCharType>, TValueType>> result;
+        if (0 == k)
+            return result;
 
-        if (!m_pChild)
+        // Узлы, достигнутые поиском, и индексы их родителей (для восстановления ключей)
+        struct ReachedNode
         {
-            m_pChild = Node::create();
-            bCreated = true;
+            const node_type*    pNode;
+            size_t              parentIndex;
+        };
+
+        // Кандидат: поддерево узла (оценка - наибольшее значение в нем) или значение узла
+        struct Candidate
+        {
+            TValueType          score;
+            bool                bValue;
+            size_t              reachedIndex;
+        };
+
+        // Первыми извлекаются большие оценки, при равных оценках - значения,
+        // затем узлы, достигнутые раньше
+        auto candidateLess = [](const Candidate& candidate1, const Candidate& candidate2)
+        {
+            if (candidate1.score < candidate2.score || candidate2.score < candidate1.score)
+                return candidate1.score < candidate2.score;
+            if (candidate1.bValue != candidate2.bValue)
+                return candidate2.bValue;
+            return candidate1.reachedIndex > candidate2.reachedIndex;
+        };
+
+        static constexpr size_t no_parent = static_cast<size_t>(-1);
+
+        std::vector<ReachedNode> reachedNodes;
+        std::priority_queue<Candidate, std::vector<Candidate>, decltype(candidateLess)> candidates(candidateLess);
+
+        auto reachNode = [&](const node_type* node, size_t parentIndex)
+        {
+            reachedNodes.push_back({ node, parentIndex });
+            candidates.push({ node->getSubtreeMaxValue(), false, reachedNodes.size() - 1 });
+        };
+
+        // Поиск начинается с узла префикса, для пустого префикса - с дочерних элементов корня.
+        // Ключи найденных узлов начинаются с символов префикса до узла префикса
+        std::basic_string<TCharType> keyBase;
+        if (const size_t prefixLength = prefix.length())
+        {
+            const node_type* prefixNode = intFindNode(prefix.getStr(), prefixLength);
+            if (!prefixNode)
+                return result;
+
+            for (size_t keyCharIndex = 0; keyCharIndex + 1 < prefixLength; ++keyCharIndex)
+                keyBase.push_back(key_traits::fold(prefix.getStr()[keyCharIndex]));
+
+            reachNode(prefixNode, no_parent);
+        }
+        else
+        {
+            for (const node_type* node = intGetRoot()->getChildSimple(); node; node = node->getNext())
+                reachNode(node, no_parent);
+        }
+
+        while (!candidates.empty() && result.size() < k)
+        {
+            const Candidate candidate = candidates.top();
+            candidates.pop();
+
+            const node_type* node = reachedNodes[candidate.reachedIndex].pNode;
+
+            if (candidate.bValue)
+            {
+                // Значение больше оценок всех остальных кандидатов
+                std::basic_string<TCharType> key;
+                for (size_t reachedIndex = candidate.reachedIndex; reachedIndex != no_parent; reachedIndex = reachedNodes[reachedIndex].parentIndex)
+                    key.push_back(reachedNodes[reachedIndex].pNode->getKeyChar());
+                std::reverse(key.begin(), key.end());
+
+                result.emplace_back(keyBase + key, node->getValue());
+                continue;
+            }
+
+            // Раскроем поддерево: значение узла и поддеревья дочерних элементов
+            if (node->haveValue())
+                candidates.push({ node->getValue(), true, candidate.reachedIndex });
+
+            for (const node_type* child = node->getChildSimple(); child; child = child->getNext())
+                reachNode(child, candidate.reachedIndex);
         }
 
-        return m_pChild;
+        return result;
     }
 
 	//------------------------------------------------------------------------//
-	template<typename TCharType, typename TValueType, typename KeyCharLess>
-	template<typename PNodeType>
-	PNodeType
-	Node<TCharType, TValueType, KeyCharLess>::intGetBrotherSimple(PNodeType thisNode, TCharType keyChar) const
+	template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+	template <typename IteratorType>
+	IteratorType
+	Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intSelect(size_t index) const
 	{
-		PNodeType destNode = nullptr;
+		static_assert(has_subtree_counts, "Количество ключей хранится только в узлах с SubtreeCountExt");
 
-		if (is_key_less<KeyCharLess>(keyChar, getKeyChar()))
-		{
-			//       -   
-		}
+		IteratorType it;
+		base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>& itBase = it;
 
-		//         -   
-		else if (is_key_eq<KeyCharLess>(keyChar, getKeyChar()))
-		{
-			return thisNode;
-		}
-		else
+		node_type* node = intGetRoot()->getChildSimple();
+		while (node)
 		{
-			PNodeType nodePrev = thisNode;
-			PNodeType node = getNext();
-			while (node && is_key_less<KeyCharLess>(node->getKeyChar(), keyChar))
+			// Пропустим поддеревья, целиком предшествующие искомому ключу
+			const size_t count = intGetSubtreeCount(node);
+			if (index >= count)
 			{
-				nodePrev = node;
+				index -= count;
 				node = node->getNext();
+				continue;
 			}
 
-			if (node)
+			itBase.intPush(node);
+
+			if (node->haveValue())
 			{
-				if (is_key_eq<KeyCharLess>(node->getKeyChar(), keyChar))
-				{
-					destNode = node;
-				}
+				if (0 == index)
+					return it;
+
+				--index;
 			}
+
+			node = node->getChildSimple();
 		}
 
-		return destNode;
+		return IteratorType();
 	}
 
 	//------------------------------------------------------------------------//
-	template<typename TCharType, typename TValueType, typename KeyCharLess>
-	template<typename PNodeType>
-	PNodeType Node<TCharType, TValueType, KeyCharLess>::intGetBrotherEqOrGreatSimple(
-		PNodeType thisNode, TCharType keyChar) const
+	template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+	template <typename IteratorType>
+	IteratorType
+	Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intGetLowerBound(const TCharType* key, size_t keyLength) const
 	{
-		PNodeType destNode = nullptr;
+		if (0 == keyLength)
+			return intGetBegin<IteratorType>();
 
-		if (is_key_less<KeyCharLess>(keyChar, getKeyChar())
-			|| is_key_eq<KeyCharLess>(keyChar, getKeyChar()))
-		{
-			return thisNode;
-		}
-		else
+		IteratorType it;
+		base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>& itBase = it;
+
+		node_type* parentNode = intGetRoot();
+		for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
 		{
-			PNodeType nodePrev = thisNode;
-			PNodeType node = getNext();
-			while (node && is_key_less<KeyCharLess>(node->getKeyChar(), keyChar))
-			{
-				nodePrev = node;
-				node = node->getNext();
-			}
+			const TCharType keyChar = key[keyCharIndex];
 
-			if (node)
+			// Получим на вложенном уровне первый элемент, больший или равный символу ключа
+			node_type* currentNode = parentNode->findChildEqOrGreat(keyChar);
+
+			if (!currentNode)
 			{
-				if (is_key_less<KeyCharLess>(keyChar, node->getKeyChar())
-					|| is_key_eq<KeyCharLess>(keyChar, node->getKeyChar()))
+				// Все ключи поддерева меньше искомого - переходим за поддерево
+				if (!itBase.m_path.empty())
 				{
-					destNode = node;
+					itBase.intStep(false);
+					itBase.intSeekValue();
 				}
+
+				return it;
 			}
+
+			itBase.intPush(currentNode);
+
+			// Если символ полученного узла больше символа ключа, все ключи его поддерева больше искомого
+			if (!is_key_eq<KeyCharLess>(keyChar, currentNode->getKeyChar()))
+				break;
+
+			parentNode = currentNode;
 		}
 
-		return destNode;
+		itBase.intSeekValue();
+
+		return it;
 	}
 
-}   // namespace Trie (    )
+	//------------------------------------------------------------------------//
+	template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+	template <typename IteratorType>
+	IteratorType
+	Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intGetBegin() const
+	{
+		IteratorType it;
+		base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>& itBase = it;
+
+		if (node_type* firstChild = intGetRoot()->getChildSimple())
+		{
+			itBase.intPush(firstChild);
+			itBase.intSeekValue();
+		}
+
+		return it;
+	}
 
-//    
-namespace Trie
-{
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    Trie<TCharType, TValueType, KeyCharLess>::Trie() noexcept
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::const_iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::cbegin() const
     {
+        return intGetBegin<const_iterator_type>();
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    Trie<TCharType, TValueType, KeyCharLess>::~Trie()
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::const_iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::cend() const
     {
-        intResetRoot(nullptr);
+        return const_iterator_type();
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Trie<TCharType, TValueType, KeyCharLess>::node_type*
-    Trie<TCharType, TValueType, KeyCharLess>::addKeyValue(
-        const string_type& key, TValueType value)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::begin()
     {
-        //  (     )    
-        iterator_type it = intGetNodeCreate(key, key.length());
-        assert(it != end());
-
-        node_type* result = *it;
+        return intGetBegin<iterator_type>();
+    }
 
-        //  
-        result->setValue(value);
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::end()
+    {
+        return iterator_type();
+    }
 
-        return result;
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intGetRoot() const
+    {
+        return m_rootNode;
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    bool
-    Trie<TCharType, TValueType, KeyCharLess>::removeKey(const TrieStrings::StringOfChars<TCharType>& key)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intDestroyNodes()
     {
-        bool bResult = false;
+        // Арену, общую со снимками, освобождает последний владелец
+        const bool bArenaOwner = m_ownArena && m_ownArena.use_count() == 1;
 
-        if (0 == key.length())
+        if (bArenaOwner && std::is_trivially_destructible<TValueType>::value)
         {
-			//       
-            intResetRoot(Node<TCharType, TValueType, KeyCharLess>::create());
-            bResult = true;
+            m_ownArena->release();
         }
-
         else
         {
-			auto nodePath = intGetNodePathSimple(key, key.length());
-			if (!nodePath.empty())
-			{
-				auto nodePathBackIt = nodePath.rbegin();
+            node_type::release(m_resource, m_rootNode);
 
-				//    
-				node_type* nodeToRemove = *(nodePathBackIt++);
+            if (bArenaOwner)
+                m_ownArena->release();
+        }
 
-				//     
-				node_type* parentNode = nodePathBackIt != nodePath.rend() ? *(nodePathBackIt++) : intGetRoot();
+        m_rootNode = nullptr;
+    }
 
-				//      ?
-				if (parentNode->getChildSimple() == nodeToRemove)
-				{
-					parentNode->setChild(nodeToRemove->getNext());
-					nodeToRemove->setNext(nullptr);
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intRetireNode(node_type* node)
+    {
+        // Указатели узла сохраняются для читателей до его разрушения
+        auto deleter = [](void* object, void* context)
+        {
+            node_type* retiredNode = static_cast<node_type*>(object);
+            retiredNode->setNext(nullptr);
+            retiredNode->setChild(nullptr);
 
-					bResult = true;
-				}
+            node_type::release(static_cast<std::pmr::memory_resource*>(context), retiredNode);
+        };
 
-				//      
-				else
-				{
-					node_type* nodePrev = nullptr;
-					for (node_type* node = parentNode->getChildSimple(); node != nullptr; node = node->getNext())
-					{
-						if (node == nodeToRemove)
-						{
-							nodePrev->setNext(nodeToRemove->getNext());
-							nodeToRemove->setNext(nullptr);
+        if (m_epochManager)
+            m_epochManager->retire(node, deleter, m_resource);
+        else
+            deleter(node, m_resource);
+    }
 
-							bResult = true;
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intRetireSubtree(node_type* node)
+    {
+        auto deleter = [](void* object, void* context)
+        {
+            node_type* retiredNode = static_cast<node_type*>(object);
+            retiredNode->setNext(nullptr);
 
-							break;
-						}
+            node_type::release(static_cast<std::pmr::memory_resource*>(context), retiredNode);
+        };
 
-						nodePrev = node;
-					}
-				}
+        if (m_epochManager)
+            m_epochManager->retire(node, deleter, m_resource);
+        else
+            deleter(node, m_resource);
+    }
 
-				delete nodeToRemove;
-			}
-        }
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intReleaseNode(node_type* node)
+    {
+        if (!node)
+            return;
 
-        return bResult;
+        auto deleter = [](void* object, void* context)
+        {
+            node_type::release(static_cast<std::pmr::memory_resource*>(context), static_cast<node_type*>(object));
+        };
+
+        if (m_epochManager)
+            m_epochManager->retire(node, deleter, m_resource);
+        else
+            deleter(node, m_resource);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Trie<TCharType, TValueType, KeyCharLess>::iterator_type
-    Trie<TCharType, TValueType, KeyCharLess>::find(const TrieStrings::StringOfChars<TCharType>& key)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intLinkChild(node_type* parentNode, node_type* child, node_type* prevChild)
     {
-        return intGetNodeSimple(key, key.length());
+        parentNode->linkChild(child, prevChild);
+
+        if constexpr (node_type::has_child_labels)
+        {
+            // Одновременные читатели не должны видеть сдвиг элементов массива
+            if (!parentNode->intInsertChildLabel(child, m_epochManager != nullptr))
+                intUpdateChildLabels(parentNode);
+        }
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Trie<TCharType, TValueType, KeyCharLess>::const_iterator_type
-    Trie<TCharType, TValueType, KeyCharLess>::find(const TrieStrings::StringOfChars<TCharType>& key) const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intReplaceChild(node_type* parentNode, node_type* oldChild, node_type* newChild, node_type* prevChild)
     {
-        return intGetNodeSimple(key, key.length());
+        parentNode->replaceChild(oldChild, newChild, prevChild);
+
+        if constexpr (node_type::has_child_labels)
+        {
+            // Новый элемент получил цепочку дочерних элементов заменяемого
+            intUpdateChildLabels(newChild);
+
+            if (!parentNode->intReplaceChildLabel(oldChild, newChild))
+                intUpdateChildLabels(parentNode);
+        }
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Trie<TCharType, TValueType, KeyCharLess>::iterator_type
-    Trie<TCharType, TValueType, KeyCharLess>::lower_bound(const TrieStrings::StringOfChars<TCharType>& key)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intUnlinkChild(node_type* parentNode, node_type* child, node_type* prevChild)
     {
-		return intGetLowerBound<iterator_type>(key);
-	}
+        parentNode->unlinkChild(child, prevChild);
+
+        if constexpr (node_type::has_child_labels)
+        {
+            if (m_epochManager || !parentNode->intEraseChildLabel(child))
+                intUpdateChildLabels(parentNode);
+        }
+    }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Trie<TCharType, TValueType, KeyCharLess>::const_iterator_type
-    Trie<TCharType, TValueType, KeyCharLess>::lower_bound(const TrieStrings::StringOfChars<TCharType>& key) const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intUpdateChildLabels(node_type* node)
     {
-		return intGetLowerBound<const_iterator_type>(key);
+        if constexpr (node_type::has_child_labels)
+        {
+            ChildLabelsExt::Labels* oldLabels = node->intBuildChildLabels(m_resource);
+
+            // Читатели могут работать с прежним массивом
+            if (oldLabels && m_epochManager)
+                m_epochManager->retire(oldLabels, &ChildLabelsExt::freeChildLabels, nullptr);
+            else
+                ChildLabelsExt::freeChildLabels(oldLabels, nullptr);
+        }
     }
 
-	//------------------------------------------------------------------------//
-	template<typename TCharType, typename TValueType, typename KeyCharLess>
-	template <typename IteratorType>
-	IteratorType
-	Trie<TCharType, TValueType, KeyCharLess>::intGetLowerBound(const TrieStrings::StringOfChars<TCharType>& key) const
-	{
-		auto nodePath = intGetNodePathGreatEq(key, key.length());
-		IteratorType it(nodePath);
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intBuildSubtreeChildLabels(node_type* node)
+    {
+        if constexpr (node_type::has_child_labels)
+        {
+            nodes_vector_type stack(1, node);
+            while (!stack.empty())
+            {
+                node_type* current = stack.back();
+                stack.pop_back();
 
-		//        -    
-		if (!nodePath.empty() && !nodePath.back()->haveValue())
-		{
-			++it;
-		}
+                intUpdateChildLabels(current);
 
-		return it;
-	}
+                for (node_type* child = current->getChildSimple(); child; child = child->getNext())
+                {
+                    if (child->getChildSimple())
+                        stack.push_back(child);
+                }
+            }
+        }
+    }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Trie<TCharType, TValueType, KeyCharLess>::const_iterator_type
-    Trie<TCharType, TValueType, KeyCharLess>::cbegin() const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intReleaseSnapshots()
     {
-        const_iterator_type it;
+        if (!m_snapshotState || 0 == m_snapshotState->releasedCount.load(std::memory_order_acquire))
+            return;
 
-        if (node_type* firstChild = intGetRoot()->getChildSimple())
+        std::vector<node_type*> releasedRoots;
         {
-            it = const_iterator_type({ firstChild });
-            ++it;
+            std::lock_guard<std::mutex> lock(m_snapshotState->mutex);
+
+            releasedRoots.swap(m_snapshotState->releasedRoots);
+            m_snapshotState->releasedCount.store(0, std::memory_order_relaxed);
+            m_snapshotState->snapshotsCount -= releasedRoots.size();
         }
 
-        return it;
+        // Корни снимков недоступны читателям дерева, а узлы, которые читатели
+        // еще могут получить, сохраняют ссылки дерева - освобождаем сразу
+        for (node_type* releasedRoot : releasedRoots)
+            node_type::release(m_resource, releasedRoot);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Trie<TCharType, TValueType, KeyCharLess>::const_iterator_type
-    Trie<TCharType, TValueType, KeyCharLess>::cend() const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    bool
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intHasSnapshots()
     {
-        return const_iterator_type();
+        intReleaseSnapshots();
+
+        if (!m_snapshotState)
+            return false;
+
+        std::lock_guard<std::mutex> lock(m_snapshotState->mutex);
+        return m_snapshotState->snapshotsCount > 0;
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Trie<TCharType, TValueType, KeyCharLess>::iterator_type
-    Trie<TCharType, TValueType, KeyCharLess>::begin()
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intGetModificationCount() const
     {
-        iterator_type it;
-
-        if (node_type* firstChild = intGetRoot()->getChildSimple())
-        {
-            it = iterator_type({ firstChild });
-            ++it;
-        }
-
-        return it;
+        return m_modificationCount;
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Trie<TCharType, TValueType, KeyCharLess>::iterator_type
-    Trie<TCharType, TValueType, KeyCharLess>::end()
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    size_t
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intGetSubtreeCount(const node_type* node)
     {
-        return iterator_type();
+        if constexpr (has_subtree_counts)
+            return node->getSubtreeCount();
+        else
+            return 0;
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Trie<TCharType, TValueType, KeyCharLess>::node_type*
-    Trie<TCharType, TValueType, KeyCharLess>::intGetRoot() const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    void
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intAddSubtreeCount(node_type* node, ptrdiff_t delta)
     {
-        return m_rootNode;
+        if constexpr (has_subtree_counts)
+            node->addSubtreeCount(delta);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
     void
-    Trie<TCharType, TValueType, KeyCharLess>::intResetRoot(node_type* newRoot)
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intAddPathSubtreeCount(const TCharType* key, size_t depth, ptrdiff_t delta)
     {
-        delete m_rootNode;
-        m_rootNode = newRoot;
+        if constexpr (has_subtree_counts)
+        {
+            node_type* node = intGetRoot();
+            node->addSubtreeCount(delta);
+
+            for (size_t keyCharIndex = 0; keyCharIndex < depth; ++keyCharIndex)
+            {
+                node = node->findChild(key[keyCharIndex]);
+                assert(node && !node->isShared());
+
+                node->addSubtreeCount(delta);
+            }
+        }
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Trie<TCharType, TValueType, KeyCharLess>::iterator_type
-    Trie<TCharType, TValueType, KeyCharLess>::intGetNodeCreate(
-        const TrieStrings::StringOfChars<TCharType>& key, size_t keyLength)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    TValueType
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intComputeSubtreeMaxValue(const node_type* node)
     {
-        return iterator_type(intGetNodePathCreate(key, keyLength));
+        if constexpr (has_subtree_max_values)
+        {
+            TValueType maxValue = node->haveValue() ? node->getValue() : (std::numeric_limits<TValueType>::lowest)();
+
+            for (const node_type* child = node->getChildSimple(); child; child = child->getNext())
+                maxValue = (std::max)(maxValue, child->getSubtreeMaxValue());
+
+            return maxValue;
+        }
+        else
+        {
+            return TValueType();
+        }
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Trie<TCharType, TValueType, KeyCharLess>::iterator_type
-    Trie<TCharType, TValueType, KeyCharLess>::intGetNodeSimple(
-        const TrieStrings::StringOfChars<TCharType>& key, size_t keyLength)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    void
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intRaiseSubtreeMaxValue(node_type* node, const TValueType& value)
     {
-        return iterator_type(intGetNodePathSimple(key, keyLength));
+        if constexpr (has_subtree_max_values)
+        {
+            if (node->getSubtreeMaxValue() < value)
+                node->setSubtreeMaxValue(value);
+        }
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Trie<TCharType, TValueType, KeyCharLess>::const_iterator_type
-    Trie<TCharType, TValueType, KeyCharLess>::intGetNodeSimple(
-        const TrieStrings::StringOfChars<TCharType>& key, size_t keyLength) const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intRebuildSubtreeMaxValues(node_type* node)
     {
-        return const_iterator_type(intGetNodePathSimple(key, keyLength));
+        if constexpr (has_subtree_max_values)
+        {
+            // Обход в глубину: узел пересчитывается после всех своих дочерних элементов
+            std::vector<std::pair<node_type*, bool>> stack;
+            stack.emplace_back(node, false);
+
+            while (!stack.empty())
+            {
+                node_type* currentNode     = stack.back().first;
+                const bool bChildrenReady  = stack.back().second;
+
+                if (bChildrenReady)
+                {
+                    stack.pop_back();
+                    currentNode->setSubtreeMaxValue(intComputeSubtreeMaxValue(currentNode));
+                    continue;
+                }
+
+                stack.back().second = true;
+                for (node_type* child = currentNode->getChildSimple(); child; child = child->getNext())
+                    stack.emplace_back(child, false);
+            }
+        }
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Trie<TCharType, TValueType, KeyCharLess>::nodes_vector_type
-    Trie<TCharType, TValueType, KeyCharLess>::intGetNodePathSimple(
-        const TrieStrings::StringOfChars<TCharType>& key, size_t keyLength) const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intUpdatePathSubtreeMaxValue(const TCharType* key, size_t depth)
     {
-        nodes_vector_type path;
-        path.reserve(keyLength);
-
-        node_type* currentNode = intGetRoot();
-        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        if constexpr (has_subtree_max_values)
         {
-            const TCharType keyChar = key.at(keyCharIndex);
+            SmallVector<node_type*, base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::inline_path_length> path;
 
-            //    
-            currentNode = currentNode->getChildSimple();
-            if (!currentNode)
-                break;
+            node_type* node = intGetRoot();
+            path.push_back(node);
 
-            //         
-            currentNode = currentNode->getBrotherSimple(keyChar);
-            if (!currentNode)
-                break;
+            for (size_t keyCharIndex = 0; keyCharIndex < depth; ++keyCharIndex)
+            {
+                node = node->findChild(key[keyCharIndex]);
+                assert(node && !node->isShared());
 
-            path.push_back(currentNode);
-        }
+                path.push_back(node);
+            }
+
+            // Последний узел пути пересчитывается полностью
+            TValueType oldMaxValue = node->getSubtreeMaxValue();
+            TValueType newMaxValue = intComputeSubtreeMaxValue(node);
+            node->setSubtreeMaxValue(newMaxValue);
+
+            // Предки пересчитываются, пока значение изменяется. Полный пересчет
+            // нужен, только если уменьшилось значение, которое было наибольшим у предка
+            for (size_t level = path.size() - 1; level > 0 && oldMaxValue != newMaxValue; --level)
+            {
+                node = path[level - 1];
+
+                const TValueType nodeOldMaxValue = node->getSubtreeMaxValue();
+                TValueType       nodeNewMaxValue = nodeOldMaxValue;
 
-        if (!currentNode)
-            path.clear();
+                if (nodeOldMaxValue < newMaxValue)
+                    nodeNewMaxValue = newMaxValue;
+                else if (!(oldMaxValue < nodeOldMaxValue))
+                    nodeNewMaxValue = intComputeSubtreeMaxValue(node);
 
-        return path;
+                node->setSubtreeMaxValue(nodeNewMaxValue);
+
+                oldMaxValue = nodeOldMaxValue;
+                newMaxValue = nodeNewMaxValue;
+            }
+        }
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename Trie<TCharType, TValueType, KeyCharLess>::nodes_vector_type
-    Trie<TCharType, TValueType, KeyCharLess>::intGetNodePathCreate(
-        const TrieStrings::StringOfChars<TCharType>& key, size_t keyLength)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intFindChildWritable(node_type* parentNode, TCharType keyChar, node_type*& prevNode)
     {
-        nodes_vector_type path;
-        path.reserve(keyLength);
-
-        node_type* currentNode = intGetRoot();
-        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
-        {
-            const TCharType keyChar = key.at(keyCharIndex);
+        using key_traits = typename node_type::key_traits;
 
-            bool bCreated(false);
+        keyChar = key_traits::fold(keyChar);
 
-            //    
-            currentNode = currentNode->getChildCreate(bCreated);
-            if (!currentNode)
+        prevNode = nullptr;
+        for (node_type* node = parentNode->getChildSimple(); node; node = node->getNext())
+        {
+            if (key_traits::less(keyChar, node->getKeyChar()))
                 break;
 
-            //         
-            if (!bCreated)
+            // Копия разделяемого узла получает его значение и дополнительные
+            // ссылки на его дочерние элементы и брата. Разделяемые узлы создает
+            // только snapshot(), который не компилируется для некопируемых
+            // значений, поэтому для них проверка не нужна
+            if constexpr (std::is_copy_constructible<TValueType>::value)
             {
-                //         
-                currentNode = currentNode->getBrotherCreate(keyChar, bCreated);
-                if (!currentNode)
-                    break;
-            }
+                if (node->isShared())
+                {
+                    node_type* copyNode = node->haveValue()
+                        ? node_type::createEmplace(m_resource, node->getKeyChar(), node->getValue())
+                        : node_type::create(m_resource, node->getKeyChar());
+                    copyNode->copyExt(*node);
 
-            //         
-            if (bCreated)
-            {
-                currentNode->setKeyChar(keyChar);
+                    if (node_type* next = node->getNext())
+                        next->addRef();
+                    if (node_type* child = node->getChildSimple())
+                        child->addRef();
+
+                    intReplaceChild(parentNode, node, copyNode, prevNode);
+                    intReleaseNode(node);
+
+                    node = copyNode;
+                }
             }
 
-            path.push_back(currentNode);
+            if (key_traits::eq(keyChar, node->getKeyChar()))
+                return node;
+
+            prevNode = node;
         }
 
-        if (!currentNode)
-            path.clear();
+        return nullptr;
+    }
 
-        return path;
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intGetNodeSimple(
+        const TCharType* key, size_t keyLength)
+    {
+        return intGetNodePathSimple<iterator_type>(key, keyLength);
     }
 
-	//------------------------------------------------------------------------//
-	template<typename TCharType, typename TValueType, typename KeyCharLess>
-	typename Trie<TCharType, TValueType, KeyCharLess>::nodes_vector_type
-	Trie<TCharType, TValueType, KeyCharLess>::intGetNodePathGreatEq(
-		const TrieStrings::StringOfChars<TCharType>& key, size_t keyLength) const
-	{
-		nodes_vector_type path;
-		path.reserve(keyLength);
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::const_iterator_type
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intGetNodeSimple(
+        const TCharType* key, size_t keyLength) const
+    {
+        return intGetNodePathSimple<const_iterator_type>(key, keyLength);
+    }
 
-		node_type* currentNode = intGetRoot();
-		for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
-		{
-			const TCharType keyChar = key.at(keyCharIndex);
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    const typename Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intFindNode(const TCharType* key, size_t keyLength) const
+    {
+        if (0 == keyLength)
+            return nullptr;
 
-			//    
-			currentNode = currentNode->getChildSimple();
-			if (!currentNode)
-				break;
+        const node_type* currentNode = intGetRoot();
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength && currentNode; ++keyCharIndex)
+        {
+            // Получим на вложенном уровне элемент для текущего символа ключа
+            currentNode = currentNode->findChild(key[keyCharIndex]);
+        }
 
-			//         
-			currentNode = currentNode->getBrotherEqOrGreatSimple(keyChar);
-			if (!currentNode)
-				break;
+        return currentNode;
+    }
 
-			path.push_back(currentNode);
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    template <typename IteratorType>
+    IteratorType
+    Trie<TCharType, TValueType, KeyCharLess, TNodeExt>::intGetNodePathSimple(
+        const TCharType* key, size_t keyLength) const
+    {
+        IteratorType it;
+        base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>& itBase = it;
 
-			//        ,      
-			if (!is_key_eq<KeyCharLess>(keyChar, currentNode->getKeyChar()))
-				break;
-		}
+        itBase.m_path.reserve(keyLength);
+        itBase.m_string.reserve(keyLength);
 
-		if (!currentNode)
-			path.clear();
+        node_type* currentNode = intGetRoot();
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            const TCharType keyChar = key[keyCharIndex];
 
-		return path;
-	}
+            // Получим на вложенном уровне элемент для текущего символа ключа
+            currentNode = currentNode->findChild(keyChar);
+            if (!currentNode)
+            {
+                // Ключ не найден - итератор указывает на конец
+                itBase.m_path.clear();
+                itBase.m_string.clear();
+                break;
+            }
 
-}   // namespace Trie (   )
+            itBase.intPush(currentNode);
+        }
+
+        return it;
+    }
 
-//    
+}   // namespace Trie (Имплементация методов цифрового дерева)
+
+// Имплементация итераторов цифрового дерева
 namespace Trie
 {
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    base_interator<TCharType, TValueType, KeyCharLess>::base_interator() noexcept
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::base_interator() noexcept
     {
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    base_interator<TCharType, TValueType, KeyCharLess>::base_interator(
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::base_interator(
         const nodes_vector_type& nodes)
     {
-        if (!nodes.empty())
-        {
-            m_path.reserve(nodes.size());
-            for (node_type* node : nodes)
-            {
-                //          
-                m_path.push_back(TrieLevelInfo(node, false));
-            }
+        m_path.reserve(nodes.size());
+        m_string.reserve(nodes.size());
 
-            //      ,     
-            //     
-            m_path.back().bToChild = true;
+        for (node_type* node : nodes)
+        {
+            intPush(node);
         }
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    base_interator<TCharType, TValueType, KeyCharLess>::base_interator(const this_type& other)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::base_interator(const this_type& other)
         : m_path    (other.m_path),
           m_string  (other.m_string)
     {
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    base_interator<TCharType, TValueType, KeyCharLess>::base_interator(this_type&& other) noexcept
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::base_interator(this_type&& other) noexcept
         : m_path    (std::move(other.m_path)),
           m_string  (std::move(other.m_string))
     {
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename base_interator<TCharType, TValueType, KeyCharLess>::node_type*
-    base_interator<TCharType, TValueType, KeyCharLess>::operator->() const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator->() const
     {
-        return m_path.back().pNode;
+        return m_path.back();
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename base_interator<TCharType, TValueType, KeyCharLess>::node_type*
-    base_interator<TCharType, TValueType, KeyCharLess>::operator*() const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator*() const
     {
-        return m_path.back().pNode;
+        return m_path.back();
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    const typename base_interator<TCharType, TValueType, KeyCharLess>::string_type&
-    base_interator<TCharType, TValueType, KeyCharLess>::getString() const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    const typename base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::string_type&
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::getString() const
     {
-        if (m_string.empty() && !m_path.empty())
-        {
-            m_string.reserve(m_path.size() + 1);
-
-            for (const TrieLevelInfo& item : m_path)
-            {
-                m_string.appendChar(item.pNode->getKeyChar());
-            }
-        }
-
         return m_string;
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    base_interator<TCharType, TValueType, KeyCharLess>&
-    base_interator<TCharType, TValueType, KeyCharLess>::operator=(const this_type& other)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>&
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator=(const this_type& other)
     {
         m_path   = other.m_path;
         m_string = other.m_string;
@@ -1174,9 +3994,9 @@ namespace Trie
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    base_interator<TCharType, TValueType, KeyCharLess>&
-    base_interator<TCharType, TValueType, KeyCharLess>::operator=(this_type&& other) noexcept
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>&
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator=(this_type&& other) noexcept
     {
         m_path   = std::move(other.m_path);
         m_string = std::move(other.m_string);
@@ -1185,159 +4005,164 @@ namespace Trie
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    base_interator<TCharType, TValueType, KeyCharLess>&
-    base_interator<TCharType, TValueType, KeyCharLess>::operator++()
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>&
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator++()
     {
-        if (m_path.empty())
-            return *this;
-
-        bool bClearStr(false);
-
-        do
-        {
-            TrieLevelInfo& levelInfo = m_path.back();
-
-            while (true)
-            {
-                if (levelInfo.bToChild)
-                {
-                    levelInfo.bToChild = false;
-
-                    if (node_type* node = levelInfo.pNode->getChildSimple())
-                    {
-                        //          
-                        m_path.push_back(TrieLevelInfo(node, true));
-                        bClearStr = true;
-                        break;
-                    }
-                }
-
-                if (node_type* node = levelInfo.pNode->getNext())
-                {
-                    m_path.pop_back();
-                    //          
-                    m_path.push_back(TrieLevelInfo(node, true));
-                    bClearStr = true;
-                    break;
-                }
-
-                //    
-                m_path.pop_back();
-                bClearStr = true;
-
-                break;
-            }
-
-        } while (!m_path.empty() && !m_path.back().pNode->haveValue());
-
-        if (bClearStr)
+        if (!m_path.empty())
         {
-            m_string.clear();
+            intStep(true);
+            intSeekValue();
         }
 
         return *this;
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
     bool
-    base_interator<TCharType, TValueType, KeyCharLess>::operator==(
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator==(
         const this_type& other) const
     {
-        if (m_path.empty() && other.m_path.empty())
-            return true;
-
-        if (m_path.size() != other.m_path.size())
-            return false;
+        // Положение итератора однозначно определяется последним узлом пути
+        if (m_path.empty() || other.m_path.empty())
+            return m_path.empty() && other.m_path.empty();
 
-        auto itThis     = m_path.cbegin();
-		auto itEndThis  = m_path.cend();
-		auto itOther    = other.m_path.cbegin();
-        for (; itThis != itEndThis; ++itThis, ++itOther)
-        {
-            if (itThis->pNode != itOther->pNode)
-                return false;
-        }
-
-        return true;
+        return m_path.back() == other.m_path.back();
     }
     
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
     bool
-    base_interator<TCharType, TValueType, KeyCharLess>::operator!=(
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator!=(
         const this_type& other) const
     {
         return !operator==(other);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    const_iterator<TCharType, TValueType, KeyCharLess>::const_iterator() noexcept
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    inline
+    void
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::intPush(node_type* node)
+    {
+        m_path.push_back(node);
+        m_string.appendChar(node->getKeyChar());
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::intStep(bool bToChild)
+    {
+        if (bToChild)
+        {
+            if (node_type* child = m_path.back()->getChildSimple())
+            {
+                intPush(child);
+                return;
+            }
+        }
+
+        // Переходим к следующему брату текущего узла или ближайшего из предков
+        size_t depth = m_path.size();
+        while (depth)
+        {
+            if (node_type* next = m_path[depth - 1]->getNext())
+            {
+                // Ключ отличается от ключа брата только последним символом
+                m_path.resize(depth);
+                m_string.truncate(depth - 1);
+
+                m_path.back() = next;
+                m_string.appendChar(next->getKeyChar());
+                return;
+            }
+
+            --depth;
+        }
+
+        m_path.clear();
+        m_string.clear();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    void
+    base_interator<TCharType, TValueType, KeyCharLess, TNodeExt>::intSeekValue()
+    {
+        while (!m_path.empty() && !m_path.back()->haveValue())
+        {
+            intStep(true);
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::const_iterator() noexcept
     {
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    const_iterator<TCharType, TValueType, KeyCharLess>::const_iterator(
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::const_iterator(
         const nodes_vector_type& nodes)
         : base_type(nodes)
     {
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    const_iterator<TCharType, TValueType, KeyCharLess>::const_iterator(
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::const_iterator(
         const this_type& other)
         : base_type(other)
     {
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    const_iterator<TCharType, TValueType, KeyCharLess>::const_iterator(
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::const_iterator(
         this_type&& other) noexcept
-        : base_type(other)
+        : base_type(std::move(other))
     {
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
     bool
-    const_iterator<TCharType, TValueType, KeyCharLess>::operator==(const this_type& other) const
+    const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator==(const this_type& other) const
     {
         return base_type::operator==(other);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
     bool
-    const_iterator<TCharType, TValueType, KeyCharLess>::operator!=(const this_type& other) const
+    const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator!=(const this_type& other) const
     {
         return base_type::operator!=(other);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename const_iterator<TCharType, TValueType, KeyCharLess>::node_type*
-    const_iterator<TCharType, TValueType, KeyCharLess>::operator->() const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator->() const
     {
         return base_type::operator->();
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename const_iterator<TCharType, TValueType, KeyCharLess>::node_type*
-    const_iterator<TCharType, TValueType, KeyCharLess>::operator*() const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator*() const
     {
         return base_type::operator*();
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    const_iterator<TCharType, TValueType, KeyCharLess>&
-    const_iterator<TCharType, TValueType, KeyCharLess>::operator=(const this_type& other)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>&
+    const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator=(const this_type& other)
     {
         base_type::operator=(other);
 
@@ -1345,9 +4170,9 @@ namespace Trie
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    const_iterator<TCharType, TValueType, KeyCharLess>&
-    const_iterator<TCharType, TValueType, KeyCharLess>::operator=(this_type&& other) noexcept
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>&
+    const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator=(this_type&& other) noexcept
     {
         base_type::operator=(std::move(other));
 
@@ -1355,9 +4180,9 @@ namespace Trie
     }
 
     //-----------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    const_iterator<TCharType, TValueType, KeyCharLess>&
-    const_iterator<TCharType, TValueType, KeyCharLess>::operator++()
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>&
+    const_iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator++()
     {
         base_type::operator++();
 
@@ -1365,69 +4190,69 @@ namespace Trie
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    iterator<TCharType, TValueType, KeyCharLess>::iterator() noexcept
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::iterator() noexcept
     {
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    iterator<TCharType, TValueType, KeyCharLess>::iterator(
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::iterator(
         const nodes_vector_type& nodes)
         : base_type(nodes)
     {
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    iterator<TCharType, TValueType, KeyCharLess>::iterator(const this_type& other)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::iterator(const this_type& other)
         : base_type(other)
     {
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    iterator<TCharType, TValueType, KeyCharLess>::iterator(this_type&& other) noexcept
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::iterator(this_type&& other) noexcept
         : base_type(std::move(other))
     {
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
     bool
-    iterator<TCharType, TValueType, KeyCharLess>::operator==(const this_type& other) const
+    iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator==(const this_type& other) const
     {
         return base_type::operator==(other);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
     bool
-    iterator<TCharType, TValueType, KeyCharLess>::operator!=(const this_type& other) const
+    iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator!=(const this_type& other) const
     {
         return base_type::operator!=(other);
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename iterator<TCharType, TValueType, KeyCharLess>::node_type*
-    iterator<TCharType, TValueType, KeyCharLess>::operator->() const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator->() const
     {
         return base_type::operator->();
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    typename iterator<TCharType, TValueType, KeyCharLess>::node_type*
-    iterator<TCharType, TValueType, KeyCharLess>::operator*() const
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    typename iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::node_type*
+    iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator*() const
     {
         return base_type::operator*();
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    iterator<TCharType, TValueType, KeyCharLess>&
-    iterator<TCharType, TValueType, KeyCharLess>::operator=(const this_type& other)
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    iterator<TCharType, TValueType, KeyCharLess, TNodeExt>&
+    iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator=(const this_type& other)
     {
         base_type::operator=(other);
 
@@ -1435,9 +4260,9 @@ namespace Trie
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    iterator<TCharType, TValueType, KeyCharLess>&
-    iterator<TCharType, TValueType, KeyCharLess>::operator++()
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    iterator<TCharType, TValueType, KeyCharLess, TNodeExt>&
+    iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator++()
     {
         base_type::operator++();
 
@@ -1445,9 +4270,9 @@ namespace Trie
     }
 
     //------------------------------------------------------------------------//
-    template<typename TCharType, typename TValueType, typename KeyCharLess>
-    iterator<TCharType, TValueType, KeyCharLess>&
-    iterator<TCharType, TValueType, KeyCharLess>::operator=(iterator&& other) noexcept
+    template<typename TCharType, typename TValueType, typename KeyCharLess, typename TNodeExt>
+    iterator<TCharType, TValueType, KeyCharLess, TNodeExt>&
+    iterator<TCharType, TValueType, KeyCharLess, TNodeExt>::operator=(iterator&& other) noexcept
     {
         base_type::operator=(std::move(other));
 
@@ -1456,4 +4281,4 @@ namespace Trie
 
     //------------------------------------------------------------------------//
 
-}   // namespace Trie (   )
+}   // namespace Trie (Имплементация итераторов цифрового дерева)
@@ -0,0 +1,287 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <functional>
+#include <limits>
+#include <cstdint>
+
+namespace Trie
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Отложенное освобождение памяти на основе эпох
+    /*
+     * Читатели на время работы со структурой данных объявляют текущую эпоху
+     * (объект Guard). Писатель, исключив объект из структуры, передает его
+     * в retire(): объект освобождается, только когда не остается читателей,
+     * объявивших эпоху не позже эпохи исключения объекта.
+     *
+     * Читатели не блокируются и не выделяют память. Методы retire(), reclaim()
+     * и synchronize() вызываются одним потоком-писателем.
+     */
+    class EpochManager
+    {
+    public:
+
+        // Максимальное количество одновременно работающих читателей
+        static constexpr size_t max_readers = 64;
+
+        // Функция освобождения объекта
+        using deleter_type = void (*)(void* object, void* context);
+
+        ////////////////////////////////////////////////////////////////////////
+        // Защита читателя: пока объект существует, доступные читателю
+        // объекты структуры данных не освобождаются
+        class Guard
+        {
+        public:
+
+            explicit Guard(EpochManager& epochManager);
+            Guard(const Guard&) = delete;
+            Guard& operator=(const Guard&) = delete;
+            ~Guard();
+
+        private:
+
+            EpochManager&   m_epochManager;
+            size_t          m_slot;
+        };
+
+        EpochManager() noexcept;
+        EpochManager(const EpochManager&) = delete;
+        EpochManager& operator=(const EpochManager&) = delete;
+
+        // Все отложенные объекты освобождаются (читателей быть не должно)
+        ~EpochManager();
+
+        // Отложить освобождение объекта, исключенного из структуры данных
+        /**
+         * @param   object - объект
+         * @param   deleter - функция освобождения объекта
+         * @param   context - параметр функции освобождения
+         */
+        void                retire(void* object, deleter_type deleter, void* context);
+
+        // Освободить объекты, которые больше не могут использоваться читателями
+        /**
+         * @return  количество освобожденных объектов
+         */
+        size_t              reclaim();
+
+        // Дождаться завершения работающих читателей и освободить все отложенные объекты
+        void                synchronize();
+
+        // Получить количество объектов, ожидающих освобождения
+        size_t              getPendingCount() const;
+
+    private:
+
+        // Ячейка читателя (в отдельной строке кэша)
+        struct alignas(64) ReaderSlot
+        {
+            std::atomic<uint64_t>   epoch { 0 };    // 0 - ячейка свободна
+        };
+
+        // Объект, ожидающий освобождения
+        struct RetiredObject
+        {
+            void*           pObject;
+            deleter_type    pDeleter;
+            void*           pContext;
+            uint64_t        epoch;
+        };
+
+        // Количество отложенных объектов, при котором retire() пытается их освободить
+        static constexpr size_t reclaim_threshold = 64;
+
+        // Объявить текущую эпоху читателя
+        size_t              intEnter();
+
+        // Завершить работу читателя
+        void                intLeave(size_t slot);
+
+        // Получить минимальную эпоху работающих читателей
+        uint64_t            intGetMinActiveEpoch() const;
+
+    private:
+
+        std::atomic<uint64_t>       m_globalEpoch { 1 };
+        ReaderSlot                  m_slots[max_readers];
+        std::vector<RetiredObject>  m_retired;
+    };
+
+}   // namespace Trie
+
+// Имплементация методов отложенного освобождения памяти
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    inline
+    EpochManager::Guard::Guard(EpochManager& epochManager)
+        : m_epochManager (epochManager),
+          m_slot         (epochManager.intEnter())
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    EpochManager::Guard::~Guard()
+    {
+        m_epochManager.intLeave(m_slot);
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    EpochManager::EpochManager() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    EpochManager::~EpochManager()
+    {
+        for (const RetiredObject& retired : m_retired)
+        {
+            retired.pDeleter(retired.pObject, retired.pContext);
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    void
+    EpochManager::retire(void* object, deleter_type deleter, void* context)
+    {
+        // Исключение объекта из структуры должно быть видно раньше, чем новая эпоха
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        m_retired.push_back({ object, deleter, context, m_globalEpoch.load(std::memory_order_relaxed) });
+        m_globalEpoch.fetch_add(1, std::memory_order_seq_cst);
+
+        if (m_retired.size() >= reclaim_threshold)
+            reclaim();
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    EpochManager::reclaim()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // Объект, исключенный в эпоху, меньшую эпох всех читателей, им недоступен
+        const uint64_t minActiveEpoch = intGetMinActiveEpoch();
+
+        size_t keptCount = 0;
+        for (size_t retiredIndex = 0; retiredIndex < m_retired.size(); ++retiredIndex)
+        {
+            const RetiredObject& retired = m_retired[retiredIndex];
+            if (retired.epoch < minActiveEpoch)
+                retired.pDeleter(retired.pObject, retired.pContext);
+            else
+                m_retired[keptCount++] = retired;
+        }
+
+        const size_t reclaimedCount = m_retired.size() - keptCount;
+        m_retired.resize(keptCount);
+
+        return reclaimedCount;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    void
+    EpochManager::synchronize()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // Все отложенные объекты исключены в эпохи, меньшие текущей
+        const uint64_t epoch = m_globalEpoch.fetch_add(1, std::memory_order_seq_cst);
+
+        while (intGetMinActiveEpoch() <= epoch)
+        {
+            std::this_thread::yield();
+        }
+
+        reclaim();
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    EpochManager::getPendingCount() const
+    {
+        return m_retired.size();
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    EpochManager::intEnter()
+    {
+        const size_t firstSlot = std::hash<std::thread::id>()(std::this_thread::get_id()) % max_readers;
+
+        while (true)
+        {
+            for (size_t slotOffset = 0; slotOffset < max_readers; ++slotOffset)
+            {
+                const size_t slot = (firstSlot + slotOffset) % max_readers;
+
+                // Захват ячейки синхронизируется с освобождением ее прежним читателем
+                uint64_t epoch    = m_globalEpoch.load(std::memory_order_acquire);
+                uint64_t expected = 0;
+                if (!m_slots[slot].epoch.compare_exchange_strong(expected, epoch, std::memory_order_seq_cst))
+                    continue;
+
+                // Объявленная эпоха должна быть видна писателю раньше,
+                // чем читатель обратится к структуре данных
+                /*
+                 * Объявление и проверка глобальной эпохи -
+                 * seq_cst операции, как и увеличение эпохи и чтение ячеек писателем:
+                 * либо писатель увидит объявленную эпоху, либо читатель увидит новую
+                 * эпоху и объявит ее заново. Повторное объявление - exchange, чтобы не
+                 * прерывать последовательность освобождения ячейки (intLeave).
+                 */
+                while (true)
+                {
+                    const uint64_t currentEpoch = m_globalEpoch.load(std::memory_order_seq_cst);
+                    if (currentEpoch == epoch)
+                        break;
+
+                    epoch = currentEpoch;
+                    m_slots[slot].epoch.exchange(epoch, std::memory_order_seq_cst);
+                }
+
+                return slot;
+            }
+
+            // Все ячейки заняты - ждем освобождения
+            std::this_thread::yield();
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    void
+    EpochManager::intLeave(size_t slot)
+    {
+        m_slots[slot].epoch.store(0, std::memory_order_release);
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    uint64_t
+    EpochManager::intGetMinActiveEpoch() const
+    {
+        uint64_t minEpoch = (std::numeric_limits<uint64_t>::max)();
+        for (const ReaderSlot& readerSlot : m_slots)
+        {
+            const uint64_t epoch = readerSlot.epoch.load(std::memory_order_seq_cst);
+            if (epoch != 0 && epoch < minEpoch)
+                minEpoch = epoch;
+        }
+
+        return minEpoch;
+    }
+
+}   // namespace Trie (Имплементация методов отложенного освобождения памяти)
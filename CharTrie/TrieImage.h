@@ -0,0 +1,1016 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <type_traits>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "TrieData.h"
+
+namespace Trie
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Формат двоичного образа цифрового дерева
+    /*
+     * Образ не содержит указателей: все ссылки задаются смещениями от начала
+     * образа и номерами узлов, поэтому образ можно использовать по любому
+     * адресу (в том числе отображенным в память файлом) без десериализации.
+     *
+     * Состав образа (каждый раздел выровнен на 8 байт):
+     *  TrieImageHeader                 - заголовок;
+     *  TrieImageNode[nodesCount]       - узлы в порядке обхода в ширину (0 - корень),
+     *                                    дочерние элементы узла идут подряд;
+     *  TCharType[nodesCount]           - символы ключей узлов;
+     *  TValueType[valuesCount]         - значения.
+     */
+
+    // Заголовок образа
+    struct TrieImageHeader
+    {
+        char        magic[8];           // Сигнатура image_magic
+        uint32_t    version;            // Версия формата
+        uint32_t    byteOrder;          // image_byte_order в порядке байт записавшей системы
+        uint32_t    charSize;           // sizeof(TCharType)
+        uint32_t    valueSize;          // sizeof(TValueType)
+        uint64_t    nodesCount;         // Количество узлов (включая корень)
+        uint64_t    valuesCount;        // Количество значений
+        uint64_t    nodesOffset;        // Смещение массива узлов
+        uint64_t    labelsOffset;       // Смещение массива символов
+        uint64_t    valuesOffset;       // Смещение массива значений
+        uint64_t    imageSize;          // Полный размер образа
+    };
+
+    // Узел образа
+    struct TrieImageNode
+    {
+        uint32_t    firstChild;         // Номер первого дочернего элемента
+        uint32_t    childrenCount;      // Количество дочерних элементов
+        uint32_t    valueIndex;         // Номер значения (image_no_value - нет значения)
+    };
+
+    inline constexpr char     image_magic[8]    = { 'C', 'H', 'T', 'R', 'I', 'E', 0, 0 };
+    inline constexpr uint32_t image_version     = 1;
+    inline constexpr uint32_t image_byte_order  = 0x01020304;
+    inline constexpr uint32_t image_no_value    = 0xFFFFFFFF;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Построение образа по заполненному дереву
+    /**
+     * @param   trie - исходное дерево
+     * @return  образ дерева
+     */
+    template<typename TTrie>
+    std::vector<char>   make_image(const TTrie& trie);
+
+    // Запись образа дерева в файл
+    /**
+     * @param   trie - исходное дерево
+     * @param   fileName - имя файла
+     * @return  true - если образ записан
+     */
+    template<typename TTrie>
+    bool                save_image(const TTrie& trie, const char* fileName);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Файл, отображенный в память только для чтения
+    class TrieMappedFile
+    {
+    public:
+
+        TrieMappedFile() noexcept;
+        TrieMappedFile(const TrieMappedFile&) = delete;
+        TrieMappedFile& operator=(const TrieMappedFile&) = delete;
+        ~TrieMappedFile();
+
+        // Отобразить файл в память
+        /**
+         * Ранее отображенный файл закрывается.
+         *
+         * @return  true - если файл отображен
+         */
+        bool                open(const char* fileName);
+
+        // Закрыть отображение
+        void                close() noexcept;
+
+        const void*         getData() const;
+        size_t              getSize() const;
+
+    private:
+
+        const void*         m_pData = nullptr;
+        size_t              m_size  = 0;
+
+#if defined(_WIN32)
+        HANDLE              m_hFile    = INVALID_HANDLE_VALUE;
+        HANDLE              m_hMapping = nullptr;
+#endif
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Цифровое дерево только для чтения, работающее непосредственно над образом
+    template<typename TCharType, typename TValueType, typename KeyCharLess = compare_no_case>
+    class TrieImage
+    {
+        static_assert(std::is_trivially_copyable<TValueType>::value,
+                      "Значения образа должны быть тривиально копируемыми");
+
+    public:
+
+        using this_type     = TrieImage<TCharType, TValueType, KeyCharLess>;
+        using string_type   = TrieStrings::StringOfChars<TCharType>;
+        using key_traits    = key_char_traits<TCharType, KeyCharLess>;
+
+        class node_view;
+        class const_iterator;
+
+        using const_iterator_type = const_iterator;
+
+        TrieImage() noexcept;
+        TrieImage(const TrieImage&) = delete;
+        TrieImage& operator=(const TrieImage&) = delete;
+
+        // Открыть образ из файла (файл отображается в память)
+        /**
+         * @return  true - если файл открыт и содержит образ подходящего формата
+         */
+        bool                open(const char* fileName);
+
+        // Использовать образ, размещенный в памяти
+        /**
+         * Память не копируется и должна оставаться доступной, пока используется дерево.
+         * Образ должен быть выровнен на 8 байт. Проверяются заголовок, разделы
+         * и ссылки всех узлов (время проверки пропорционально количеству узлов).
+         *
+         * @return  true - если память содержит образ подходящего формата
+         */
+        bool                attach(const void* data, size_t size);
+
+        // Закрыть образ
+        void                close() noexcept;
+
+        // Признак открытого образа
+        bool                isOpen() const;
+
+        // Поиск заданного ключа (слова)
+        /**
+         * @param   key - искомый ключ
+         * @return  итератор для найденого узла по ключу.
+         *          Если не найдено, то будет возвращено cend()
+         */
+        const_iterator_type find(const string_type& key) const;
+
+        // Проверка наличия значения для заданного ключа (слова)
+        bool                contains(const string_type& key) const;
+
+        // Получение значения для заданного ключа (слова)
+        /**
+         * @return  указатель на значение, связанное с ключом.
+         *          Если значения нет, то будет возвращен nullptr
+         */
+        const TValueType*   get(const string_type& key) const;
+
+        // Поиск элемента, ключ которого больше или равен указанному
+        /**
+         * @param key - ключ
+         * @return итератор для элемента, ключ которого больше
+         *         или равен указанному ключу.
+         *         Если подходящих элементов не найдено, будет
+         *         возвращен итератор cend()
+         */
+        const_iterator_type lower_bound(const string_type& key) const;
+
+        const_iterator_type begin()  const;
+        const_iterator_type end()    const;
+        const_iterator_type cbegin() const;
+        const_iterator_type cend()   const;
+
+        // Получить количество узлов (без корня)
+        size_t              getNodesCount() const;
+
+    private:
+
+        // Найти первый дочерний элемент узла с символом, большим или равным указанному
+        /*
+         * keyChar - приведенный символ (key_char_traits::fold)
+         */
+        bool                intFindChildEqOrGreat(size_t id, TCharType keyChar, size_t& childId) const;
+
+        // Получить узел по ключу (false - если узла нет)
+        bool                intFindNode(const TCharType* key, size_t keyLength, size_t& id) const;
+
+        TCharType           intGetLabel(size_t id) const;
+        bool                intHaveValue(size_t id) const;
+        const TValueType&   intGetValue(size_t id) const;
+
+    private:
+
+        TrieMappedFile          m_file;
+
+        const TrieImageNode*    m_nodes       = nullptr;
+        const TCharType*        m_labels      = nullptr;
+        const TValueType*       m_values      = nullptr;
+        size_t                  m_nodesCount  = 0;
+        size_t                  m_valuesCount = 0;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Представление узла образа в виде узла дерева
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    class TrieImage<TCharType, TValueType, KeyCharLess>::node_view
+    {
+    public:
+
+        node_view(const this_type* trie = nullptr, size_t id = 0) noexcept
+            : m_trie(trie), m_id(id)
+        { }
+
+        TCharType           getKeyChar() const  { return m_trie->intGetLabel(m_id); }
+        bool                haveValue()  const  { return m_trie->intHaveValue(m_id); }
+        const TValueType&   getValue()   const  { return m_trie->intGetValue(m_id); }
+
+    private:
+
+        const this_type*    m_trie;
+        size_t              m_id;
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Итератор образа дерева
+    /*
+     * Обход выполняется в том же порядке, что и для Trie: в порядке возрастания ключей
+     */
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    class TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator
+    {
+        friend class TrieImage<TCharType, TValueType, KeyCharLess>;
+
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = node_view;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const node_view*;
+        using reference         = const node_view&;
+
+        using string_type       = TrieStrings::StringOfCharsZeroEnd<TCharType>;
+
+        const_iterator() noexcept;
+
+        bool                operator==  (const const_iterator& other) const;
+        bool                operator!=  (const const_iterator& other) const;
+        const node_view*    operator->  ()                            const;
+        const node_view&    operator*   ()                            const;
+
+        const_iterator&     operator++  ();
+
+        // Получение полного ключа, которому соответствует узел
+        const string_type&  getString() const;
+
+    private:
+
+        explicit const_iterator(const this_type* trie);
+
+        // Перейти к следующему узлу в порядке обхода
+        /*
+         * bToChild - признак захода в дочерние элементы текущего узла
+         */
+        void                intStep(bool bToChild);
+
+        // Перейти к ближайшему узлу со значением, начиная с текущего
+        void                intSeekValue();
+
+        // Добавить в путь узел с указанным номером
+        void                intPush(size_t id);
+
+        // Обновить представление текущего узла
+        void                intUpdateView();
+
+    private:
+
+        const this_type*        m_trie = nullptr;
+        std::vector<size_t>     m_path;             // Путь от корня к текущему узлу (без корня)
+        node_view               m_view;             // Представление текущего узла
+        mutable string_type     m_string;           // Ключ, которому соответствует узел
+        mutable bool            m_bStringActual = false;
+    };
+
+}   // namespace Trie
+
+// Имплементация построения образа
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    // Выравнивание смещения раздела образа
+    inline
+    uint64_t
+    image_align(uint64_t offset)
+    {
+        return (offset + 7) & ~uint64_t(7);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    std::vector<char>
+    make_image(const TTrie& trie)
+    {
+        using node_type  = typename TTrie::node_type;
+        using char_type  = std::decay_t<decltype(std::declval<const node_type&>().getKeyChar())>;
+        using value_type = std::decay_t<decltype(std::declval<const node_type&>().getValue())>;
+
+        static_assert(std::is_trivially_copyable<value_type>::value,
+                      "Значения образа должны быть тривиально копируемыми");
+
+        // Обход в ширину: дочерние элементы каждого узла получают номера подряд
+        std::vector<const node_type*> order(1, trie.getRootNode());
+        std::vector<TrieImageNode>    nodes;
+        std::vector<char_type>        labels;
+        std::vector<value_type>       values;
+
+        for (size_t nodeIndex = 0; nodeIndex < order.size(); ++nodeIndex)
+        {
+            const node_type* node = order[nodeIndex];
+
+            TrieImageNode imageNode = { static_cast<uint32_t>(order.size()), 0, image_no_value };
+            for (const node_type* child = node->getChildSimple(); child; child = child->getNext())
+            {
+                // Номера узлов и значений хранятся в 32 битах, image_no_value зарезервирован
+                if (order.size() >= image_no_value)
+                    throw std::length_error("make_image: too many nodes");
+
+                order.push_back(child);
+                ++imageNode.childrenCount;
+            }
+
+            if (nodeIndex != 0 && node->haveValue())
+            {
+                if (values.size() >= image_no_value)
+                    throw std::length_error("make_image: too many values");
+
+                imageNode.valueIndex = static_cast<uint32_t>(values.size());
+                values.push_back(node->getValue());
+            }
+
+            nodes.push_back(imageNode);
+            labels.push_back(nodeIndex != 0 ? node->getKeyChar() : char_type());
+        }
+
+        TrieImageHeader header = {};
+        std::memcpy(header.magic, image_magic, sizeof(header.magic));
+        header.version      = image_version;
+        header.byteOrder    = image_byte_order;
+        header.charSize     = sizeof(char_type);
+        header.valueSize    = sizeof(value_type);
+        header.nodesCount   = nodes.size();
+        header.valuesCount  = values.size();
+        header.nodesOffset  = image_align(sizeof(TrieImageHeader));
+        header.labelsOffset = image_align(header.nodesOffset  + nodes.size()  * sizeof(TrieImageNode));
+        header.valuesOffset = image_align(header.labelsOffset + labels.size() * sizeof(char_type));
+        header.imageSize    = image_align(header.valuesOffset + values.size() * sizeof(value_type));
+
+        std::vector<char> image(static_cast<size_t>(header.imageSize), 0);
+        std::memcpy(image.data(), &header, sizeof(header));
+        std::memcpy(image.data() + header.nodesOffset,  nodes.data(),  nodes.size()  * sizeof(TrieImageNode));
+        std::memcpy(image.data() + header.labelsOffset, labels.data(), labels.size() * sizeof(char_type));
+        if (!values.empty())
+            std::memcpy(image.data() + header.valuesOffset, values.data(), values.size() * sizeof(value_type));
+
+        return image;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    bool
+    save_image(const TTrie& trie, const char* fileName)
+    {
+        const std::vector<char> image = make_image(trie);
+
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        file.write(image.data(), static_cast<std::streamsize>(image.size()));
+
+        return static_cast<bool>(file);
+    }
+
+}   // namespace Trie (Имплементация построения образа)
+
+// Имплементация методов файла, отображенного в память
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    inline
+    TrieMappedFile::TrieMappedFile() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    TrieMappedFile::~TrieMappedFile()
+    {
+        close();
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    bool
+    TrieMappedFile::open(const char* fileName)
+    {
+        close();
+
+#if defined(_WIN32)
+        m_hFile = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_hFile == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER fileSize = {};
+        if (!GetFileSizeEx(m_hFile, &fileSize) || fileSize.QuadPart == 0)
+        {
+            close();
+            return false;
+        }
+
+        m_hMapping = CreateFileMappingA(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_hMapping)
+        {
+            close();
+            return false;
+        }
+
+        m_pData = MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+        if (!m_pData)
+        {
+            close();
+            return false;
+        }
+
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        const int fd = ::open(fileName, O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat fileStat = {};
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        void* pData = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        if (pData == MAP_FAILED)
+            return false;
+
+        m_pData = pData;
+        m_size  = static_cast<size_t>(fileStat.st_size);
+#endif
+
+        return true;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    void
+    TrieMappedFile::close() noexcept
+    {
+#if defined(_WIN32)
+        if (m_pData)
+            UnmapViewOfFile(m_pData);
+
+        if (m_hMapping)
+            CloseHandle(m_hMapping);
+
+        if (m_hFile != INVALID_HANDLE_VALUE)
+            CloseHandle(m_hFile);
+
+        m_hMapping = nullptr;
+        m_hFile    = INVALID_HANDLE_VALUE;
+#else
+        if (m_pData)
+            munmap(const_cast<void*>(m_pData), m_size);
+#endif
+
+        m_pData = nullptr;
+        m_size  = 0;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    const void*
+    TrieMappedFile::getData() const
+    {
+        return m_pData;
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    TrieMappedFile::getSize() const
+    {
+        return m_size;
+    }
+
+}   // namespace Trie (Имплементация методов файла, отображенного в память)
+
+// Имплементация методов образа дерева
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    TrieImage<TCharType, TValueType, KeyCharLess>::TrieImage() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    TrieImage<TCharType, TValueType, KeyCharLess>::open(const char* fileName)
+    {
+        close();
+
+        if (!m_file.open(fileName))
+            return false;
+
+        if (!attach(m_file.getData(), m_file.getSize()))
+        {
+            m_file.close();
+            return false;
+        }
+
+        return true;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    TrieImage<TCharType, TValueType, KeyCharLess>::attach(const void* data, size_t size)
+    {
+        m_nodes       = nullptr;
+        m_labels      = nullptr;
+        m_values      = nullptr;
+        m_nodesCount  = 0;
+        m_valuesCount = 0;
+
+        if (!data || size < sizeof(TrieImageHeader) || reinterpret_cast<uintptr_t>(data) % 8 != 0)
+            return false;
+
+        const char* image = static_cast<const char*>(data);
+
+        TrieImageHeader header;
+        std::memcpy(&header, image, sizeof(header));
+
+        if (std::memcmp(header.magic, image_magic, sizeof(header.magic)) != 0
+            || header.version   != image_version
+            || header.byteOrder != image_byte_order
+            || header.charSize  != sizeof(TCharType)
+            || header.valueSize != sizeof(TValueType))
+        {
+            return false;
+        }
+
+        // Разделы должны быть выровнены и целиком помещаться в образ
+        auto isSectionValid = [size](uint64_t offset, uint64_t count, uint64_t itemSize)
+        {
+            return offset % 8 == 0 && offset <= size && count <= (size - offset) / itemSize;
+        };
+
+        if (header.imageSize > size
+            || header.nodesCount == 0 || header.nodesCount > image_no_value
+            || !isSectionValid(header.nodesOffset,  header.nodesCount,  sizeof(TrieImageNode))
+            || !isSectionValid(header.labelsOffset, header.nodesCount,  sizeof(TCharType))
+            || !isSectionValid(header.valuesOffset, header.valuesCount, sizeof(TValueType)))
+        {
+            return false;
+        }
+
+        // Ссылки узлов должны оставаться внутри образа: дочерние элементы идут
+        // после родителя (обход в ширину), значения - в пределах раздела значений
+        const TrieImageNode* nodes = reinterpret_cast<const TrieImageNode*>(image + header.nodesOffset);
+        for (uint64_t id = 0; id < header.nodesCount; ++id)
+        {
+            TrieImageNode node;
+            std::memcpy(&node, nodes + id, sizeof(node));
+
+            if (node.firstChild <= id
+                || uint64_t(node.firstChild) + node.childrenCount > header.nodesCount
+                || (node.valueIndex != image_no_value && node.valueIndex >= header.valuesCount))
+            {
+                return false;
+            }
+        }
+
+        m_nodes       = nodes;
+        m_labels      = reinterpret_cast<const TCharType*>(image + header.labelsOffset);
+        m_values      = reinterpret_cast<const TValueType*>(image + header.valuesOffset);
+        m_nodesCount  = static_cast<size_t>(header.nodesCount);
+        m_valuesCount = static_cast<size_t>(header.valuesCount);
+
+        return true;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    TrieImage<TCharType, TValueType, KeyCharLess>::close() noexcept
+    {
+        m_nodes       = nullptr;
+        m_labels      = nullptr;
+        m_values      = nullptr;
+        m_nodesCount  = 0;
+        m_valuesCount = 0;
+
+        m_file.close();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    TrieImage<TCharType, TValueType, KeyCharLess>::isOpen() const
+    {
+        return m_nodesCount != 0;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    TrieImage<TCharType, TValueType, KeyCharLess>::find(const string_type& key) const
+    {
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        if (!isOpen() || 0 == keyLength)
+            return cend();
+
+        const_iterator_type it(this);
+
+        size_t id = 0;
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            const TCharType keyChar = key_traits::fold(keyBuf[keyCharIndex]);
+            if (!intFindChildEqOrGreat(id, keyChar, id) || !key_traits::eq(intGetLabel(id), keyChar))
+                return cend();
+
+            it.intPush(id);
+        }
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    TrieImage<TCharType, TValueType, KeyCharLess>::contains(const string_type& key) const
+    {
+        return nullptr != get(key);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const TValueType*
+    TrieImage<TCharType, TValueType, KeyCharLess>::get(const string_type& key) const
+    {
+        size_t id = 0;
+        if (!intFindNode(key.getStr(), key.length(), id) || id == 0 || !intHaveValue(id))
+            return nullptr;
+
+        return &intGetValue(id);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    TrieImage<TCharType, TValueType, KeyCharLess>::lower_bound(const string_type& key) const
+    {
+        if (!isOpen())
+            return cend();
+
+        const TCharType* keyBuf    = key.getStr();
+        const size_t     keyLength = key.length();
+
+        const_iterator_type it(this);
+
+        size_t id = 0;
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            const TCharType keyChar = key_traits::fold(keyBuf[keyCharIndex]);
+
+            size_t childId = 0;
+            if (!intFindChildEqOrGreat(id, keyChar, childId))
+            {
+                // Все ключи поддерева меньше искомого - переходим за поддерево
+                if (it.m_path.empty())
+                    return cend();
+
+                it.intStep(false);
+                it.intSeekValue();
+                return it;
+            }
+
+            it.intPush(childId);
+
+            // Символ не совпадает - первый ключ поддерева больше искомого
+            if (!key_traits::eq(intGetLabel(childId), keyChar))
+                break;
+
+            id = childId;
+        }
+
+        if (it.m_path.empty())
+            return cbegin();
+
+        it.intSeekValue();
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    TrieImage<TCharType, TValueType, KeyCharLess>::begin() const
+    {
+        return cbegin();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    TrieImage<TCharType, TValueType, KeyCharLess>::end() const
+    {
+        return cend();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    TrieImage<TCharType, TValueType, KeyCharLess>::cbegin() const
+    {
+        const_iterator_type it(this);
+
+        if (isOpen() && m_nodes[0].childrenCount > 0)
+        {
+            it.intPush(m_nodes[0].firstChild);
+            it.intSeekValue();
+        }
+
+        return it;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator_type
+    TrieImage<TCharType, TValueType, KeyCharLess>::cend() const
+    {
+        return const_iterator_type();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    size_t
+    TrieImage<TCharType, TValueType, KeyCharLess>::getNodesCount() const
+    {
+        return m_nodesCount ? m_nodesCount - 1 : 0;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    bool
+    TrieImage<TCharType, TValueType, KeyCharLess>::intFindChildEqOrGreat(size_t id, TCharType keyChar, size_t& childId) const
+    {
+        const TrieImageNode& node = m_nodes[id];
+        if (!node.childrenCount)
+            return false;
+
+        // Символы дочерних элементов упорядочены и хранятся приведенными
+        const TCharType* labelsBegin = m_labels + node.firstChild;
+        const TCharType* labelsEnd   = labelsBegin + node.childrenCount;
+        const TCharType* label = std::lower_bound(labelsBegin, labelsEnd, keyChar,
+            [](TCharType ch1, TCharType ch2) { return key_traits::less(ch1, ch2); });
+
+        if (label == labelsEnd)
+            return false;
+
+        childId = node.firstChild + static_cast<size_t>(label - labelsBegin);
+
+        return true;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    TrieImage<TCharType, TValueType, KeyCharLess>::intFindNode(const TCharType* key, size_t keyLength, size_t& id) const
+    {
+        id = 0;
+        if (!isOpen())
+            return false;
+
+        for (size_t keyCharIndex = 0; keyCharIndex < keyLength; ++keyCharIndex)
+        {
+            const TCharType keyChar = key_traits::fold(key[keyCharIndex]);
+            if (!intFindChildEqOrGreat(id, keyChar, id) || !key_traits::eq(intGetLabel(id), keyChar))
+                return false;
+        }
+
+        return true;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    TCharType
+    TrieImage<TCharType, TValueType, KeyCharLess>::intGetLabel(size_t id) const
+    {
+        return m_labels[id];
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    bool
+    TrieImage<TCharType, TValueType, KeyCharLess>::intHaveValue(size_t id) const
+    {
+        return m_nodes[id].valueIndex != image_no_value;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    inline
+    const TValueType&
+    TrieImage<TCharType, TValueType, KeyCharLess>::intGetValue(size_t id) const
+    {
+        return m_values[m_nodes[id].valueIndex];
+    }
+
+}   // namespace Trie (Имплементация методов образа дерева)
+
+// Имплементация итератора образа дерева
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator::const_iterator() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator::const_iterator(const this_type* trie)
+        : m_trie (trie)
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator::operator==(
+        const const_iterator& other) const
+    {
+        if (m_path.empty() || other.m_path.empty())
+            return m_path.empty() && other.m_path.empty();
+
+        // Номер узла однозначно определяет путь к нему
+        return m_trie == other.m_trie && m_path.back() == other.m_path.back();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    bool
+    TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator::operator!=(
+        const const_iterator& other) const
+    {
+        return !operator==(other);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename TrieImage<TCharType, TValueType, KeyCharLess>::node_view*
+    TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator::operator->() const
+    {
+        return &m_view;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename TrieImage<TCharType, TValueType, KeyCharLess>::node_view&
+    TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator::operator*() const
+    {
+        return m_view;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    typename TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator&
+    TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator::operator++()
+    {
+        if (!m_path.empty())
+        {
+            intStep(true);
+            intSeekValue();
+        }
+
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    const typename TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator::string_type&
+    TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator::getString() const
+    {
+        if (!m_bStringActual)
+        {
+            m_string.clear();
+            m_string.reserve(m_path.size() + 1);
+
+            for (size_t id : m_path)
+            {
+                m_string.appendChar(m_trie->intGetLabel(id));
+            }
+
+            m_bStringActual = true;
+        }
+
+        return m_string;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator::intStep(bool bToChild)
+    {
+        const TrieImageNode* nodes = m_trie->m_nodes;
+
+        if (bToChild && nodes[m_path.back()].childrenCount > 0)
+        {
+            m_path.push_back(nodes[m_path.back()].firstChild);
+            intUpdateView();
+            return;
+        }
+
+        // Переходим к следующему брату текущего узла или ближайшего из предков:
+        // братья расположены подряд в пределах блока дочерних элементов родителя
+        while (!m_path.empty())
+        {
+            const size_t         id     = m_path.back();
+            const TrieImageNode& parent = nodes[m_path.size() > 1 ? m_path[m_path.size() - 2] : 0];
+
+            if (id + 1 < size_t(parent.firstChild) + parent.childrenCount)
+            {
+                ++m_path.back();
+                break;
+            }
+
+            m_path.pop_back();
+        }
+
+        intUpdateView();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator::intSeekValue()
+    {
+        while (!m_path.empty() && !m_trie->intHaveValue(m_path.back()))
+        {
+            intStep(true);
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator::intPush(size_t id)
+    {
+        m_path.push_back(id);
+        intUpdateView();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    TrieImage<TCharType, TValueType, KeyCharLess>::const_iterator::intUpdateView()
+    {
+        m_view = m_path.empty() ? node_view() : node_view(m_trie, m_path.back());
+        m_bStringActual = false;
+    }
+
+}   // namespace Trie (Имплементация итератора образа дерева)
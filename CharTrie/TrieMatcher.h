@@ -0,0 +1,372 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+
+#include "TrieData.h"
+
+namespace Trie
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Автомат Ахо-Корасик для поиска всех ключей дерева в тексте
+    /*
+     * Неизменяемый автомат строится по заполненному дереву Trie и находит
+     * все вхождения его ключей в тексте за один проход, без повторного
+     * поиска с каждой позиции текста.
+     *
+     * Состояния автомата - узлы исходного дерева, пронумерованные обходом
+     * в ширину, поэтому дочерние состояния каждого состояния имеют
+     * последовательные номера, а их символы упорядочены по KeyCharLess.
+     * Для каждого состояния хранятся:
+     *      - ссылка неудачи: состояние для наибольшего собственного суффикса
+     *        ключа состояния, который является префиксом какого-либо ключа;
+     *      - ссылка вывода: ближайшее по ссылкам неудачи состояние со значением.
+     * Символы текста сравниваются с учетом KeyCharLess.
+     */
+    template<typename TCharType, typename TValueType, typename KeyCharLess = compare_no_case>
+    class AhoCorasickMatcher
+    {
+    public:
+
+        using this_type     = AhoCorasickMatcher<TCharType, TValueType, KeyCharLess>;
+        using key_type      = std::basic_string<TCharType>;
+        using trie_type     = Trie<TCharType, TValueType, KeyCharLess>;
+        using node_type     = typename trie_type::node_type;
+
+        ////////////////////////////////////////////////////////////////////////
+        // Состояние потокового поиска
+        /*
+         * Сохраняется между вызовами scan(), поэтому вхождения, начавшиеся
+         * в предыдущих частях текста, находятся в последующих.
+         * Одно состояние используется одним потоком, автомат может
+         * использоваться одновременно из нескольких потоков.
+         */
+        struct ScanState
+        {
+            int32_t state    = 0;   // Текущее состояние автомата
+            size_t  position = 0;   // Количество обработанных символов текста
+        };
+
+        AhoCorasickMatcher() noexcept;
+        explicit AhoCorasickMatcher(const trie_type& trie);
+
+        // Построение автомата по заполненному дереву
+        /**
+         * Предыдущее содержимое удаляется.
+         *
+         * @param trie - исходное дерево
+         */
+        void                build(const trie_type& trie);
+
+        // Найти все вхождения ключей в тексте
+        /**
+         * Вхождения сообщаются в порядке позиций их окончания, вхождения
+         * с общим окончанием - от длинного ключа к короткому.
+         *
+         * @param   buf - текст
+         * @param   len - количество символов текста
+         * @param   callback - функция callback(size_t offset, const key_type& key,
+         *          const TValueType& value), offset - позиция начала вхождения в тексте
+         * @return  количество найденных вхождений
+         */
+        template<typename Callback>
+        size_t              scan(const TCharType* buf, size_t len, Callback callback) const;
+
+        // Найти все вхождения ключей в очередной части текста
+        /**
+         * @param   scanState - состояние поиска, полученное после предыдущей части текста
+         *          (для первой части - состояние по умолчанию)
+         * @param   buf - часть текста
+         * @param   len - количество символов части текста
+         * @param   callback - функция callback(size_t offset, const key_type& key,
+         *          const TValueType& value), offset - позиция начала вхождения
+         *          от начала всего текста (может относиться к предыдущим частям)
+         * @return  количество найденных в этой части вхождений
+         */
+        template<typename Callback>
+        size_t              scan(ScanState& scanState, const TCharType* buf, size_t len, Callback callback) const;
+
+        // Получить количество состояний (с корневым)
+        size_t              getStatesCount() const;
+
+        // Получить количество ключей
+        size_t              getKeysCount() const;
+
+    private:
+
+        // Признак отсутствия состояния (значения)
+        static constexpr int32_t no_state = -1;
+
+        // Индекс корневого состояния
+        static constexpr int32_t root_state = 0;
+
+        // Переходы корня хранятся таблицей по всем значениям однобайтовых символов
+        static constexpr bool has_root_table = sizeof(TCharType) == 1;
+
+        // Найти дочернее состояние с указанным (приведенным) символом
+        int32_t             intGetChild(int32_t state, TCharType keyChar) const;
+
+        // Получить следующее состояние автомата для (приведенного) символа текста
+        int32_t             intGetNextState(int32_t state, TCharType keyChar) const;
+
+    private:
+
+        std::vector<int32_t>    m_childBegin;       // Первое дочернее состояние (дочерние состояния - [m_childBegin[s], m_childBegin[s + 1]))
+        std::vector<TCharType>  m_labels;           // Символы ключа состояний (в том виде, в котором они хранились в Trie)
+        std::vector<int32_t>    m_fail;             // Ссылки неудачи
+        std::vector<int32_t>    m_output;           // Ссылки вывода
+        std::vector<int32_t>    m_valueIndex;       // Индекс значения в m_values
+        std::vector<TValueType> m_values;           // Значения
+        std::vector<key_type>   m_keys;             // Ключи (по индексам значений)
+
+        int32_t                 m_rootTable[has_root_table ? 256 : 1];  // Переходы корня по исходным символам
+    };
+
+}   // namespace Trie
+
+// Имплементация автомата Ахо-Корасик
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    AhoCorasickMatcher<TCharType, TValueType, KeyCharLess>::AhoCorasickMatcher() noexcept
+        : m_childBegin { 1, 1 },
+          m_labels     { TCharType() },
+          m_fail       { root_state },
+          m_output     { no_state },
+          m_valueIndex { no_state }
+    {
+        std::fill(std::begin(m_rootTable), std::end(m_rootTable), no_state);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    AhoCorasickMatcher<TCharType, TValueType, KeyCharLess>::AhoCorasickMatcher(const trie_type& trie)
+    {
+        build(trie);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    void
+    AhoCorasickMatcher<TCharType, TValueType, KeyCharLess>::build(const trie_type& trie)
+    {
+        using key_traits = typename node_type::key_traits;
+
+        m_childBegin.clear();
+        m_labels.clear();
+        m_fail.clear();
+        m_output.clear();
+        m_valueIndex.clear();
+        m_values.clear();
+        m_keys.clear();
+
+        // Корневое состояние
+        m_labels.push_back(TCharType());
+        m_fail.push_back(root_state);
+        m_output.push_back(no_state);
+        m_valueIndex.push_back(no_state);
+
+        // Обход в ширину: узел исходного дерева и соответствующее ему состояние.
+        // Номера состояний назначаются в порядке постановки в очередь
+        std::deque<std::pair<const node_type*, int32_t>> queue;
+        queue.emplace_back(trie.getRootNode(), root_state);
+
+        // Ключи состояний (для состояний, ключи потомков которых еще не построены)
+        std::deque<key_type> stateKeys;
+        stateKeys.emplace_back();
+
+        while (!queue.empty())
+        {
+            const node_type* node  = queue.front().first;
+            const int32_t    state = queue.front().second;
+            queue.pop_front();
+
+            const key_type stateKey = std::move(stateKeys.front());
+            stateKeys.pop_front();
+
+            m_childBegin.push_back(static_cast<int32_t>(m_labels.size()));
+
+            for (const node_type* child = node->getChildSimple(); child; child = child->getNext())
+            {
+                const int32_t   childState = static_cast<int32_t>(m_labels.size());
+                const TCharType keyChar    = child->getKeyChar();
+
+                m_labels.push_back(keyChar);
+
+                // Ссылка неудачи: переход по символу из ближайшего по ссылкам
+                // неудачи родителя состояния, в котором такой переход есть.
+                // Состояния меньшей глубины уже построены
+                int32_t failState = root_state;
+                if (state != root_state)
+                {
+                    int32_t parentFail = m_fail[state];
+                    while (true)
+                    {
+                        const int32_t failChild = intGetChild(parentFail, keyChar);
+                        if (failChild != no_state)
+                        {
+                            failState = failChild;
+                            break;
+                        }
+                        if (parentFail == root_state)
+                            break;
+                        parentFail = m_fail[parentFail];
+                    }
+                }
+
+                m_fail.push_back(failState);
+                m_output.push_back(m_valueIndex[failState] != no_state ? failState : m_output[failState]);
+
+                key_type childKey = stateKey;
+                childKey.push_back(keyChar);
+
+                if (child->haveValue())
+                {
+                    m_valueIndex.push_back(static_cast<int32_t>(m_values.size()));
+                    m_values.push_back(child->getValue());
+                    m_keys.push_back(childKey);
+                }
+                else
+                {
+                    m_valueIndex.push_back(no_state);
+                }
+
+                queue.emplace_back(child, childState);
+                stateKeys.push_back(std::move(childKey));
+            }
+        }
+
+        m_childBegin.push_back(static_cast<int32_t>(m_labels.size()));
+
+        if (has_root_table)
+        {
+            for (size_t ch = 0; ch < 256; ++ch)
+                m_rootTable[ch] = intGetChild(root_state, key_traits::fold(static_cast<TCharType>(ch)));
+        }
+
+        m_values.shrink_to_fit();
+        m_keys.shrink_to_fit();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    template<typename Callback>
+    size_t
+    AhoCorasickMatcher<TCharType, TValueType, KeyCharLess>::scan(const TCharType* buf, size_t len, Callback callback) const
+    {
+        ScanState scanState;
+        return scan(scanState, buf, len, callback);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    template<typename Callback>
+    size_t
+    AhoCorasickMatcher<TCharType, TValueType, KeyCharLess>::scan(
+        ScanState& scanState, const TCharType* buf, size_t len, Callback callback) const
+    {
+        using key_traits = typename node_type::key_traits;
+
+        size_t matchesCount = 0;
+
+        int32_t state = scanState.state;
+        for (size_t charIndex = 0; charIndex < len; ++charIndex)
+        {
+            // Переходы корня (наиболее частые) выполняются по таблице без приведения символа
+            if (has_root_table && state == root_state)
+            {
+                state = m_rootTable[static_cast<uint8_t>(buf[charIndex])];
+                if (state == no_state)
+                {
+                    state = root_state;
+                    continue;
+                }
+            }
+            else
+            {
+                state = intGetNextState(state, key_traits::fold(buf[charIndex]));
+            }
+
+            // Ключи, оканчивающиеся в текущей позиции: ключ состояния и ключи по ссылкам вывода
+            const size_t endPosition = scanState.position + charIndex + 1;
+
+            int32_t matchState = m_valueIndex[state] != no_state ? state : m_output[state];
+            for (; matchState != no_state; matchState = m_output[matchState])
+            {
+                const int32_t   valueIndex = m_valueIndex[matchState];
+                const key_type& key        = m_keys[valueIndex];
+
+                callback(endPosition - key.size(), key, m_values[valueIndex]);
+                ++matchesCount;
+            }
+        }
+
+        scanState.state     = state;
+        scanState.position += len;
+
+        return matchesCount;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    size_t
+    AhoCorasickMatcher<TCharType, TValueType, KeyCharLess>::getStatesCount() const
+    {
+        return m_labels.size();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    size_t
+    AhoCorasickMatcher<TCharType, TValueType, KeyCharLess>::getKeysCount() const
+    {
+        return m_keys.size();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    int32_t
+    AhoCorasickMatcher<TCharType, TValueType, KeyCharLess>::intGetChild(int32_t state, TCharType keyChar) const
+    {
+        using key_traits = typename node_type::key_traits;
+
+        // Двоичный поиск по упорядоченным символам дочерних состояний
+        int32_t first = m_childBegin[state];
+        int32_t last  = m_childBegin[state + 1];
+        while (first < last)
+        {
+            const int32_t middle = first + (last - first) / 2;
+            if (key_traits::less(m_labels[middle], keyChar))
+                first = middle + 1;
+            else
+                last = middle;
+        }
+
+        return first < m_childBegin[state + 1] && key_traits::eq(m_labels[first], keyChar) ? first : no_state;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, typename TValueType, typename KeyCharLess>
+    int32_t
+    AhoCorasickMatcher<TCharType, TValueType, KeyCharLess>::intGetNextState(int32_t state, TCharType keyChar) const
+    {
+        while (true)
+        {
+            const int32_t childState = intGetChild(state, keyChar);
+            if (childState != no_state)
+                return childState;
+
+            if (state == root_state)
+                return root_state;
+
+            state = m_fail[state];
+        }
+    }
+
+}   // namespace Trie (Имплементация автомата Ахо-Корасик)
@@ -0,0 +1,743 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+
+#include "TrieData.h"
+
+namespace Trie
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Параллельное построение цифрового дерева
+    /*
+     * Пары ключ/значение разбиваются на группы по первому символу ключа
+     * (символы сравниваются KeyCharLess). Каждая группа - это поддерево одного
+     * дочернего элемента корня; группы распределяются между потоками так,
+     * чтобы суммарные длины ключей потоков были близки.
+     *
+     * Поток строит свои поддеревья независимо: при размещении узлов в арене
+     * дерева у потока своя арена, слэбы которой после построения передаются
+     * арене дерева (TrieArena::adopt), при размещении в куче узлы выделяются
+     * в куче из потока. Готовые поддеревья вставляются в упорядоченную цепочку
+     * дочерних элементов корня.
+     *
+     * Ключи, первый символ которых уже есть в дереве, а также построение
+     * в дереве с внешним ресурсом памяти добавляются последовательно (addKeyValue).
+     */
+    template<typename TTrie>
+    class ParallelTrieBuilder
+    {
+    public:
+
+        using trie_type     = TTrie;
+        using node_type     = typename trie_type::node_type;
+        using key_traits    = typename node_type::key_traits;
+        using char_type     = std::decay_t<decltype(std::declval<const node_type&>().getKeyChar())>;
+        using value_type    = std::decay_t<decltype(std::declval<const node_type&>().getValue())>;
+        using string_type   = TrieStrings::StringOfChars<char_type>;
+
+        // Создание построителя для дерева
+        /**
+         * @param   trie - заполняемое дерево (должно существовать все время работы построителя)
+         * @param   threadsCount - количество потоков (0 - по количеству ядер процессора)
+         */
+        explicit ParallelTrieBuilder(trie_type& trie, size_t threadsCount = 0);
+
+        ParallelTrieBuilder(const ParallelTrieBuilder&) = delete;
+        ParallelTrieBuilder& operator=(const ParallelTrieBuilder&) = delete;
+
+        // Добавление пар ключ/значение из диапазона
+        /**
+         * Элементы диапазона - пары (ключ, значение), ключ - std::basic_string
+         * или StringOfChars. Элементы должны существовать все время построения.
+         * Для повторяющихся ключей сохраняется значение последней пары.
+         * Пустые ключи пропускаются.
+         *
+         * @return  количество добавленных пар
+         */
+        template<typename ForwardIterator>
+        size_t              build(ForwardIterator first, ForwardIterator last);
+
+    private:
+
+        // Пара ключ/значение входного диапазона
+        struct Item
+        {
+            const char_type*    pKey;
+            size_t              keyLength;
+            value_type          value;
+        };
+
+        // Группа пар с одинаковым первым символом ключа (поддерево дочернего элемента корня)
+        struct Group
+        {
+            size_t              firstItem;      // Первый элемент группы в m_order
+            size_t              itemsCount;
+            size_t              weight;         // Суммарная длина ключей
+            node_type*          pHead = nullptr;
+        };
+
+        // Работа потока: группы и ресурс памяти для их узлов
+        struct Worker
+        {
+            std::vector<size_t>         groups;
+            size_t                      weight = 0;
+            std::unique_ptr<TrieArena>  arena;
+            std::exception_ptr          error;
+        };
+
+        static const char_type* intGetKeyData(const std::basic_string<char_type>& key) { return key.data(); }
+        static size_t           intGetKeyLength(const std::basic_string<char_type>& key) { return key.size(); }
+        static const char_type* intGetKeyData(const string_type& key) { return key.getStr(); }
+        static size_t           intGetKeyLength(const string_type& key) { return key.length(); }
+
+        // Построение поддеревьев групп потока
+        void                intBuildGroups(Worker& worker, std::pmr::memory_resource* resource);
+
+        // Построение поддерева группы
+        node_type*          intBuildGroup(const Group& group, std::pmr::memory_resource* resource) const;
+
+        // Последовательное добавление пары
+        void                intAddItem(const Item& item);
+
+    private:
+
+        trie_type&                  m_trie;
+        size_t                      m_threadsCount;
+
+        std::vector<Item>           m_items;
+        std::vector<size_t>         m_order;        // Номера пар, упорядоченные по первому символу ключа
+        std::vector<Group>          m_groups;
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Параллельный обход всех пар ключ/значение цифрового дерева
+    /*
+     * Обход разбивается на задачи по границам поддеревьев: задача - узел
+     * вместе с его дочерними элементами и ключом родителя. Каждый поток
+     * обходит поддерево своей задачи в глубину, дописывая символы в собственный
+     * буфер ключа, и выносит дочерние поддеревья в отдельные задачи, пока его
+     * очередь задач короче split_threshold.
+     *
+     * Поток берет задачи с конца своей очереди, а при ее опустошении забирает
+     * (крадет) задачи с начала очередей других потоков.
+     * Порядок посещения пар не определен.
+     *
+     * Потоки создаются при каждом вызове forEach/reduce и завершаются вместе
+     * с ним (пул потоков не используется): для небольших деревьев создание
+     * потоков может стоить больше самого обхода.
+     *
+     * В режиме одновременного чтения эпоха дерева (EpochManager::Guard)
+     * объявляется на все время обхода.
+     */
+    template<typename TTrie>
+    class ParallelTrieScan
+    {
+    public:
+
+        using trie_type     = TTrie;
+        using node_type     = typename trie_type::node_type;
+        using char_type     = std::decay_t<decltype(std::declval<const node_type&>().getKeyChar())>;
+        using value_type    = std::decay_t<decltype(std::declval<const node_type&>().getValue())>;
+        using key_type      = std::basic_string<char_type>;
+
+        // Длина очереди задач потока, начиная с которой поддеревья обходятся без выделения задач
+        static constexpr size_t split_threshold = 4;
+
+        // Создание обхода дерева
+        /**
+         * @param   trie - обходимое дерево (должно существовать все время обхода)
+         * @param   threadsCount - количество потоков (0 - по количеству ядер процессора)
+         */
+        explicit ParallelTrieScan(const trie_type& trie, size_t threadsCount = 0);
+
+        ParallelTrieScan(const ParallelTrieScan&) = delete;
+        ParallelTrieScan& operator=(const ParallelTrieScan&) = delete;
+
+        // Посетить все пары ключ/значение
+        /**
+         * @param   visitor - функция visitor(const key_type& key, const value_type& value),
+         *          вызывается одновременно из нескольких потоков
+         */
+        template<typename Visitor>
+        void                forEach(Visitor visitor);
+
+        // Свернуть все пары ключ/значение
+        /**
+         * Каждый поток сворачивает свои пары в собственный результат,
+         * после обхода результаты потоков сворачиваются в общий.
+         *
+         * @param   identity - нейтральный элемент свертки
+         * @param   map - функция map(const key_type& key, const value_type& value) -> TResult
+         * @param   reduce - ассоциативная и коммутативная функция reduce(TResult, TResult) -> TResult
+         * @return  результат свертки (identity - для пустого дерева)
+         */
+        template<typename TResult, typename MapFunction, typename ReduceFunction>
+        TResult             reduce(TResult identity, MapFunction map, ReduceFunction reduce);
+
+        // Получить количество потоков
+        size_t              getThreadsCount() const;
+
+    private:
+
+        // Задача: узел с дочерними элементами (без следующих братьев)
+        struct Task
+        {
+            const node_type*    pNode;
+            key_type            prefix;     // Ключ родителя узла
+        };
+
+        // Состояние потока (в отдельных строках кэша)
+        struct alignas(64) Worker
+        {
+            std::mutex              mutex;
+            std::deque<Task>        tasks;
+            std::atomic<size_t>     tasksCount { 0 };
+            key_type                key;        // Буфер ключа
+        };
+
+        // Результат свертки потока (в отдельных строках кэша)
+        template<typename TResult>
+        struct alignas(64) WorkerResult
+        {
+            TResult                 value;
+        };
+
+        // Выполнить обход: visitor(workerIndex, key, value)
+        template<typename WorkerVisitor>
+        void                intRun(WorkerVisitor& visitor);
+
+        // Цикл потока: выполнение своих и украденных задач
+        template<typename WorkerVisitor>
+        void                intWork(size_t workerIndex, WorkerVisitor& visitor);
+
+        // Обход поддерева задачи
+        template<typename WorkerVisitor>
+        void                intProcessTask(size_t workerIndex, const Task& task, WorkerVisitor& visitor);
+
+        // Добавить задачу в очередь потока
+        void                intPushTask(size_t workerIndex, const node_type* node, const key_type& prefix);
+
+        // Получить задачу: с конца своей очереди или с начала очереди другого потока
+        bool                intPopTask(size_t workerIndex, Task& task);
+
+    private:
+
+        const trie_type&                        m_trie;
+        std::vector<std::unique_ptr<Worker>>    m_workers;
+
+        std::atomic<size_t>                     m_pendingTasks { 0 };   // Добавленные и еще не выполненные задачи
+        std::atomic<bool>                       m_bStop { false };
+        std::mutex                              m_errorMutex;
+        std::exception_ptr                      m_error;
+    };
+
+    // Посетить все пары ключ/значение дерева несколькими потоками
+    /**
+     * Потоки создаются на время вызова (см. ParallelTrieScan).
+     *
+     * @param   visitor - функция visitor(key, value), вызывается одновременно из нескольких потоков
+     * @param   threadsCount - количество потоков (0 - по количеству ядер процессора)
+     */
+    template<typename TTrie, typename Visitor>
+    void parallel_for_each(const TTrie& trie, Visitor visitor, size_t threadsCount = 0);
+
+    // Свернуть все пары ключ/значение дерева несколькими потоками
+    /**
+     * Потоки создаются на время вызова (см. ParallelTrieScan).
+     *
+     * @param   identity - нейтральный элемент свертки
+     * @param   map - функция map(key, value) -> TResult
+     * @param   reduce - ассоциативная и коммутативная функция reduce(TResult, TResult) -> TResult
+     * @param   threadsCount - количество потоков (0 - по количеству ядер процессора)
+     */
+    template<typename TTrie, typename TResult, typename MapFunction, typename ReduceFunction>
+    TResult parallel_reduce(const TTrie& trie, TResult identity, MapFunction map, ReduceFunction reduce, size_t threadsCount = 0);
+
+}   // namespace Trie
+
+// Имплементация методов параллельного построения цифрового дерева
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    ParallelTrieBuilder<TTrie>::ParallelTrieBuilder(trie_type& trie, size_t threadsCount)
+        : m_trie         (trie),
+          m_threadsCount (threadsCount ? threadsCount : (std::max)(1u, std::thread::hardware_concurrency()))
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    template<typename ForwardIterator>
+    size_t
+    ParallelTrieBuilder<TTrie>::build(ForwardIterator first, ForwardIterator last)
+    {
+        m_items.clear();
+        m_order.clear();
+        m_groups.clear();
+
+        for (; first != last; ++first)
+        {
+            const auto& key = (*first).first;
+            if (intGetKeyLength(key) > 0)
+                m_items.push_back({ intGetKeyData(key), intGetKeyLength(key), (*first).second });
+        }
+
+        node_type* rootNode = m_trie.intGetRoot();
+
+        // Пары с первым символом, который уже есть в дереве, добавляются последовательно.
+        // Остальные упорядочиваются по первому символу с сохранением порядка повторов
+        std::vector<size_t> sequentialItems;
+        for (size_t itemIndex = 0; itemIndex < m_items.size(); ++itemIndex)
+        {
+            node_type* prevNode = nullptr;
+            if (rootNode->findChild(m_items[itemIndex].pKey[0], prevNode))
+                sequentialItems.push_back(itemIndex);
+            else
+                m_order.push_back(itemIndex);
+        }
+
+        auto getFirstChar = [this](size_t itemIndex) { return key_traits::fold(m_items[itemIndex].pKey[0]); };
+
+        std::stable_sort(m_order.begin(), m_order.end(),
+            [&getFirstChar](size_t itemIndex1, size_t itemIndex2) { return key_traits::less(getFirstChar(itemIndex1), getFirstChar(itemIndex2)); });
+
+        for (size_t orderIndex = 0; orderIndex < m_order.size(); ++orderIndex)
+        {
+            if (m_groups.empty() || !key_traits::eq(getFirstChar(m_order[orderIndex - 1]), getFirstChar(m_order[orderIndex])))
+                m_groups.push_back({ orderIndex, 0, 0 });
+
+            m_groups.back().itemsCount += 1;
+            m_groups.back().weight     += m_items[m_order[orderIndex]].keyLength;
+        }
+
+        // Узлы в чужом ресурсе памяти выделяются только из текущего потока
+        std::pmr::memory_resource* trieResource = m_trie.getMemoryResource();
+        const bool bOwnArena = m_trie.m_ownArena != nullptr;
+        const bool bParallel = bOwnArena || trieResource == std::pmr::new_delete_resource();
+
+        // Распределение групп: очередная по весу группа - наименее загруженному потоку
+        std::vector<Worker> workers(bParallel ? (std::min)(m_threadsCount, m_groups.size()) : (m_groups.empty() ? 0 : 1));
+        {
+            std::vector<size_t> groupsByWeight(m_groups.size());
+            for (size_t groupIndex = 0; groupIndex < m_groups.size(); ++groupIndex)
+                groupsByWeight[groupIndex] = groupIndex;
+
+            std::sort(groupsByWeight.begin(), groupsByWeight.end(),
+                [this](size_t groupIndex1, size_t groupIndex2) { return m_groups[groupIndex1].weight > m_groups[groupIndex2].weight; });
+
+            for (size_t groupIndex : groupsByWeight)
+            {
+                Worker& worker = *std::min_element(workers.begin(), workers.end(),
+                    [](const Worker& worker1, const Worker& worker2) { return worker1.weight < worker2.weight; });
+
+                worker.groups.push_back(groupIndex);
+                worker.weight += m_groups[groupIndex].weight;
+            }
+        }
+
+        // Построение поддеревьев: первый поток - текущий
+        std::vector<std::thread> threads;
+        for (size_t workerIndex = 0; workerIndex < workers.size(); ++workerIndex)
+        {
+            Worker& worker = workers[workerIndex];
+            if (bOwnArena)
+                worker.arena.reset(new TrieArena());
+
+            std::pmr::memory_resource* resource = bOwnArena ? worker.arena.get() : trieResource;
+            if (workerIndex > 0)
+                threads.emplace_back([this, &worker, resource]() { intBuildGroups(worker, resource); });
+        }
+
+        if (!workers.empty())
+            intBuildGroups(workers.front(), bOwnArena ? workers.front().arena.get() : trieResource);
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        // Слэбы арен потоков переходят к арене дерева
+        for (Worker& worker : workers)
+        {
+            if (worker.arena)
+                m_trie.m_ownArena->adopt(*worker.arena);
+        }
+
+        for (const Worker& worker : workers)
+        {
+            if (worker.error)
+            {
+                for (const Group& group : m_groups)
+                    node_type::destroySubtree(trieResource, group.pHead);
+
+                std::rethrow_exception(worker.error);
+            }
+        }
+
+        // Вставка готовых поддеревьев в цепочку дочерних элементов корня
+        // (предшествующие узлы цепочки, разделяемые со снимками, копируются)
+        for (const Group& group : m_groups)
+        {
+            node_type* prevNode = nullptr;
+            m_trie.intFindChildWritable(rootNode, group.pHead->getKeyChar(), prevNode);
+            m_trie.intLinkChild(rootNode, group.pHead, prevNode);
+            m_trie.intBuildSubtreeChildLabels(group.pHead);
+
+            trie_type::intAddSubtreeCount(rootNode, static_cast<ptrdiff_t>(trie_type::intGetSubtreeCount(group.pHead)));
+            if constexpr (trie_type::has_subtree_max_values)
+                trie_type::intRaiseSubtreeMaxValue(rootNode, group.pHead->getSubtreeMaxValue());
+        }
+
+        // Поддеревья вставлены в обход addKeyValue - изменение учитывается в счетчике дерева
+        if (!m_groups.empty())
+            ++m_trie.m_modificationCount;
+
+        for (size_t itemIndex : sequentialItems)
+            intAddItem(m_items[itemIndex]);
+
+        const size_t count = m_items.size();
+
+        m_items.clear();
+        m_order.clear();
+        m_groups.clear();
+
+        return count;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    void
+    ParallelTrieBuilder<TTrie>::intBuildGroups(Worker& worker, std::pmr::memory_resource* resource)
+    {
+        try
+        {
+            for (size_t groupIndex : worker.groups)
+                m_groups[groupIndex].pHead = intBuildGroup(m_groups[groupIndex], resource);
+        }
+        catch (...)
+        {
+            worker.error = std::current_exception();
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    typename ParallelTrieBuilder<TTrie>::node_type*
+    ParallelTrieBuilder<TTrie>::intBuildGroup(const Group& group, std::pmr::memory_resource* resource) const
+    {
+        const Item& firstItem = m_items[m_order[group.firstItem]];
+
+        node_type* headNode = node_type::create(resource, firstItem.pKey[0]);
+        try
+        {
+            std::vector<node_type*> path;   // Путь к узлу ключа (только при подсчете ключей в поддеревьях)
+
+            for (size_t orderIndex = group.firstItem; orderIndex < group.firstItem + group.itemsCount; ++orderIndex)
+            {
+                const Item& item = m_items[m_order[orderIndex]];
+
+                node_type* node = headNode;
+                if constexpr (trie_type::has_subtree_counts)
+                {
+                    path.clear();
+                    path.push_back(node);
+                }
+
+                for (size_t keyCharIndex = 1; keyCharIndex < item.keyLength; ++keyCharIndex)
+                {
+                    bool bCreated(false);
+                    node = node->getChildCreate(item.pKey[keyCharIndex], bCreated, resource);
+
+                    if constexpr (trie_type::has_subtree_counts)
+                        path.push_back(node);
+                }
+
+                if (!node->haveValue())
+                {
+                    for (node_type* pathNode : path)
+                        trie_type::intAddSubtreeCount(pathNode, 1);
+                }
+
+                node->intEmplaceValue(item.value);
+            }
+
+            // Значения ключей группы могли заменяться - наибольшие значения считаются по готовому поддереву
+            trie_type::intRebuildSubtreeMaxValues(headNode);
+        }
+        catch (...)
+        {
+            node_type::destroySubtree(resource, headNode);
+            throw;
+        }
+
+        return headNode;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    void
+    ParallelTrieBuilder<TTrie>::intAddItem(const Item& item)
+    {
+        m_trie.addKeyValue(item.pKey, item.keyLength, item.value);
+    }
+
+}   // namespace Trie (Имплементация методов параллельного построения цифрового дерева)
+
+// Имплементация методов параллельного обхода цифрового дерева
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    ParallelTrieScan<TTrie>::ParallelTrieScan(const trie_type& trie, size_t threadsCount)
+        : m_trie (trie)
+    {
+        if (0 == threadsCount)
+            threadsCount = (std::max)(1u, std::thread::hardware_concurrency());
+
+        for (size_t workerIndex = 0; workerIndex < threadsCount; ++workerIndex)
+            m_workers.emplace_back(new Worker());
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    template<typename Visitor>
+    void
+    ParallelTrieScan<TTrie>::forEach(Visitor visitor)
+    {
+        auto workerVisitor = [&visitor](size_t, const key_type& key, const value_type& value)
+        {
+            visitor(key, value);
+        };
+
+        intRun(workerVisitor);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    template<typename TResult, typename MapFunction, typename ReduceFunction>
+    TResult
+    ParallelTrieScan<TTrie>::reduce(TResult identity, MapFunction map, ReduceFunction reduce)
+    {
+        std::vector<WorkerResult<TResult>> results(m_workers.size(), WorkerResult<TResult>{ identity });
+
+        auto workerVisitor = [&results, &map, &reduce](size_t workerIndex, const key_type& key, const value_type& value)
+        {
+            TResult& workerResult = results[workerIndex].value;
+            workerResult = reduce(std::move(workerResult), map(key, value));
+        };
+
+        intRun(workerVisitor);
+
+        TResult result = std::move(identity);
+        for (WorkerResult<TResult>& workerResult : results)
+            result = reduce(std::move(result), std::move(workerResult.value));
+
+        return result;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    size_t
+    ParallelTrieScan<TTrie>::getThreadsCount() const
+    {
+        return m_workers.size();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    template<typename WorkerVisitor>
+    void
+    ParallelTrieScan<TTrie>::intRun(WorkerVisitor& visitor)
+    {
+        m_bStop = false;
+        m_error = nullptr;
+
+        // Эпоха объявляется до получения начальных задач и удерживается до конца обхода
+        std::unique_ptr<EpochManager::Guard> guard;
+        if (m_trie.getEpochManager())
+            guard.reset(new EpochManager::Guard(*m_trie.getEpochManager()));
+
+        // Начальные задачи - дочерние элементы корня, поровну между потоками
+        size_t firstWorkerIndex = 0;
+        for (const node_type* node = m_trie.getRootNode()->getChildSimple(); node; node = node->getNext())
+        {
+            intPushTask(firstWorkerIndex, node, key_type());
+            firstWorkerIndex = (firstWorkerIndex + 1) % m_workers.size();
+        }
+
+        // Первый поток - текущий
+        std::vector<std::thread> threads;
+        for (size_t workerIndex = 1; workerIndex < m_workers.size(); ++workerIndex)
+            threads.emplace_back([this, workerIndex, &visitor]() { intWork(workerIndex, visitor); });
+
+        intWork(0, visitor);
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        // После ошибки в очередях могут остаться невыполненные задачи
+        for (auto& worker : m_workers)
+        {
+            worker->tasks.clear();
+            worker->tasksCount = 0;
+        }
+        m_pendingTasks = 0;
+
+        if (m_error)
+            std::rethrow_exception(m_error);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    template<typename WorkerVisitor>
+    void
+    ParallelTrieScan<TTrie>::intWork(size_t workerIndex, WorkerVisitor& visitor)
+    {
+        Task task;
+        while (!m_bStop.load(std::memory_order_relaxed))
+        {
+            if (intPopTask(workerIndex, task))
+            {
+                try
+                {
+                    intProcessTask(workerIndex, task, visitor);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(m_errorMutex);
+                    if (!m_error)
+                        m_error = std::current_exception();
+                    m_bStop = true;
+                }
+
+                m_pendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+            }
+            else if (0 == m_pendingTasks.load(std::memory_order_acquire))
+            {
+                break;
+            }
+            else
+            {
+                // Задачи выполняются другими потоками и еще могут породить новые
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    template<typename WorkerVisitor>
+    void
+    ParallelTrieScan<TTrie>::intProcessTask(size_t workerIndex, const Task& task, WorkerVisitor& visitor)
+    {
+        Worker& worker = *m_workers[workerIndex];
+
+        key_type& key = worker.key;
+        key = task.prefix;
+
+        // Обход в глубину: узел и длина ключа его родителя
+        std::vector<std::pair<const node_type*, size_t>> stack;
+        stack.emplace_back(task.pNode, key.size());
+
+        while (!stack.empty())
+        {
+            const node_type* node        = stack.back().first;
+            const size_t     prefixLength = stack.back().second;
+            stack.pop_back();
+
+            key.resize(prefixLength);
+            key.push_back(node->getKeyChar());
+
+            if (node->haveValue())
+                visitor(workerIndex, key, node->getValue());
+
+            for (const node_type* child = node->getChildSimple(); child; child = child->getNext())
+            {
+                if (worker.tasksCount.load(std::memory_order_relaxed) < split_threshold)
+                    intPushTask(workerIndex, child, key);
+                else
+                    stack.emplace_back(child, key.size());
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    void
+    ParallelTrieScan<TTrie>::intPushTask(size_t workerIndex, const node_type* node, const key_type& prefix)
+    {
+        Worker& worker = *m_workers[workerIndex];
+
+        m_pendingTasks.fetch_add(1, std::memory_order_acq_rel);
+
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back({ node, prefix });
+        worker.tasksCount.store(worker.tasks.size(), std::memory_order_relaxed);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie>
+    bool
+    ParallelTrieScan<TTrie>::intPopTask(size_t workerIndex, Task& task)
+    {
+        // Своя очередь - с конца (поддерево, соседнее с только что пройденным)
+        {
+            Worker& worker = *m_workers[workerIndex];
+
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (!worker.tasks.empty())
+            {
+                task = std::move(worker.tasks.back());
+                worker.tasks.pop_back();
+                worker.tasksCount.store(worker.tasks.size(), std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // Чужие очереди - с начала (самые крупные поддеревья)
+        for (size_t offset = 1; offset < m_workers.size(); ++offset)
+        {
+            Worker& victim = *m_workers[(workerIndex + offset) % m_workers.size()];
+            if (0 == victim.tasksCount.load(std::memory_order_relaxed))
+                continue;
+
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                victim.tasksCount.store(victim.tasks.size(), std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie, typename Visitor>
+    void
+    parallel_for_each(const TTrie& trie, Visitor visitor, size_t threadsCount)
+    {
+        ParallelTrieScan<TTrie> scan(trie, threadsCount);
+        scan.forEach(visitor);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TTrie, typename TResult, typename MapFunction, typename ReduceFunction>
+    TResult
+    parallel_reduce(const TTrie& trie, TResult identity, MapFunction map, ReduceFunction reduce, size_t threadsCount)
+    {
+        ParallelTrieScan<TTrie> scan(trie, threadsCount);
+        return scan.reduce(std::move(identity), map, reduce);
+    }
+
+}   // namespace Trie (Имплементация методов параллельного обхода цифрового дерева)
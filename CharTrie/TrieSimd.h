@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRIE_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Trie
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Векторный поиск в упорядоченном массиве из 16 однобайтовых ключей
+    /*
+     * Массив всегда занимает 16 байт (используются первые count элементов),
+     * поэтому он сравнивается с искомым ключом одной командой SSE2.
+     * Без SSE2 используется последовательный просмотр.
+     */
+
+    // Найти ключ, равный указанному
+    /**
+     * @param   keys - массив ключей, упорядоченных по возрастанию
+     * @param   count - количество используемых элементов массива
+     * @param   key - искомый ключ
+     * @return  индекс найденного ключа или count, если ключ не найден
+     */
+    inline size_t simd_find_key16(const uint8_t (&keys)[16], size_t count, uint8_t key);
+
+    // Найти первый ключ, больший или равный указанному
+    /**
+     * @param   keys - массив ключей, упорядоченных по возрастанию
+     * @param   count - количество используемых элементов массива
+     * @param   key - искомый ключ
+     * @return  индекс найденного ключа или count, если все ключи меньше указанного
+     */
+    inline size_t simd_lower_bound_key16(const uint8_t (&keys)[16], size_t count, uint8_t key);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Векторный поиск в упорядоченном массиве однобайтовых ключей произвольной длины
+    /*
+     * Массив просматривается блоками по 16 ключей; неполный последний блок
+     * копируется во временный массив. Элементы за пределами count не читаются,
+     * поэтому писатель может дописывать массив одновременно с поиском
+     * (новое количество публикуется после записи элемента).
+     */
+
+    // Найти ключ, равный указанному
+    /**
+     * @param   keys - массив ключей, упорядоченных по возрастанию
+     * @param   count - количество ключей
+     * @param   key - искомый ключ
+     * @return  индекс найденного ключа или count, если ключ не найден
+     */
+    inline size_t simd_find_key(const uint8_t* keys, size_t count, uint8_t key);
+
+    // Найти первый ключ, больший или равный указанному
+    /**
+     * @param   keys - массив ключей, упорядоченных по возрастанию
+     * @param   count - количество ключей
+     * @param   key - искомый ключ
+     * @return  индекс найденного ключа или count, если все ключи меньше указанного
+     */
+    inline size_t simd_lower_bound_key(const uint8_t* keys, size_t count, uint8_t key);
+
+}   // namespace Trie
+
+// Имплементация векторного поиска
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    inline
+    unsigned
+    simd_count_trailing_zeros(unsigned mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index = 0;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#elif defined(__GNUC__)
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#else
+        unsigned index = 0;
+        while (!(mask & 1u))
+        {
+            mask >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    unsigned
+    simd_pop_count(unsigned mask)
+    {
+#if defined(_MSC_VER)
+        return static_cast<unsigned>(__popcnt(mask));
+#elif defined(__GNUC__)
+        return static_cast<unsigned>(__builtin_popcount(mask));
+#else
+        unsigned count = 0;
+        for (; mask; mask &= mask - 1)
+            ++count;
+        return count;
+#endif
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    simd_find_key16(const uint8_t (&keys)[16], size_t count, uint8_t key)
+    {
+#if defined(TRIE_SIMD_SSE2)
+        const __m128i keysVector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys));
+        const __m128i keyVector  = _mm_set1_epi8(static_cast<char>(key));
+
+        // Элементы за пределами count отбрасываются маской
+        const unsigned validMask = (1u << count) - 1;
+        const unsigned eqMask    = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(keysVector, keyVector))) & validMask;
+
+        return eqMask ? simd_count_trailing_zeros(eqMask) : count;
+#else
+        for (size_t index = 0; index < count; ++index)
+        {
+            if (keys[index] == key)
+                return index;
+        }
+        return count;
+#endif
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    simd_lower_bound_key16(const uint8_t (&keys)[16], size_t count, uint8_t key)
+    {
+#if defined(TRIE_SIMD_SSE2)
+        // SSE2 сравнивает байты как знаковые - сдвинем диапазон инвертированием старшего бита
+        const __m128i signBit    = _mm_set1_epi8(static_cast<char>(0x80));
+        const __m128i keysVector = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)), signBit);
+        const __m128i keyVector  = _mm_xor_si128(_mm_set1_epi8(static_cast<char>(key)), signBit);
+
+        // Ключи упорядочены, поэтому индекс равен количеству ключей, меньших искомого
+        const unsigned validMask = (1u << count) - 1;
+        const unsigned lessMask  = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmplt_epi8(keysVector, keyVector))) & validMask;
+
+        return simd_pop_count(lessMask);
+#else
+        size_t index = 0;
+        while (index < count && keys[index] < key)
+            ++index;
+        return index;
+#endif
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    simd_find_key(const uint8_t* keys, size_t count, uint8_t key)
+    {
+#if defined(TRIE_SIMD_SSE2)
+        const __m128i keyVector = _mm_set1_epi8(static_cast<char>(key));
+
+        size_t blockIndex = 0;
+        for (; blockIndex + 16 <= count; blockIndex += 16)
+        {
+            const __m128i  keysVector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + blockIndex));
+            const unsigned eqMask     = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(keysVector, keyVector)));
+            if (eqMask)
+                return blockIndex + simd_count_trailing_zeros(eqMask);
+        }
+
+        if (blockIndex == count)
+            return count;
+
+        uint8_t tail[16] = {};
+        std::memcpy(tail, keys + blockIndex, count - blockIndex);
+
+        return blockIndex + simd_find_key16(tail, count - blockIndex, key);
+#else
+        for (size_t index = 0; index < count; ++index)
+        {
+            if (keys[index] == key)
+                return index;
+        }
+        return count;
+#endif
+    }
+
+    //------------------------------------------------------------------------//
+    inline
+    size_t
+    simd_lower_bound_key(const uint8_t* keys, size_t count, uint8_t key)
+    {
+#if defined(TRIE_SIMD_SSE2)
+        const __m128i signBit   = _mm_set1_epi8(static_cast<char>(0x80));
+        const __m128i keyVector = _mm_xor_si128(_mm_set1_epi8(static_cast<char>(key)), signBit);
+
+        size_t blockIndex = 0;
+        for (; blockIndex + 16 <= count; blockIndex += 16)
+        {
+            const __m128i  keysVector = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + blockIndex)), signBit);
+            const unsigned lessMask   = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmplt_epi8(keysVector, keyVector)));
+
+            // Блок, в котором не все ключи меньше искомого, содержит результат
+            if (lessMask != 0xFFFF)
+                return blockIndex + simd_pop_count(lessMask);
+        }
+
+        if (blockIndex == count)
+            return count;
+
+        uint8_t tail[16] = {};
+        std::memcpy(tail, keys + blockIndex, count - blockIndex);
+
+        return blockIndex + simd_lower_bound_key16(tail, count - blockIndex, key);
+#else
+        size_t index = 0;
+        while (index < count && keys[index] < key)
+            ++index;
+        return index;
+#endif
+    }
+
+}   // namespace Trie (Имплементация векторного поиска)
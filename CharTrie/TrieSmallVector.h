@@ -0,0 +1,350 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <cassert>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Trie
+{
+    ////////////////////////////////////////////////////////////////////////////
+    // Вектор с размещением первых элементов внутри объекта
+    /*
+     * Пока количество элементов не превышает InlineCapacity, память в куче
+     * не выделяется, а копирование вектора сводится к копированию массива.
+     * Элементы перемещаются побайтно, поэтому их тип должен быть тривиально
+     * копируемым (указатели, символы, индексы).
+     */
+    template<typename T, size_t InlineCapacity>
+    class SmallVector
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "SmallVector elements must be trivially copyable");
+        static_assert(InlineCapacity > 0, "SmallVector inline capacity must be positive");
+
+    public:
+
+        using value_type = T;
+
+        SmallVector() noexcept;
+        SmallVector(const SmallVector& other);
+        SmallVector(SmallVector&& other) noexcept;
+        ~SmallVector();
+
+        SmallVector&    operator=   (const SmallVector& other);
+        SmallVector&    operator=   (SmallVector&& other) noexcept;
+
+        void            push_back(const T& value);
+        void            pop_back();
+
+        // Изменить количество элементов (новые элементы не инициализируются)
+        void            resize(size_t size);
+        void            reserve(size_t capacity);
+        void            clear();
+
+        T&              operator[]  (size_t index);
+        const T&        operator[]  (size_t index)  const;
+        T&              back();
+        const T&        back()                      const;
+
+        T*              data();
+        const T*        data()                      const;
+        const T*        begin()                     const;
+        const T*        end()                       const;
+
+        size_t          size()                      const;
+        size_t          capacity()                  const;
+        bool            empty()                     const;
+
+    private:
+
+        bool            intIsInline() const;
+
+        // Перенести элементы в буфер указанной емкости
+        void            intGrow(size_t capacity);
+
+        // Скопировать элементы другого вектора (текущие элементы отбрасываются)
+        void            intAssign(const SmallVector& other);
+
+    private:
+
+        T*      m_data;
+        size_t  m_size      = 0;
+        size_t  m_capacity  = InlineCapacity;
+        T       m_inline[InlineCapacity];
+    };
+
+}   // namespace Trie
+
+// Имплементация вектора с размещением первых элементов внутри объекта
+namespace Trie
+{
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    SmallVector<T, InlineCapacity>::SmallVector() noexcept
+        : m_data (m_inline)
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    SmallVector<T, InlineCapacity>::SmallVector(const SmallVector& other)
+        : m_data (m_inline)
+    {
+        intAssign(other);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    SmallVector<T, InlineCapacity>::SmallVector(SmallVector&& other) noexcept
+        : m_data (m_inline)
+    {
+        operator=(std::move(other));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    SmallVector<T, InlineCapacity>::~SmallVector()
+    {
+        if (!intIsInline())
+            ::operator delete(m_data);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    SmallVector<T, InlineCapacity>&
+    SmallVector<T, InlineCapacity>::operator=(const SmallVector& other)
+    {
+        if (this != &other)
+            intAssign(other);
+
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    SmallVector<T, InlineCapacity>&
+    SmallVector<T, InlineCapacity>::operator=(SmallVector&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        if (other.intIsInline())
+        {
+            // Элементы во внутреннем массиве копируются
+            if (other.m_size)
+                memcpy(m_data, other.m_data, sizeof(T) * other.m_size);
+            m_size = other.m_size;
+        }
+        else
+        {
+            // Буфер в куче передается
+            if (!intIsInline())
+                ::operator delete(m_data);
+
+            m_data     = other.m_data;
+            m_size     = other.m_size;
+            m_capacity = other.m_capacity;
+
+            other.m_data     = other.m_inline;
+            other.m_capacity = InlineCapacity;
+        }
+
+        other.m_size = 0;
+
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    inline
+    void
+    SmallVector<T, InlineCapacity>::push_back(const T& value)
+    {
+        if (m_size == m_capacity)
+            intGrow(m_capacity * 2);
+
+        m_data[m_size++] = value;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    inline
+    void
+    SmallVector<T, InlineCapacity>::pop_back()
+    {
+        assert(m_size);
+        --m_size;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    void
+    SmallVector<T, InlineCapacity>::resize(size_t size)
+    {
+        reserve(size);
+        m_size = size;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    void
+    SmallVector<T, InlineCapacity>::reserve(size_t capacity)
+    {
+        if (capacity > m_capacity)
+            intGrow((std::max)(capacity, m_capacity * 2));
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    inline
+    void
+    SmallVector<T, InlineCapacity>::clear()
+    {
+        m_size = 0;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    inline
+    T&
+    SmallVector<T, InlineCapacity>::operator[](size_t index)
+    {
+        assert(index < m_size);
+        return m_data[index];
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    inline
+    const T&
+    SmallVector<T, InlineCapacity>::operator[](size_t index) const
+    {
+        assert(index < m_size);
+        return m_data[index];
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    inline
+    T&
+    SmallVector<T, InlineCapacity>::back()
+    {
+        assert(m_size);
+        return m_data[m_size - 1];
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    inline
+    const T&
+    SmallVector<T, InlineCapacity>::back() const
+    {
+        assert(m_size);
+        return m_data[m_size - 1];
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    inline
+    T*
+    SmallVector<T, InlineCapacity>::data()
+    {
+        return m_data;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    inline
+    const T*
+    SmallVector<T, InlineCapacity>::data() const
+    {
+        return m_data;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    inline
+    const T*
+    SmallVector<T, InlineCapacity>::begin() const
+    {
+        return m_data;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    inline
+    const T*
+    SmallVector<T, InlineCapacity>::end() const
+    {
+        return m_data + m_size;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    inline
+    size_t
+    SmallVector<T, InlineCapacity>::size() const
+    {
+        return m_size;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    inline
+    size_t
+    SmallVector<T, InlineCapacity>::capacity() const
+    {
+        return m_capacity;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    inline
+    bool
+    SmallVector<T, InlineCapacity>::empty() const
+    {
+        return 0 == m_size;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    inline
+    bool
+    SmallVector<T, InlineCapacity>::intIsInline() const
+    {
+        return m_data == m_inline;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    void
+    SmallVector<T, InlineCapacity>::intGrow(size_t capacity)
+    {
+        T* newData = static_cast<T*>(::operator new(sizeof(T) * capacity));
+        if (m_size)
+            memcpy(newData, m_data, sizeof(T) * m_size);
+
+        if (!intIsInline())
+            ::operator delete(m_data);
+
+        m_data     = newData;
+        m_capacity = capacity;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename T, size_t InlineCapacity>
+    void
+    SmallVector<T, InlineCapacity>::intAssign(const SmallVector& other)
+    {
+        m_size = 0;
+        reserve(other.m_size);
+
+        if (other.m_size)
+            memcpy(m_data, other.m_data, sizeof(T) * other.m_size);
+        m_size = other.m_size;
+    }
+
+}   // namespace Trie (Имплементация вектора с размещением первых элементов внутри объекта)
@@ -4,6 +4,9 @@
 #include <string.h>
 #include <cassert>
 #include <vector>
+#include <string>
+
+#include "TrieSmallVector.h"
 
 namespace TrieStrings
 {
@@ -22,6 +25,13 @@ namespace TrieStrings
 
         virtual void appendChar(TCharType newChar) = 0;
 
+        // Укоротить строку до указанной длины
+        /*
+         * Реализация по умолчанию переприсваивает начало строки через assign;
+         * наследники заменяют ее укорочением на месте.
+         */
+        virtual void truncate(size_t length);
+
         virtual const TCharType* getStr()           const = 0;
         virtual bool             empty()            const = 0;
         virtual size_t           length()           const = 0;
@@ -40,6 +50,7 @@ namespace TrieStrings
         virtual ~StringOfCharsZeroEnd();
 
         StringOfCharsZeroEnd<TCharType>& operator=(const StringOfChars<TCharType>& other);
+        StringOfCharsZeroEnd<TCharType>& operator=(const StringOfCharsZeroEnd<TCharType>& other);
         StringOfCharsZeroEnd<TCharType>& operator=(StringOfCharsZeroEnd<TCharType>&& other) noexcept;
 
         virtual void clear()                                      override;
@@ -47,6 +58,7 @@ namespace TrieStrings
         virtual void assign(const TCharType* zeroEndBuf)          override;
         virtual void assign(const TCharType* buf, size_t length)  override;
         virtual void appendChar(TCharType newChar)                override;
+        virtual void truncate(size_t length)                      override;
 
         virtual const TCharType* getStr()           const         override;
         virtual bool             empty()            const         override;
@@ -59,6 +71,7 @@ namespace TrieStrings
 
     private:
 
+        // Символы строки и завершающий 0 (пустая строка может не занимать памяти)
         std::vector<TCharType> m_buf;
     };
 
@@ -75,6 +88,7 @@ namespace TrieStrings
         virtual ~StringOfCharsFixedLen();
 
         StringOfCharsFixedLen<TCharType>& operator=(const StringOfChars<TCharType>& other);
+        StringOfCharsFixedLen<TCharType>& operator=(const StringOfCharsFixedLen<TCharType>& other);
         StringOfCharsFixedLen<TCharType>& operator=(StringOfCharsFixedLen<TCharType>&& other) noexcept;
 
         virtual void clear()                                      override;
@@ -82,6 +96,7 @@ namespace TrieStrings
         virtual void assign(const TCharType* zeroEndBuf)          override;
         virtual void assign(const TCharType* buf, size_t length)  override;
         virtual void appendChar(TCharType newChar)                override;
+        virtual void truncate(size_t length)                      override;
 
         virtual const TCharType* getStr()           const         override;
         virtual bool             empty()            const         override;
@@ -96,12 +111,54 @@ namespace TrieStrings
 
         std::vector<TCharType> m_buf;
     };
+
+    ////////////////////////////////////////////////////////////////////////////
+    // 0-терминированная строка с размещением коротких строк внутри объекта
+    /*
+     * Строки длиной до InlineLength символов не выделяют память в куче,
+     * поэтому копирование и наращивание таких строк сводится к копированию массива
+     */
+    template <typename TCharType, size_t InlineLength>
+    class StringOfCharsInline : public StringOfChars<TCharType>
+    {
+    public:
+
+        StringOfCharsInline() noexcept;
+        StringOfCharsInline(const StringOfCharsInline& other);
+        StringOfCharsInline(StringOfCharsInline&& other) noexcept;
+        virtual ~StringOfCharsInline();
+
+        StringOfCharsInline& operator=(const StringOfChars<TCharType>& other);
+        StringOfCharsInline& operator=(const StringOfCharsInline& other);
+        StringOfCharsInline& operator=(StringOfCharsInline&& other) noexcept;
+
+        virtual void clear()                                      override;
+        virtual void reserve(size_t size)                         override;
+        virtual void assign(const TCharType* zeroEndBuf)          override;
+        virtual void assign(const TCharType* buf, size_t length)  override;
+        virtual void appendChar(TCharType newChar)                override;
+        virtual void truncate(size_t length)                      override;
+
+        virtual const TCharType* getStr()           const         override;
+        virtual bool             empty()            const         override;
+        virtual size_t           length()           const         override;
+        virtual TCharType        at(size_t index)   const         override;
+
+    private:
+
+        void intAssign(const TCharType* buf, size_t charsCount);
+
+    private:
+
+        // Символы строки и завершающий 0 (пустая строка может не содержать и его)
+        Trie::SmallVector<TCharType, InlineLength + 1> m_buf;
+    };
 }
 
 namespace TrieStrings
 {
     //------------------------------------------------------------------------//
-    //   0-    
+    // Получение длины 0-терминированной строки из узких символов
     inline
     size_t GetStrLen(const char* buf)
     {
@@ -109,13 +166,45 @@ namespace TrieStrings
     }
 
     //------------------------------------------------------------------------//
-    //   0-    
+    // Получение длины 0-терминированной строки из широких символов
     inline
     size_t GetStrLen(const wchar_t* buf)
     {
         return wcslen(buf);
     }
 
+    //------------------------------------------------------------------------//
+    // Получение длины 0-терминированной строки из символов UTF-16
+    inline
+    size_t GetStrLen(const char16_t* buf)
+    {
+        return std::char_traits<char16_t>::length(buf);
+    }
+
+    //------------------------------------------------------------------------//
+    // Получение длины 0-терминированной строки из символов UTF-32
+    inline
+    size_t GetStrLen(const char32_t* buf)
+    {
+        return std::char_traits<char32_t>::length(buf);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType>
+    inline
+    void
+    StringOfChars<TCharType>::truncate(size_t length)
+    {
+        assert(length <= this->length());
+
+        if (length == this->length())
+            return;
+
+        // Копия начала строки: assign может освободить буфер, на который указывает getStr()
+        const std::vector<TCharType> prefix(getStr(), getStr() + length);
+        assign(prefix.data(), length);
+    }
+
     //------------------------------------------------------------------------//
     template<typename TCharType>
     StringOfCharsZeroEnd<TCharType>::StringOfCharsZeroEnd(const TCharType* zeroEndBuf)
@@ -148,7 +237,18 @@ namespace TrieStrings
     StringOfCharsZeroEnd<TCharType>&
     StringOfCharsZeroEnd<TCharType>::operator=(const StringOfChars<TCharType>& other)
     {
-        intAssign(other.getStr(), other.length());
+        if (this != &other)
+            intAssign(other.getStr(), other.length());
+
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType>
+    StringOfCharsZeroEnd<TCharType>&
+    StringOfCharsZeroEnd<TCharType>::operator=(const StringOfCharsZeroEnd<TCharType>& other)
+    {
+        return operator=(static_cast<const StringOfChars<TCharType>&>(other));
     }
 
     //------------------------------------------------------------------------//
@@ -174,6 +274,7 @@ namespace TrieStrings
     void
     StringOfCharsZeroEnd<TCharType>::reserve(size_t size)
     {
+        m_buf.reserve(size + 1);
     }
 
     //------------------------------------------------------------------------//
@@ -197,18 +298,43 @@ namespace TrieStrings
     void
     StringOfCharsZeroEnd<TCharType>::appendChar(TCharType newChar)
     {
-        m_buf.pop_back();
-        m_buf.push_back(newChar);
+        if (m_buf.empty())
+        {
+            m_buf.push_back(newChar);
+        }
+        else
+        {
+            // Символ записывается на место завершающего 0
+            m_buf.back() = newChar;
+        }
+
         m_buf.push_back(0);
     }
 
+    //------------------------------------------------------------------------//
+    template<typename TCharType>
+    inline
+    void
+    StringOfCharsZeroEnd<TCharType>::truncate(size_t length)
+    {
+        assert(length <= this->length());
+
+        if (!m_buf.empty())
+        {
+            m_buf.resize(length + 1);
+            m_buf.back() = 0;
+        }
+    }
+
     //------------------------------------------------------------------------//
     template<typename TCharType>
     inline
     const TCharType*
     StringOfCharsZeroEnd<TCharType>::getStr() const
     {
-        return m_buf.data();
+        static const TCharType emptyStr[1] = { 0 };
+
+        return m_buf.empty() ? emptyStr : m_buf.data();
     }
 
     //------------------------------------------------------------------------//
@@ -216,7 +342,7 @@ namespace TrieStrings
     bool
     StringOfCharsZeroEnd<TCharType>::empty() const
     {
-        //  0-      
+        // В 0-терминированной строке чимвол завершения строки есть всегда
         return m_buf.size() < 2;
     }
 
@@ -226,7 +352,7 @@ namespace TrieStrings
     size_t
     StringOfCharsZeroEnd<TCharType>::length() const
     {
-        return m_buf.size() - 1;
+        return m_buf.empty() ? 0 : m_buf.size() - 1;
     }
 
     //------------------------------------------------------------------------//
@@ -244,8 +370,13 @@ namespace TrieStrings
     StringOfCharsZeroEnd<TCharType>::intAssign(const TCharType* buf, size_t charsCount)
     {
         m_buf.clear();
-        m_buf.resize(charsCount + 1, 0);
-        memcpy(&m_buf[0], buf, sizeof(TCharType) * charsCount);
+
+        // Пустая строка не выделяет память (используется итераторами end())
+        if (charsCount)
+        {
+            m_buf.resize(charsCount + 1, 0);
+            memcpy(&m_buf[0], buf, sizeof(TCharType) * charsCount);
+        }
     }
 
     //------------------------------------------------------------------------//
@@ -284,11 +415,20 @@ namespace TrieStrings
     StringOfCharsFixedLen<TCharType>&
     StringOfCharsFixedLen<TCharType>::operator=(const StringOfChars<TCharType>& other)
     {
-        intAssign(other.getStr(), other.length());
+        if (this != &other)
+            intAssign(other.getStr(), other.length());
 
         return *this;
     }
 
+    //------------------------------------------------------------------------//
+    template<typename TCharType>
+    StringOfCharsFixedLen<TCharType>&
+    StringOfCharsFixedLen<TCharType>::operator=(const StringOfCharsFixedLen<TCharType>& other)
+    {
+        return operator=(static_cast<const StringOfChars<TCharType>&>(other));
+    }
+
     //------------------------------------------------------------------------//
     template<typename TCharType>
     StringOfCharsFixedLen<TCharType>&
@@ -337,6 +477,16 @@ namespace TrieStrings
         m_buf.push_back(newChar);
     }
 
+    //------------------------------------------------------------------------//
+    template<typename TCharType>
+    void
+    StringOfCharsFixedLen<TCharType>::truncate(size_t length)
+    {
+        assert(length <= m_buf.size());
+
+        m_buf.resize(length);
+    }
+
     //------------------------------------------------------------------------//
     template<typename TCharType>
     inline
@@ -379,7 +529,187 @@ namespace TrieStrings
     {
         m_buf.clear();
         m_buf.resize(charsCount);
-        memcpy(&m_buf[0], buf, sizeof(TCharType) * charsCount);
+
+        // Пустой ключ не копируется (buf может быть nullptr)
+        if (charsCount)
+            memcpy(m_buf.data(), buf, sizeof(TCharType) * charsCount);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    StringOfCharsInline<TCharType, InlineLength>::StringOfCharsInline() noexcept
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    StringOfCharsInline<TCharType, InlineLength>::StringOfCharsInline(const StringOfCharsInline& other)
+        : m_buf (other.m_buf)
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    StringOfCharsInline<TCharType, InlineLength>::StringOfCharsInline(StringOfCharsInline&& other) noexcept
+        : m_buf (std::move(other.m_buf))
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    StringOfCharsInline<TCharType, InlineLength>::~StringOfCharsInline()
+    {
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    StringOfCharsInline<TCharType, InlineLength>&
+    StringOfCharsInline<TCharType, InlineLength>::operator=(const StringOfChars<TCharType>& other)
+    {
+        if (this != &other)
+            intAssign(other.getStr(), other.length());
+
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    StringOfCharsInline<TCharType, InlineLength>&
+    StringOfCharsInline<TCharType, InlineLength>::operator=(const StringOfCharsInline& other)
+    {
+        m_buf = other.m_buf;
+
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    StringOfCharsInline<TCharType, InlineLength>&
+    StringOfCharsInline<TCharType, InlineLength>::operator=(StringOfCharsInline&& other) noexcept
+    {
+        m_buf = std::move(other.m_buf);
+
+        return *this;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    void
+    StringOfCharsInline<TCharType, InlineLength>::clear()
+    {
+        m_buf.clear();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    void
+    StringOfCharsInline<TCharType, InlineLength>::reserve(size_t size)
+    {
+        m_buf.reserve(size + 1);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    void
+    StringOfCharsInline<TCharType, InlineLength>::assign(const TCharType* zeroEndBuf)
+    {
+        intAssign(zeroEndBuf, zeroEndBuf ? GetStrLen(zeroEndBuf) : 0);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    void
+    StringOfCharsInline<TCharType, InlineLength>::assign(const TCharType* buf, size_t length)
+    {
+        intAssign(buf, length);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    inline
+    void
+    StringOfCharsInline<TCharType, InlineLength>::appendChar(TCharType newChar)
+    {
+        if (m_buf.empty())
+        {
+            m_buf.push_back(newChar);
+        }
+        else
+        {
+            // Символ записывается на место завершающего 0
+            m_buf.back() = newChar;
+        }
+
+        m_buf.push_back(0);
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    inline
+    void
+    StringOfCharsInline<TCharType, InlineLength>::truncate(size_t length)
+    {
+        assert(length <= this->length());
+
+        if (!m_buf.empty())
+        {
+            m_buf.resize(length + 1);
+            m_buf.back() = 0;
+        }
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    inline
+    const TCharType*
+    StringOfCharsInline<TCharType, InlineLength>::getStr() const
+    {
+        static const TCharType emptyStr[1] = { 0 };
+
+        return m_buf.empty() ? emptyStr : m_buf.data();
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    bool
+    StringOfCharsInline<TCharType, InlineLength>::empty() const
+    {
+        return m_buf.size() < 2;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    inline
+    size_t
+    StringOfCharsInline<TCharType, InlineLength>::length() const
+    {
+        return m_buf.empty() ? 0 : m_buf.size() - 1;
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    inline
+    TCharType
+    StringOfCharsInline<TCharType, InlineLength>::at(size_t index) const
+    {
+        assert(index < length());
+
+        return m_buf[index];
+    }
+
+    //------------------------------------------------------------------------//
+    template<typename TCharType, size_t InlineLength>
+    void
+    StringOfCharsInline<TCharType, InlineLength>::intAssign(const TCharType* buf, size_t charsCount)
+    {
+        m_buf.clear();
+
+        if (charsCount)
+        {
+            m_buf.resize(charsCount + 1);
+            memcpy(m_buf.data(), buf, sizeof(TCharType) * charsCount);
+            m_buf.back() = 0;
+        }
     }
 
     //------------------------------------------------------------------------//